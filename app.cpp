@@ -45,12 +45,31 @@
 
 #include "config.h"
 #include "app.h"
+#include "bench.h"
+#include "perf_mon.h"
+#include "serial_cmd.h"
+#include "xrun_mon.h"
+#include "quality_gov.h"
+#include "voice_alloc.h"
+#include "dual_render.h"
+#include "midi_queue.h"
+#include "midi_sched.h"
+#include "preset_cache.h"
+#include "stream_voice.h"
+#include "load_job.h"
+#include "load_step.h"
+#include "hot_swap.h"
+#include "smpl_arena.h"
 
 
 #include <Arduino.h>
 #include <Wire.h>
 #include <SPI.h>
 
+#ifdef ESP32
+#include <esp_heap_caps.h>
+#endif
+
 
 /*
  * Library can be found on https://github.com/marcel-licence/ML_SynthTools
@@ -91,20 +110,58 @@
 #undef ML_SYNTH_INLINE_DECLARATION
 
 
+/* App_Loop1 will be called from the second core */
+#if ((defined ESP32) && (SOC_CPU_CORES_NUM > 1)) || (defined ARDUINO_ARCH_RP2040)
+#define APP_LOOP1_ENABLED
+#endif
+
+
 #define SERIAL_WAIT_READY   3000 /*!< wait for usb console to be attached */
 #define SERIAL_WAIT_EXT     5000 /*!< wait additional time after Serial is ready */
 
+#ifdef ESP32
+#define APP_SAMPLE_MEM_CAPS     (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#define APP_SAMPLE_MEM_STEP     4096 /*!< the allocation will be retried with a smaller size in these steps */
+#define APP_SAMPLE_MEM_CLEAR    4096 /*!< bytes of the sample memory cleared per block */
+
+#define APP_CLEAR_STOPPED       0
+#define APP_CLEAR_RUNNING       1
+#define APP_CLEAR_BUSY          2 /*!< a block is being cleared */
+#endif
+
 #if (defined ARDUINO_GENERIC_F407VGTX) || (defined ARDUINO_DISCO_F407VG)
 #include <Wire.h> /* todo remove, just for scanning */
 #endif
 
 
-float lfo1_buffer[SAMPLE_BUFFER_SIZE];
-ML_LFO lfo1(SAMPLE_RATE, lfo1_buffer, SAMPLE_BUFFER_SIZE);
+#if BLOCK_SIZE_MAX < SAMPLE_BUFFER_SIZE
+#error BLOCK_SIZE_MAX must not be lower than SAMPLE_BUFFER_SIZE
+#endif
+
+
+float lfo1_buffer[BLOCK_SIZE_MAX];
+ML_LFO lfo1(SAMPLE_RATE, lfo1_buffer, BLOCK_SIZE_MAX);
 
-float lfo2_buffer[SAMPLE_BUFFER_SIZE];
-float lfo2_buffer_scale[SAMPLE_BUFFER_SIZE];
-ML_LFO lfo2(SAMPLE_RATE, lfo2_buffer, SAMPLE_BUFFER_SIZE);
+float lfo2_buffer[BLOCK_SIZE_MAX];
+float lfo2_buffer_scale[BLOCK_SIZE_MAX];
+ML_LFO lfo2(SAMPLE_RATE, lfo2_buffer, BLOCK_SIZE_MAX);
+
+/* block sizes selectable at runtime, lower values reduce the latency, higher values the overhead per block */
+static const uint32_t appBlockSizes[] = {16, 32, 48, 128};
+
+static uint32_t blockSize = SAMPLE_BUFFER_SIZE; /*!< samples processed per App_Loop call */
+static volatile uint32_t blockSizeRequest = SAMPLE_BUFFER_SIZE;
+
+/* the audio driver always takes SAMPLE_BUFFER_SIZE samples, remaining samples of a block are kept here */
+static Q1_14 outLeft[SAMPLE_BUFFER_SIZE], outRight[SAMPLE_BUFFER_SIZE];
+static uint32_t outFill = 0;
+
+static uint8_t *sampleMem = NULL; /*!< sample memory in RAM */
+static uint32_t sampleMemSize = 0; /*!< bytes of the sampler memory */
+#ifdef ESP32
+static uint32_t sampleMemCleared = 0; /*!< bytes cleared from the start of the sample memory */
+static uint32_t sampleMemClearState = APP_CLEAR_RUNNING;
+#endif
 
 #ifdef REVERB_ENABLED
 ML_Tremolo tremolo(SAMPLE_RATE);
@@ -122,6 +179,58 @@ int16_t *sample_buffer;
 #endif
 
 
+#ifdef ESP32
+/*
+ * allocates the largest free block of the PSRAM as sample memory, returns NULL if no PSRAM is available
+ * the memory is not cleared here, see app_ClearSampleMem
+ */
+static uint8_t *app_AllocSampleMem(uint32_t *size)
+{
+    uint32_t bytes = heap_caps_get_largest_free_block(APP_SAMPLE_MEM_CAPS) & ~3;
+    uint8_t *mem = NULL;
+
+    Serial.printf("PSRAM: %" PRIu32 " bytes free, largest block %" PRIu32 " bytes\n",
+                  (uint32_t)heap_caps_get_free_size(APP_SAMPLE_MEM_CAPS), bytes);
+
+    while ((bytes > 0) && ((mem = (uint8_t *)heap_caps_malloc(bytes, APP_SAMPLE_MEM_CAPS)) == NULL))
+    {
+        /* should not happen, the block can be used completely */
+        bytes = (bytes > APP_SAMPLE_MEM_STEP) ? (bytes - APP_SAMPLE_MEM_STEP) : 0;
+    }
+
+    if (mem != NULL)
+    {
+        Serial.printf("alloced %" PRIu32 " bytes\n", bytes);
+    }
+    *size = bytes;
+    return mem;
+}
+
+/*
+ * clears the next block of the sample memory until the first sample data is transferred
+ * the sampler reads only transferred data, clearing the whole memory would just delay the startup
+ */
+static void app_ClearSampleMem(void)
+{
+    uint32_t expected = APP_CLEAR_RUNNING;
+    if (!__atomic_compare_exchange_n(&sampleMemClearState, &expected, APP_CLEAR_BUSY, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    uint32_t cnt = sampleMemSize - sampleMemCleared;
+    if (cnt > APP_SAMPLE_MEM_CLEAR)
+    {
+        cnt = APP_SAMPLE_MEM_CLEAR;
+    }
+    memset(&sampleMem[sampleMemCleared], 0, cnt);
+    sampleMemCleared += cnt;
+
+    __atomic_store_n(&sampleMemClearState, (sampleMemCleared < sampleMemSize) ? APP_CLEAR_RUNNING : APP_CLEAR_STOPPED, __ATOMIC_RELEASE);
+}
+#endif
+
+
 void Serial_Setup(void)
 {
     Serial.begin(SERIAL_BAUDRATE);
@@ -211,6 +320,8 @@ void App_Setup(void)
 #ifdef SAMPLER_STATIC_BUFFER_SAMPLE_CNT
     static Q1_14 buffer[SAMPLER_STATIC_BUFFER_SAMPLE_CNT];
     Sampler_UseStaticBuffer(buffer, SAMPLER_STATIC_BUFFER_SAMPLE_CNT);
+    sampleMem = (uint8_t *)buffer;
+    sampleMemSize = sizeof(buffer);
 #endif
 
 
@@ -218,7 +329,9 @@ void App_Setup(void)
 #ifndef BOARD_HAS_PSRAM
 #warning PSRAM required for this project to work
 #endif
-    if (ESP.getFreePsram() == 0)
+    uint32_t storageBytes = 0;
+    uint8_t *storage = app_AllocSampleMem(&storageBytes);
+    if (storage == NULL)
     {
         Serial.printf("PSRAM has no free Memory! Please ensure PSRAM is enabled and also available on your ESP32");
         while (true)
@@ -227,28 +340,9 @@ void App_Setup(void)
         }
     }
 
-    uint32_t storageBytes = ESP.getFreePsram() ;
-
-    Serial.printf("Try to allocate %d bytes\n", storageBytes);
-
-    static uint8_t *storage = (uint8_t *)ps_calloc(storageBytes, 1);
-    if (storage == NULL)
-    {
-        Serial.printf("Not able to allocate the complete PSRAM buffer!\nNow trying to reduce the allocation buffer size...\n");
-
-        /*
-         * for some reason using a newer ESP32 board library you cannot allocate the complete PSRAM memory
-         * this loop will decrease the buffer size and repeat the allocation step again until it is successful
-         */
-        while ((storage == NULL))
-        {
-            storageBytes -= 1;
-            storage = (uint8_t *)ps_calloc(storageBytes, 1);
-        }
-        Serial.printf("alloced %" PRIu32 " bytes\n", storageBytes);
-    }
-
     Sampler_SetSampleBuffer(storage, storageBytes);
+    sampleMem = storage;
+    sampleMemSize = storageBytes;
 #endif
 
     /*
@@ -309,8 +403,14 @@ void App_Setup(void)
 
     Sampler_AllNotesOff();
 
+    PerfMon_Setup();
+
     Serial.printf("setup done!\n");
 
+#ifdef BENCHMARK_ENABLED
+    Bench_Run();
+#endif
+
     //Sampler_NoteOn(0, 69, 127);
 
 #ifdef MIDI_STREAM_PLAYER_ENABLED
@@ -322,11 +422,15 @@ void App_Setup(void)
 }
 
 
-#ifdef ESP32
+#if (defined ESP32) || (defined ARDUINO_ARCH_RP2040)
 
 
 void App_Setup1(void)
 {
+#ifdef DUAL_RENDER_ACTIVE
+    DualRender_Setup1();
+#endif
+
 #ifdef STRIP_ENABLED
     // StripSetup();
 #endif
@@ -351,6 +455,28 @@ void App_Setup1(void)
 
 void App_Loop1(void)
 {
+#ifdef DUAL_RENDER_ACTIVE
+    DualRender_Loop1();
+#endif
+
+    SerialCmd_Loop();
+
+    /* a requested load will be executed here, the other tasks are called from the job */
+    LoadJob_Loop1();
+
+    App_Loop1Yield();
+}
+
+/*
+ * the tasks of App_Loop1 which keep running while a load job waits (see LoadJob_Yield)
+ * the serial commands are not executed here, they could access the file of the job
+ */
+void App_Loop1Yield(void)
+{
+#ifdef STREAM_VOICE_ACTIVE
+    StreamVoice_Refill();
+#endif
+
 #ifdef MIDI_VIA_USB_ENABLED
     UsbMidi_Loop();
 #endif
@@ -375,7 +501,7 @@ void App_Loop1(void)
     /* tft code could be here */
 #endif
 }
-#endif /* ESP32 */
+#endif /* (defined ESP32) || (defined ARDUINO_ARCH_RP2040) */
 
 
 /**
@@ -387,15 +513,89 @@ void loop_1Hz(void)
 #ifdef BLINK_LED_PIN
     Blink_Process();
 #endif
+
+#ifndef APP_LOOP1_ENABLED
+    SerialCmd_Loop();
+#endif
 }
 
 float preAmp = 0.125f;
 float postAmp = 1.0f;
 float bypassAmp = 1.0f;
 float rotLevel = 1.0f;
-bool hq_enabled = true;
 float inputGain = 1.0f;
 
+/*
+ * passes one chunk of SAMPLE_BUFFER_SIZE samples to the audio driver
+ */
+static void app_OutputChunk(Q1_14 *left, Q1_14 *right)
+{
+    Audio_Output(left, right);
+
+#ifdef OLED_OSC_DISP_ENABLED
+    {
+        float fl_sample[SAMPLE_BUFFER_SIZE];
+        float fr_sample[SAMPLE_BUFFER_SIZE];
+        const float convf = 1.0f / 16384.0f;
+        for (uint32_t n = 0; n < SAMPLE_BUFFER_SIZE; n++)
+        {
+            fl_sample[n] = ((float)left[n].s16) * convf;
+            fr_sample[n] = ((float)right[n].s16) * convf;
+        }
+        ScopeOled_AddSamples(fl_sample, fr_sample, SAMPLE_BUFFER_SIZE);
+    }
+#endif
+
+#ifdef ESP8266
+    static int32_t xxr = 0;
+    int32_t mono_i32[SAMPLE_BUFFER_SIZE];
+    for (int n = 0; n < SAMPLE_BUFFER_SIZE; n++)
+    {
+        xxr += 0x4;
+        int32_t s = left[n].s16;
+        s << 16UL;
+        s += right[n].s16;
+        mono_i32[n] = s;
+    }
+    Audio_OutputMono(mono_i32);
+#endif
+}
+
+/*
+ * passes the block to the audio driver in chunks of SAMPLE_BUFFER_SIZE, the remaining samples are kept for the next call
+ */
+static void app_Output(Q1_14 *left, Q1_14 *right, uint32_t len)
+{
+    uint32_t pos = 0;
+
+    while (pos < len)
+    {
+        if ((outFill == 0) && (len - pos >= SAMPLE_BUFFER_SIZE))
+        {
+            app_OutputChunk(&left[pos], &right[pos]);
+            pos += SAMPLE_BUFFER_SIZE;
+        }
+        else
+        {
+            uint32_t cnt = SAMPLE_BUFFER_SIZE - outFill;
+            if (cnt > len - pos)
+            {
+                cnt = len - pos;
+            }
+            memcpy(&outLeft[outFill], &left[pos], cnt * sizeof(Q1_14));
+            memcpy(&outRight[outFill], &right[pos], cnt * sizeof(Q1_14));
+            outFill += cnt;
+            pos += cnt;
+
+            if (outFill == SAMPLE_BUFFER_SIZE)
+            {
+                app_OutputChunk(outLeft, outRight);
+                outFill = 0;
+            }
+        }
+    }
+}
+
 /**
     @brief This function contains the mainloop
  */
@@ -403,7 +603,29 @@ void App_Loop(void)
 {
     static int loop_cnt_1hz = 0; /*!< counter to allow 1Hz loop cycle */
 
-    loop_cnt_1hz += SAMPLE_BUFFER_SIZE;
+    if (blockSizeRequest != blockSize)
+    {
+        blockSize = blockSizeRequest;
+        PerfMon_SetBlockSize(blockSize);
+    }
+
+    PerfMon_BlockStart();
+    MidiSched_BlockStart(blockSize);
+
+#ifdef DUAL_RENDER_ACTIVE
+    /* the sampler must not be accessed before the render core has finished the block */
+    DualRender_Sync();
+#endif
+
+    /* samples loaded by the load job will be added here */
+    LoadJob_Process();
+    HotSwap_Process();
+    SmplArena_Process();
+    PresetCache_Process();
+    /* without a load job the requested loads are executed in steps, one per block */
+    LoadStep_Process();
+
+    loop_cnt_1hz += blockSize;
 
     if (loop_cnt_1hz >= SAMPLE_RATE)
     {
@@ -418,10 +640,27 @@ void App_Loop(void)
 
 #ifdef MIDI_VIA_USB_ENABLED
     UsbMidi_ProcessSync();
+
+    /* events received by the second core, limited to keep the block in time */
+    {
+        struct midi_queue_evt_s evt;
+        for (int i = 0; (i < MIDI_QUEUE_MAX_PER_BLOCK) && MidiQueue_Pop(&evt); i++)
+        {
+            MidiSched_SetOffsetUs(evt.timestamp);
+            Midi_HandleShortMsg(evt.msg, 8);
+        }
+        MidiSched_SetOffset(0);
+    }
 #endif
 
 #ifdef MIDI_STREAM_PLAYER_ENABLED
-    MidiStreamPlayer_Tick(SAMPLE_BUFFER_SIZE);
+    /* the player is ticked in steps to schedule its events at their position within the block */
+    for (uint32_t offset = 0; offset < blockSize; offset += MIDI_SCHED_PLAYER_STEP)
+    {
+        MidiSched_SetOffset(offset);
+        MidiStreamPlayer_Tick(MIDI_SCHED_PLAYER_STEP);
+    }
+    MidiSched_SetOffset(0);
 #endif
 
 #ifdef MIDI_BLE_ENABLED
@@ -439,10 +678,14 @@ void App_Loop(void)
     Status_Loop(240000);
     Status_LoopMain();
 
+    PerfMon_Mark(PERF_STAGE_CONTROL);
+
     /*
      * And finally the audio stuff
      */
-    Q1_14 left[SAMPLE_BUFFER_SIZE], right[SAMPLE_BUFFER_SIZE];
+    uint32_t hqMask = QualityGov_GetHqMask();
+
+    Q1_14 left[BLOCK_SIZE_MAX], right[BLOCK_SIZE_MAX];
 
     memset(left, 0, sizeof(left));
     memset(right, 0, sizeof(right));
@@ -451,109 +694,289 @@ void App_Loop(void)
 #ifdef AUDIO_PASS_THROUGH
     Audio_Input(left, right);
 
-    mul(left, inputGain, left, SAMPLE_BUFFER_SIZE);
-    mul(right, inputGain, right, SAMPLE_BUFFER_SIZE);
+    mul(left, inputGain, left, blockSize);
+    mul(right, inputGain, right, blockSize);
 #endif
 
-    Sampler_Process(left, right, SAMPLE_BUFFER_SIZE);
+#ifdef DUAL_RENDER_ACTIVE
+    /* the sampler output of the previous block will be added, the next block will be rendered on the second core */
+    DualRender_Process(left, right, blockSize);
+#else
+    MidiSched_Render(left, right, blockSize);
+#endif
+
+    PerfMon_Mark(PERF_STAGE_SAMPLER);
 
 #ifdef REVERB_ENABLED
-    float mono[SAMPLE_BUFFER_SIZE];
+    float mono[BLOCK_SIZE_MAX];
 
-    mixStereoToMono(left, right, mono, SAMPLE_BUFFER_SIZE);
+    mixStereoToMono(left, right, mono, blockSize);
 
-    Reverb_Process(mono, SAMPLE_BUFFER_SIZE);
+    Reverb_Process(mono, blockSize);
 
-    lfo2.Process(SAMPLE_BUFFER_SIZE);
+    PerfMon_Mark(PERF_STAGE_REVERB);
+
+    lfo2.Process(blockSize);
 
 #ifdef LFO1_MODULATED_BY_LFO1
-    ScaleLfo(lfo2_buffer, lfo2_buffer_scale, SAMPLE_BUFFER_SIZE, 0.1, 10);
-    lfo1.Process(lfo2_buffer_scale, SAMPLE_BUFFER_SIZE);
+    ScaleLfo(lfo2_buffer, lfo2_buffer_scale, blockSize, 0.1, 10);
+    lfo1.Process(lfo2_buffer_scale, blockSize);
 #else
-    lfo1.Process(SAMPLE_BUFFER_SIZE);
+    lfo1.Process(blockSize);
 #endif
 
-    if (hq_enabled)
+    PerfMon_Mark(PERF_STAGE_LFO);
+
+    if (hqMask & APP_CHAIN_PHASER_HQ)
     {
-        Phaser_ProcessHQ(mono, lfo1_buffer, mono, SAMPLE_BUFFER_SIZE);
+        Phaser_ProcessHQ(mono, lfo1_buffer, mono, blockSize);
     }
     else
     {
-        Phaser_Process(mono, lfo1_buffer, mono, SAMPLE_BUFFER_SIZE);
+        Phaser_Process(mono, lfo1_buffer, mono, blockSize);
     }
 
-    if (hq_enabled)
+    PerfMon_Mark(PERF_STAGE_PHASER);
+
+    if (hqMask & APP_CHAIN_VIBRATO_HQ)
     {
-        vibrato.ProcessHQ(mono, lfo1_buffer, mono, SAMPLE_BUFFER_SIZE);
+        vibrato.ProcessHQ(mono, lfo1_buffer, mono, blockSize);
     }
     else
     {
-        vibrato.Process(mono, lfo1_buffer, mono, SAMPLE_BUFFER_SIZE);
+        vibrato.Process(mono, lfo1_buffer, mono, blockSize);
     }
 
-    if (hq_enabled)
+    PerfMon_Mark(PERF_STAGE_VIBRATO);
+
+    if (hqMask & APP_CHAIN_PITCH_SHIFTER_HQ)
     {
-        pitchShifter.ProcessHQ(mono, mono, SAMPLE_BUFFER_SIZE);
+        pitchShifter.ProcessHQ(mono, mono, blockSize);
     }
     else
     {
-        pitchShifter.Process(mono, mono, SAMPLE_BUFFER_SIZE);
+        pitchShifter.Process(mono, mono, blockSize);
     }
 
-    float f_l[SAMPLE_BUFFER_SIZE], f_r[SAMPLE_BUFFER_SIZE];
-    tremolo.Process(mono, mono, lfo1_buffer, f_l, f_r, SAMPLE_BUFFER_SIZE);
+    PerfMon_Mark(PERF_STAGE_PITCH_SHIFTER);
 
-    for (int n = 0; n < SAMPLE_BUFFER_SIZE; n++)
+    float f_l[BLOCK_SIZE_MAX], f_r[BLOCK_SIZE_MAX];
+    tremolo.Process(mono, mono, lfo1_buffer, f_l, f_r, blockSize);
+
+    for (uint32_t n = 0; n < blockSize; n++)
     {
         left[n].s16 = f_l[n] * 16384;
         right[n].s16 = f_r[n] * 16384;
     }
+
+    PerfMon_Mark(PERF_STAGE_TREMOLO);
 #endif
 
 #ifdef MAX_DELAY_Q
     /*
      * post process delay
      */
-    DelayQ_Process_Buff(&left[0].s16, &right[0].s16, &left[0].s16, &right[0].s16, SAMPLE_BUFFER_SIZE);
+    DelayQ_Process_Buff(&left[0].s16, &right[0].s16, &left[0].s16, &right[0].s16, blockSize);
+
+    PerfMon_Mark(PERF_STAGE_DELAY);
 #endif
 
+    PerfMon_RenderDone();
+
+    QualityGov_Process(PerfMon_GetLastRender(), PerfMon_GetBudget(), blockSize);
+
     /*
      * Output the audio
      */
-    Audio_Output(left, right);
+    app_Output(left, right, blockSize);
 
-#ifdef OLED_OSC_DISP_ENABLED
+    PerfMon_Mark(PERF_STAGE_OUTPUT);
+
+#if (defined STREAM_VOICE_ACTIVE) && !(defined APP_LOOP1_ENABLED)
+    /* without a second core the stream voices are refilled after the block has been sent */
+    StreamVoice_Refill();
+#endif
+
+#ifdef ESP32
+    app_ClearSampleMem();
+#endif
+
+#ifndef DUAL_RENDER_ACTIVE
+    /* the render core updates the voice allocation itself */
+    VoiceAlloc_Process(PerfMon_GetLastStage(PERF_STAGE_SAMPLER), PerfMon_GetLastRender(), PerfMon_GetBudget(), blockSize);
+#endif
+
+    XrunMon_Process(VoiceAlloc_GetActiveCnt(), App_GetChainConfig());
+}
+
+/*
+ * MIDI callbacks
+ */
+#ifdef MIDI_VIA_USB_ENABLED
+/*
+ * called from the USB MIDI module on the second core, the event will be handled by App_Loop
+ */
+void App_UsbMidiShortMsgReceived(uint8_t *msg)
+{
+    MidiQueue_Push(msg);
+}
+#endif
+
+void App_NoteOn(uint8_t ch, uint8_t note, uint8_t vel)
+{
+    if (vel == 0)
     {
-        float fl_sample[SAMPLE_BUFFER_SIZE];
-        float fr_sample[SAMPLE_BUFFER_SIZE];
-        const float convf = 1.0f / 16384.0f;
-        for (uint32_t n = 0; n < SAMPLE_BUFFER_SIZE; n++)
+        App_NoteOff(ch, note);
+        return;
+    }
+
+    MidiSched_NoteOn(ch, note, vel);
+}
+
+void App_NoteOff(uint8_t ch, uint8_t note)
+{
+    MidiSched_NoteOff(ch, note);
+}
+
+void App_PitchBend(uint8_t ch, uint16_t bend)
+{
+    MidiSched_PitchBend(ch, bend);
+}
+
+void App_ProgramChange(uint8_t ch, uint8_t program)
+{
+    if (PresetCache_IsActive())
+    {
+        /* a preset not in memory will be selected when loaded */
+        PresetCache_ProgramChange(ch, program);
+    }
+    else if (!HotSwap_ProgramChange(ch, program) && !SmplArena_ProgramChange(ch, program))
+    {
+        Sampler_ProgramChange(ch, program);
+    }
+}
+
+uint32_t App_GetSampleMemSize(void)
+{
+    return sampleMemSize;
+}
+
+uint8_t *App_GetSampleMem(void)
+{
+    return sampleMem;
+}
+
+/*
+ * to be called before sample data is written into the sample memory
+ * stops clearing the memory, waits if a block is being cleared by the other core
+ */
+void App_StopSampleMemClear(void)
+{
+#ifdef ESP32
+    uint32_t expected = APP_CLEAR_RUNNING;
+    while (!__atomic_compare_exchange_n(&sampleMemClearState, &expected, APP_CLEAR_STOPPED, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        if (expected == APP_CLEAR_STOPPED)
         {
-            fl_sample[n] = ((float)left[n].s16) * convf;
-            fr_sample[n] = ((float)right[n].s16) * convf;
+            break;
         }
-        ScopeOled_AddSamples(fl_sample, fr_sample, SAMPLE_BUFFER_SIZE);
+        expected = APP_CLEAR_RUNNING;
     }
 #endif
+}
 
-#ifdef ESP8266
-    static int32_t xxr = 0;
-    int32_t mono_i32[SAMPLE_BUFFER_SIZE];
-    for (int n = 0; n < SAMPLE_BUFFER_SIZE; n++)
+/*
+ * selects the sample memory in RAM again after a bank in flash has been used (see SmplBank_Map)
+ */
+void App_RestoreSampleMem(void)
+{
+#ifdef ESP32
+    Sampler_SetSampleBuffer(sampleMem, sampleMemSize);
+#elif defined SAMPLER_STATIC_BUFFER_SAMPLE_CNT
+    Sampler_UseStaticBuffer((Q1_14 *)sampleMem, sampleMemSize / sizeof(Q1_14));
+#endif
+}
+
+uint32_t App_GetChainConfig(void)
+{
+    uint32_t chainConfig = QualityGov_GetHqMask();
+
+#ifdef REVERB_ENABLED
+    chainConfig |= APP_CHAIN_REVERB;
+#endif
+#ifdef MAX_DELAY_Q
+    chainConfig |= APP_CHAIN_DELAY;
+#endif
+#ifdef AUDIO_PASS_THROUGH
+    chainConfig |= APP_CHAIN_PASS_THROUGH;
+#endif
+
+    return chainConfig;
+}
+
+void App_ChainConfigToStr(uint32_t chainConfig, char *str, uint32_t len)
+{
+    snprintf(str, len, "%s%s%s%s%s%s",
+             (chainConfig & APP_CHAIN_PHASER_HQ) ? "phHQ " : "",
+             (chainConfig & APP_CHAIN_VIBRATO_HQ) ? "viHQ " : "",
+             (chainConfig & APP_CHAIN_PITCH_SHIFTER_HQ) ? "psHQ " : "",
+             (chainConfig & APP_CHAIN_REVERB) ? "rev " : "",
+             (chainConfig & APP_CHAIN_DELAY) ? "del " : "",
+             (chainConfig & APP_CHAIN_PASS_THROUGH) ? "in " : "");
+}
+
+/*
+ * selects the block size, it will be applied at the start of the next block
+ */
+bool App_SetBlockSize(uint32_t len)
+{
+#ifdef AUDIO_PASS_THROUGH
+    /* the input is read in chunks of SAMPLE_BUFFER_SIZE */
+    if (len != SAMPLE_BUFFER_SIZE)
     {
-        xxr += 0x4;
-        int32_t s = left[n].s16;
-        s << 16UL;
-        s += right[n].s16;
-        mono_i32[n] = s;
+        return false;
     }
-    Audio_OutputMono(mono_i32);
 #endif
+
+    for (uint32_t i = 0; i < sizeof(appBlockSizes) / sizeof(appBlockSizes[0]); i++)
+    {
+        if ((appBlockSizes[i] == len) && (len <= BLOCK_SIZE_MAX))
+        {
+            blockSizeRequest = len;
+            Status_ValueChangedInt("Audio", "Block size", len);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t App_GetBlockSize(void)
+{
+    return blockSize;
 }
 
 /*
- * MIDI callbacks
+ * serial command: "block" prints the block size, "block <n>" selects it
  */
+void App_BlockCmd(const char *args)
+{
+    if ((args[0] != 0) && !App_SetBlockSize(atoi(args)))
+    {
+        Serial.printf("block size %s not supported\n", args);
+    }
+
+    Serial.printf("block size: %" PRIu32 " samples (%" PRIu32 " us), output chunk: %d samples, available:",
+                  blockSizeRequest, (uint32_t)((blockSizeRequest * 1000000ULL) / SAMPLE_RATE), SAMPLE_BUFFER_SIZE);
+    for (uint32_t i = 0; i < sizeof(appBlockSizes) / sizeof(appBlockSizes[0]); i++)
+    {
+        if (appBlockSizes[i] <= BLOCK_SIZE_MAX)
+        {
+            Serial.printf(" %" PRIu32, appBlockSizes[i]);
+        }
+    }
+    Serial.printf("\n");
+}
+
 void AppBtn(uint8_t param, uint8_t value)
 {
     if (value > 0)
@@ -571,10 +994,10 @@ void AppBtn(uint8_t param, uint8_t value)
 #endif
 #if 0
         case 2:
-            hq_enabled = true;
+            QualityGov_SetMode(QGOV_MODE_HQ);
             break;
         case 3:
-            hq_enabled = false;
+            QualityGov_SetMode(QGOV_MODE_AUTO);
             break;
 #endif
         case 7:
@@ -585,7 +1008,7 @@ void AppBtn(uint8_t param, uint8_t value)
             break;
 
         default:
-            SoundFontSamplerCtrl(param + 9);
+            LoadJob_Request(param + 9);
         }
     }
 }
@@ -594,7 +1017,7 @@ void AppBtnB(uint8_t param, uint8_t value)
 {
     if (value > 0)
     {
-        SoundFontSamplerCtrl(param);
+        LoadJob_Request(param);
     }
 }
 
@@ -44,12 +44,41 @@
 #include "config.h"
 #include <stdint.h>
 
+/*
+ * configuration of the effect chain, used for reporting
+ */
+#define APP_CHAIN_PHASER_HQ         (1 << 0)
+#define APP_CHAIN_VIBRATO_HQ        (1 << 1)
+#define APP_CHAIN_PITCH_SHIFTER_HQ  (1 << 2)
+#define APP_CHAIN_REVERB            (1 << 3)
+#define APP_CHAIN_DELAY             (1 << 4)
+#define APP_CHAIN_PASS_THROUGH      (1 << 5)
+
+
 void App_Setup(void);
 void App_Loop(void);
 
 void App_Setup1(void);
 void App_Loop1(void);
+void App_Loop1Yield(void);
+
 
+void App_NoteOn(uint8_t ch, uint8_t note, uint8_t vel);
+void App_NoteOff(uint8_t ch, uint8_t note);
+void App_PitchBend(uint8_t ch, uint16_t bend);
+void App_ProgramChange(uint8_t ch, uint8_t program);
+uint32_t App_GetSampleMemSize(void);
+uint8_t *App_GetSampleMem(void);
+void App_StopSampleMemClear(void);
+void App_RestoreSampleMem(void);
+uint32_t App_GetChainConfig(void);
+bool App_SetBlockSize(uint32_t len);
+uint32_t App_GetBlockSize(void);
+void App_BlockCmd(const char *args);
+#ifdef MIDI_VIA_USB_ENABLED
+void App_UsbMidiShortMsgReceived(uint8_t *msg);
+#endif
+void App_ChainConfigToStr(uint32_t chainConfig, char *str, uint32_t len);
 
 #ifdef REVERB_ENABLED
 void AppReverb_SetLevel(uint8_t param __attribute__((unused)), uint8_t value);
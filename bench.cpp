@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file bench.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Micro benchmark of all stages used by App_Loop
+ * @n       Every stage is measured for different block sizes, the sampler also for different voice counts
+ * @n       The results are printed in ns/sample and as part of the real time budget at 48 kHz
+ * @n       It can be run on the board (BENCHMARK_ENABLED) or on the host (host/Makefile, target bench)
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "bench.h"
+#include "app.h"
+#include "sample_transfer.h"
+#include "smpl_codec.h"
+
+#include <ml_types.h>
+#include <ml_sampler.h>
+#include <ml_utils.h>
+#ifdef REVERB_ENABLED
+#include <ml_reverb.h>
+#include <ml_tremolo.h>
+#endif
+#ifdef MAX_DELAY_Q
+#include <ml_delay_q.h>
+#endif
+#include <ml_phaser.h>
+#include <ml_lfo.h>
+#include <ml_vibrato.h>
+#include <ml_pitch_shifter.h>
+
+
+/*
+ * defines
+ */
+#define BENCH_BLOCK_SIZE_MAX    128
+#define BENCH_MIN_TIME_US       20000 /*!< minimum measurement time of a single stage */
+#define BENCH_BUDGET_RATE       48000 /*!< the budget is calculated for this sample rate */
+#define BENCH_TEST_NOTE         36
+#define BENCH_TEST_SAMPLE_CNT   4800
+
+
+/*
+ * data types
+ */
+struct bench_stage_s
+{
+    const char *name;
+    void (*process)(uint32_t n);
+    bool hqChain; /*!< stage is part of App_Loop when all effects use the HQ variant */
+};
+
+
+/*
+ * static function declarations
+ */
+static void bench_Q14ToFloat(uint32_t n);
+static void bench_FloatToQ14(uint32_t n);
+static void bench_MixStereoToMono(uint32_t n);
+#ifdef REVERB_ENABLED
+static void bench_Reverb(uint32_t n);
+static void bench_Tremolo(uint32_t n);
+#endif
+static void bench_Lfo(uint32_t n);
+static void bench_PhaserHQ(uint32_t n);
+static void bench_Phaser(uint32_t n);
+static void bench_VibratoHQ(uint32_t n);
+static void bench_Vibrato(uint32_t n);
+static void bench_PitchShifterHQ(uint32_t n);
+static void bench_PitchShifter(uint32_t n);
+#ifdef MAX_DELAY_Q
+static void bench_DelayQ(uint32_t n);
+#endif
+static void bench_DecodeULaw(uint32_t n);
+static void bench_DecodeAdpcm(uint32_t n);
+static void bench_EncodeTestData(void);
+static void bench_Sampler(uint32_t n);
+static float bench_Measure(void (*process)(uint32_t n), uint32_t n);
+static bool bench_LoadTestSample(void);
+static void bench_PrintResult(const char *name, float ns);
+
+
+/*
+ * static variables
+ */
+static Q1_14 benchLeft[BENCH_BLOCK_SIZE_MAX];
+static Q1_14 benchRight[BENCH_BLOCK_SIZE_MAX];
+static float benchMono[BENCH_BLOCK_SIZE_MAX];
+static float benchLeftF[BENCH_BLOCK_SIZE_MAX];
+static float benchRightF[BENCH_BLOCK_SIZE_MAX];
+static float benchLfoBuffer[BENCH_BLOCK_SIZE_MAX];
+static uint8_t benchULaw[BENCH_BLOCK_SIZE_MAX];
+static uint8_t benchAdpcm[((BENCH_BLOCK_SIZE_MAX + SMPL_ADPCM_BLOCK_SAMPLES - 1) / SMPL_ADPCM_BLOCK_SAMPLES) * SMPL_ADPCM_BLOCK_BYTES];
+
+static ML_LFO benchLfo(SAMPLE_RATE, benchLfoBuffer, BENCH_BLOCK_SIZE_MAX);
+static ML_Vibrato benchVibrato(SAMPLE_RATE);
+static ML_PitchShifter benchPitchShifter(SAMPLE_RATE);
+#ifdef REVERB_ENABLED
+static ML_Tremolo benchTremolo(SAMPLE_RATE);
+#endif
+
+static const uint32_t benchBlockSizes[] = {16, 32, 48, 64, 128};
+static const uint8_t benchVoiceCounts[] = {1, 2, 4, 8, 16, 32};
+
+static const struct bench_stage_s benchStages[] =
+{
+    {"Q1_14 -> float", bench_Q14ToFloat, false},
+    {"float -> Q1_14", bench_FloatToQ14, true},
+    {"mixStereoToMono", bench_MixStereoToMono, true},
+#ifdef REVERB_ENABLED
+    {"Reverb_Process", bench_Reverb, true},
+#endif
+    {"lfo.Process", bench_Lfo, true},
+    {"Phaser_ProcessHQ", bench_PhaserHQ, true},
+    {"Phaser_Process", bench_Phaser, false},
+    {"vibrato.ProcessHQ", bench_VibratoHQ, true},
+    {"vibrato.Process", bench_Vibrato, false},
+    {"pitchShifter.ProcessHQ", bench_PitchShifterHQ, true},
+    {"pitchShifter.Process", bench_PitchShifter, false},
+#ifdef REVERB_ENABLED
+    {"tremolo.Process", bench_Tremolo, true},
+#endif
+#ifdef MAX_DELAY_Q
+    {"DelayQ_Process_Buff", bench_DelayQ, true},
+#endif
+    {"SmplCodec_DecodeULaw", bench_DecodeULaw, false},
+    {"SmplCodec_DecodeAdpcm", bench_DecodeAdpcm, false},
+};
+
+
+/*
+ * static function definitions
+ */
+static void bench_Q14ToFloat(uint32_t n)
+{
+    const float convf = 1.0f / 16384.0f;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        benchLeftF[i] = ((float)benchLeft[i].s16) * convf;
+        benchRightF[i] = ((float)benchRight[i].s16) * convf;
+    }
+}
+
+static void bench_FloatToQ14(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        benchLeft[i].s16 = benchLeftF[i] * 16384;
+        benchRight[i].s16 = benchRightF[i] * 16384;
+    }
+}
+
+static void bench_MixStereoToMono(uint32_t n)
+{
+    mixStereoToMono(benchLeft, benchRight, benchMono, n);
+}
+
+#ifdef REVERB_ENABLED
+static void bench_Reverb(uint32_t n)
+{
+    Reverb_Process(benchMono, n);
+}
+
+static void bench_Tremolo(uint32_t n)
+{
+    benchTremolo.Process(benchMono, benchMono, benchLfoBuffer, benchLeftF, benchRightF, n);
+}
+#endif
+
+static void bench_Lfo(uint32_t n)
+{
+    benchLfo.Process(n);
+}
+
+static void bench_PhaserHQ(uint32_t n)
+{
+    Phaser_ProcessHQ(benchMono, benchLfoBuffer, benchMono, n);
+}
+
+static void bench_Phaser(uint32_t n)
+{
+    Phaser_Process(benchMono, benchLfoBuffer, benchMono, n);
+}
+
+static void bench_VibratoHQ(uint32_t n)
+{
+    benchVibrato.ProcessHQ(benchMono, benchLfoBuffer, benchMono, n);
+}
+
+static void bench_Vibrato(uint32_t n)
+{
+    benchVibrato.Process(benchMono, benchLfoBuffer, benchMono, n);
+}
+
+static void bench_PitchShifterHQ(uint32_t n)
+{
+    benchPitchShifter.ProcessHQ(benchMono, benchMono, n);
+}
+
+static void bench_PitchShifter(uint32_t n)
+{
+    benchPitchShifter.Process(benchMono, benchMono, n);
+}
+
+#ifdef MAX_DELAY_Q
+static void bench_DelayQ(uint32_t n)
+{
+    DelayQ_Process_Buff(&benchLeft[0].s16, &benchRight[0].s16, &benchLeft[0].s16, &benchRight[0].s16, n);
+}
+#endif
+
+static void bench_DecodeULaw(uint32_t n)
+{
+    SmplCodec_DecodeULaw(benchULaw, &benchLeft[0].s16, n);
+}
+
+static void bench_DecodeAdpcm(uint32_t n)
+{
+    SmplCodec_DecodeAdpcm(benchAdpcm, &benchLeft[0].s16, n);
+}
+
+/*
+ * compressed sine for the decoders, cost per sample of a stream voice using the codec
+ */
+static void bench_EncodeTestData(void)
+{
+    int16_t *pcm = &benchLeft[0].s16;
+    uint8_t adpcmIndex = 0;
+
+    for (uint32_t i = 0; i < BENCH_BLOCK_SIZE_MAX; i++)
+    {
+        pcm[i] = 8192.0f * sinf(2.0f * ((float)M_PI) * ((float)i) * 4.0f / ((float)BENCH_BLOCK_SIZE_MAX));
+    }
+    SmplCodec_Encode(SMPL_CODEC_ULAW, pcm, BENCH_BLOCK_SIZE_MAX, benchULaw, NULL);
+    SmplCodec_Encode(SMPL_CODEC_ADPCM, pcm, BENCH_BLOCK_SIZE_MAX, benchAdpcm, &adpcmIndex);
+}
+
+static void bench_Sampler(uint32_t n)
+{
+    memset(benchLeft, 0, sizeof(benchLeft[0]) * n);
+    memset(benchRight, 0, sizeof(benchRight[0]) * n);
+    Sampler_Process(benchLeft, benchRight, n);
+}
+
+/*
+ * returns the processing time in ns per sample
+ */
+static float bench_Measure(void (*process)(uint32_t n), uint32_t n)
+{
+    uint32_t iterations = 0;
+    uint32_t start = micros();
+    uint32_t elapsed;
+
+    do
+    {
+        process(n);
+        iterations++;
+        elapsed = micros() - start;
+    }
+    while (elapsed < BENCH_MIN_TIME_US);
+
+    return ((float)elapsed) * 1000.0f / (((float)iterations) * ((float)n));
+}
+
+/*
+ * a looped sine wave is used, so all voices keep playing during the measurement
+ */
+static bool bench_LoadTestSample(void)
+{
+    if (!Sampler_NewSample())
+    {
+        Serial.printf("Could not add the test sample!\n");
+        return false;
+    }
+
+    App_StopSampleMemClear();
+    Sampler_StartTransfer();
+    for (uint32_t i = 0; i < BENCH_TEST_SAMPLE_CNT; i += BENCH_BLOCK_SIZE_MAX)
+    {
+        for (uint32_t k = 0; k < BENCH_BLOCK_SIZE_MAX; k++)
+        {
+            benchLeft[k].s16 = 8192.0f * sinf(2.0f * ((float)M_PI) * ((float)(i + k)) * 100.0f / ((float)BENCH_TEST_SAMPLE_CNT));
+        }
+        Sampler_AddSamples(benchLeft, BENCH_BLOCK_SIZE_MAX);
+    }
+    Sampler_EndTransfer();
+
+    uint32_t sampleCnt = (BENCH_TEST_SAMPLE_CNT / BENCH_BLOCK_SIZE_MAX) * BENCH_BLOCK_SIZE_MAX;
+    Sampler_NewSampleSetRange(0, sampleCnt - 1);
+    Sampler_NewSampleSetLoop(0, sampleCnt - 1);
+    Sampler_SetLoopMode(1);
+    Sampler_SetPitch(BENCH_TEST_NOTE, SAMPLE_RATE, 0);
+    Sampler_FinishSample();
+    Sampler_InstrumentDone();
+
+    return true;
+}
+
+static void bench_PrintResult(const char *name, float ns)
+{
+    const float budgetNs = 1000000000.0f / ((float)BENCH_BUDGET_RATE);
+    Serial.printf("  %-32s %10.1f %9.2f%%\n", name, ns, 100.0f * ns / budgetNs);
+}
+
+
+/*
+ * extern function definitions
+ */
+void Bench_Run(void)
+{
+    const float budgetNs = 1000000000.0f / ((float)BENCH_BUDGET_RATE);
+    const uint32_t voiceCountCnt = sizeof(benchVoiceCounts) / sizeof(benchVoiceCounts[0]);
+
+    Serial.printf("benchmark of the audio path, budget %.1f ns/sample at %d Hz\n", budgetNs, BENCH_BUDGET_RATE);
+
+    bench_EncodeTestData();
+    memset(benchLeft, 0, sizeof(benchLeft));
+    memset(benchRight, 0, sizeof(benchRight));
+    memset(benchMono, 0, sizeof(benchMono));
+    memset(benchLeftF, 0, sizeof(benchLeftF));
+    memset(benchRightF, 0, sizeof(benchRightF));
+
+    bool samplerReady = bench_LoadTestSample();
+
+    for (uint32_t b = 0; b < sizeof(benchBlockSizes) / sizeof(benchBlockSizes[0]); b++)
+    {
+        uint32_t n = benchBlockSizes[b];
+        float chainNs = 0.0f;
+
+        Serial.printf("\nblock size: %" PRIu32 " (%.2f ms)\n", n, 1000.0f * ((float)n) / ((float)SAMPLE_RATE));
+        Serial.printf("  %-32s %10s %10s\n", "stage", "ns/sample", "budget");
+
+        for (uint32_t s = 0; s < sizeof(benchStages) / sizeof(benchStages[0]); s++)
+        {
+            float ns = bench_Measure(benchStages[s].process, n);
+            bench_PrintResult(benchStages[s].name, ns);
+            if (benchStages[s].hqChain)
+            {
+                chainNs += ns;
+            }
+        }
+        bench_PrintResult("effect chain (HQ)", chainNs);
+
+        if (!samplerReady)
+        {
+            continue;
+        }
+
+        float voiceNs[sizeof(benchVoiceCounts) / sizeof(benchVoiceCounts[0])];
+        for (uint32_t v = 0; v < voiceCountCnt; v++)
+        {
+            char name[40];
+
+            Sampler_AllNotesOff();
+            for (uint8_t k = 0; k < benchVoiceCounts[v]; k++)
+            {
+                Sampler_NoteOn(0, BENCH_TEST_NOTE + k, 100);
+            }
+
+            voiceNs[v] = bench_Measure(bench_Sampler, n);
+            snprintf(name, sizeof(name), "Sampler_Process (%u voices)", benchVoiceCounts[v]);
+            bench_PrintResult(name, voiceNs[v]);
+        }
+        Sampler_AllNotesOff();
+
+        /* linear estimation using the smallest and the largest voice count */
+        float perVoiceNs = (voiceNs[voiceCountCnt - 1] - voiceNs[0]) / ((float)(benchVoiceCounts[voiceCountCnt - 1] - benchVoiceCounts[0]));
+        float baseNs = voiceNs[0] - perVoiceNs * benchVoiceCounts[0];
+        bench_PrintResult("per voice", perVoiceNs);
+        if (perVoiceNs > 0.0f)
+        {
+            Serial.printf("  estimated voice limit with HQ chain: %d\n", (int)((budgetNs - chainNs - baseNs) / perVoiceNs));
+        }
+    }
+
+    Sampler_ClearAllSamples();
+    SampleTransfer_SetMemUsed(0);
+    Serial.printf("\nbenchmark done\n");
+}
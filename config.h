@@ -50,11 +50,18 @@
 
 
 // #define MIDI_STREAM_PLAYER_ENABLED /* activate this to use the midi stream playback module */
+// #define BENCHMARK_ENABLED /* activate this to run the benchmark of the audio path after startup (see bench.cpp) */
+// #define DUAL_CORE_RENDER /* activate this to render the sampler on the second core of ESP32 / RP2040 (see dual_render.cpp) */
+// #define SAMPLE_STREAMING_ENABLED /* activate this to stream long samples from the file system on ESP32 (see stream_voice.cpp) */
+// #define HOT_SWAP_ENABLED /* activate this to load into the second half of the sample memory while the first one is playing (see hot_swap.cpp) */
+// #define SMPL_ARENA_ENABLED /* activate this to unload single instruments without reloading the others (see smpl_arena.cpp) */
 
 
-#define SAMPLE_BUFFER_SIZE  48
+#define SAMPLE_BUFFER_SIZE  48 /* samples passed to the audio driver at once */
 #define SAMPLE_RATE 48000
 
+#define BLOCK_SIZE_MAX  128 /* largest block size selectable at runtime (see App_SetBlockSize) */
+
 //#define OUTPUT_SAW_TEST
 
 #define SERIAL_BAUDRATE 115200
@@ -71,6 +78,7 @@
 #include "config/config_esp32s2.h"
 #include "config/config_esp8266.h"
 #include "config/config_generic_f407vgtx.h"
+#include "config/config_host.h"
 #include "config/config_rp2040.h"
 #include "config/config_rp2350.h"
 #include "config/config_teensy.h"
@@ -80,7 +88,9 @@
  * include the board configuration
  * there you will find the most hardware depending pin settings
  */
+#ifndef ML_HOST_BUILD
 #include <ml_boards.h> /* requires the ML_Synth library:  https://github.com/marcel-licence/ML_SynthTools */
+#endif
 
 
 #endif /* CONFIG_H_ */
@@ -101,8 +101,6 @@
 #define SAMPLE_BUFFER_SIZE  48
 #define SAMPLE_RATE 48000
 
-#define SAMPLE_BUFFER_SIZE  48
-
 /* MIDI_VIA_USB_ENABLED activates MIDI via USB (please look into usbMidiHost.ino for more information) */
 //#define MIDI_VIA_USB_ENABLED
 
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie knnen es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * verffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es ntzlich sein wird, jedoch
+ * OHNE JEDE GEWHR,; sogar ohne die implizite
+ * Gewhr der MARKTFHIGKEIT oder EIGNUNG FR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License fr weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file config_host.h
+ * @author Marcel Licence
+ *
+ * @brief Configuration for the host (Linux) offline render target
+ * @see host/Makefile
+ */
+
+#ifdef ML_HOST_BUILD
+
+#define SAMPLE_HDR_CNT  32
+#define SAMPLE_SIZE_16BIT
+#define MAX_DELAY_Q 12000
+#define REVERB_ENABLED
+
+/* the host has plenty of memory, so the sampler gets a large static buffer */
+#define SAMPLER_STATIC_BUFFER_SAMPLE_CNT   (1024 * 1024 * 32)
+
+#endif /* ML_HOST_BUILD */
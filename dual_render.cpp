@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file dual_render.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Dual core render pipeline
+ * @n       The sampler is rendered by the second core (Core0Task on ESP32, loop1 on RP2040) while
+ * @n       the audio core processes the effects and the output of the previous block.
+ * @n       The voices of the sampler can not be rendered in parallel because they share one state.
+ * @n       For this reason the sampler state is only touched by the audio core (MIDI) between
+ * @n       DualRender_Sync and DualRender_Process when the render core is idle.
+ * @n       The pipeline adds one block of latency.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "dual_render.h"
+#include "perf_mon.h"
+#include "midi_sched.h"
+#include "voice_alloc.h"
+
+
+#ifdef DUAL_RENDER_ACTIVE
+
+
+/*
+ * static variables
+ */
+static Q1_14 renderLeft[2][BLOCK_SIZE_MAX];
+static Q1_14 renderRight[2][BLOCK_SIZE_MAX];
+static uint32_t renderLen[2]; /*!< block size of the requested block */
+
+/* the buffer of a block is selected by the lowest bit of the block counter */
+static uint32_t renderReq = 0; /*!< block requested by the audio core */
+static uint32_t renderDone = 0; /*!< block finished by the render core */
+
+static volatile uint32_t renderCycles = 0;
+static volatile uint32_t renderCyclesMax = 0;
+static volatile uint32_t renderWaitCnt = 0; /*!< blocks the audio core had to wait for the render core */
+
+#ifdef ESP32
+static TaskHandle_t renderTask = NULL;
+#endif
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * to be called from the second core during setup
+ */
+void DualRender_Setup1(void)
+{
+#ifdef ESP32
+    renderTask = xTaskGetCurrentTaskHandle();
+#endif
+}
+
+/*
+ * to be called from the second core, renders the requested block
+ */
+void DualRender_Loop1(void)
+{
+    uint32_t req = __atomic_load_n(&renderReq, __ATOMIC_ACQUIRE);
+
+    if (req != renderDone)
+    {
+        uint32_t start = PERF_CYCLES();
+        uint32_t len = renderLen[req & 1];
+
+        memset(renderLeft[req & 1], 0, len * sizeof(Q1_14));
+        memset(renderRight[req & 1], 0, len * sizeof(Q1_14));
+        MidiSched_Render(renderLeft[req & 1], renderRight[req & 1], len);
+
+        uint32_t cycles = PERF_CYCLES() - start;
+        renderCycles = cycles;
+        if (cycles > renderCyclesMax)
+        {
+            renderCyclesMax = cycles;
+        }
+
+        /* the voices have the complete budget of the render core */
+        VoiceAlloc_Process(cycles, cycles, PerfMon_GetBudget(), len);
+
+        __atomic_store_n(&renderDone, req, __ATOMIC_RELEASE);
+    }
+}
+
+/*
+ * replaces delay(1) in the loop of the second core, returns early when a block has been requested
+ */
+void DualRender_Idle(void)
+{
+#ifdef ESP32
+    ulTaskNotifyTake(pdTRUE, 1);
+#endif
+}
+
+/*
+ * waits until the render core has finished the requested block, the sampler can be accessed afterwards
+ */
+void DualRender_Sync(void)
+{
+    if (__atomic_load_n(&renderDone, __ATOMIC_ACQUIRE) != renderReq)
+    {
+        renderWaitCnt++;
+        while (__atomic_load_n(&renderDone, __ATOMIC_ACQUIRE) != renderReq)
+        {
+            /* wait for the render core */
+        }
+    }
+}
+
+/*
+ * adds the finished block to the buffers and requests the next one
+ * after a change of the block size the finished block will be shorter or longer once
+ */
+void DualRender_Process(Q1_14 *left, Q1_14 *right, uint32_t len)
+{
+    uint32_t ready = renderReq;
+
+    if (ready > 0)
+    {
+        uint32_t readyLen = (renderLen[ready & 1] < len) ? renderLen[ready & 1] : len;
+        for (uint32_t n = 0; n < readyLen; n++)
+        {
+            left[n].s16 = constrain((int32_t)left[n].s16 + renderLeft[ready & 1][n].s16, INT16_MIN, INT16_MAX);
+            right[n].s16 = constrain((int32_t)right[n].s16 + renderRight[ready & 1][n].s16, INT16_MIN, INT16_MAX);
+        }
+    }
+
+    renderLen[(ready + 1) & 1] = len;
+    __atomic_store_n(&renderReq, ready + 1, __ATOMIC_RELEASE);
+
+#ifdef ESP32
+    if (renderTask != NULL)
+    {
+        xTaskNotifyGive(renderTask);
+    }
+#endif
+}
+
+uint32_t DualRender_GetLastCycles(void)
+{
+    return renderCycles;
+}
+
+/*
+ * serial command: "dual" prints the load of the render core, "dual reset" clears the counters
+ */
+void DualRender_Cmd(const char *args)
+{
+    if (strcmp(args, "reset") == 0)
+    {
+        renderCyclesMax = 0;
+        renderWaitCnt = 0;
+    }
+
+    uint32_t budget = PerfMon_GetBudget();
+    uint32_t last = renderCycles;
+    uint32_t max = renderCyclesMax;
+
+    Serial.printf("render core: last %" PRIu32 " us, max %" PRIu32 " us, budget %" PRIu32 " us\n",
+                  PerfMon_CyclesToUs(last), PerfMon_CyclesToUs(max), PerfMon_CyclesToUs(budget));
+    if (budget > 0)
+    {
+        Serial.printf("render core load: %" PRIu32 "%% (max %" PRIu32 "%%)\n",
+                      (uint32_t)((((uint64_t)last) * 100) / budget), (uint32_t)((((uint64_t)max) * 100) / budget));
+    }
+    Serial.printf("blocks waited for the render core: %" PRIu32 "\n", renderWaitCnt);
+}
+
+
+#endif /* DUAL_RENDER_ACTIVE */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file dual_render.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the dual core render pipeline
+ */
+
+
+#ifndef DUAL_RENDER_H_
+#define DUAL_RENDER_H_
+
+
+/*
+ * includes
+ */
+#include "config.h"
+
+#include <ml_types.h>
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#if (defined DUAL_CORE_RENDER) && (((defined ESP32) && (SOC_CPU_CORES_NUM > 1)) || (defined ARDUINO_ARCH_RP2040))
+#define DUAL_RENDER_ACTIVE /*!< the sampler will be rendered by the second core */
+#endif
+
+
+/*
+ * declarations
+ */
+#ifdef DUAL_RENDER_ACTIVE
+void DualRender_Setup1(void);
+void DualRender_Loop1(void);
+void DualRender_Idle(void);
+void DualRender_Sync(void);
+void DualRender_Process(Q1_14 *left, Q1_14 *right, uint32_t len);
+uint32_t DualRender_GetLastCycles(void);
+void DualRender_Cmd(const char *args);
+#endif
+
+
+#endif /* DUAL_RENDER_H_ */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file Arduino.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Minimal stand-in of the Arduino core used by the host render target
+ * @n       Only the functions used by this project are provided
+ */
+
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+
+/*
+ * data types
+ */
+class HostSerial
+{
+public:
+    void begin(uint32_t baudrate __attribute__((unused))) {}
+
+    operator bool() const
+    {
+        return true;
+    }
+
+    int available(void)
+    {
+        return 0;
+    }
+
+    int read(void)
+    {
+        return -1;
+    }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        va_list args;
+        va_start(args, format);
+        int len = vfprintf(stdout, format, args);
+        va_end(args);
+        return len > 0 ? len : 0;
+    }
+
+    size_t print(const char *str)
+    {
+        return fputs(str, stdout) >= 0 ? strlen(str) : 0;
+    }
+
+    size_t println(const char *str = "")
+    {
+        return print(str) + print("\n");
+    }
+};
+
+
+/*
+ * declarations
+ */
+extern HostSerial Serial;
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void yield(void);
+
+
+#endif /* HOST_ARDUINO_H_ */
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file fs_access.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Host stand-in of the ML_SynthTools file system access module
+ * @n       Each file system id is mapped to a directory of the host
+ */
+
+
+#ifndef HOST_FS_ACCESS_H_
+#define HOST_FS_ACCESS_H_
+
+
+#include <stdint.h>
+#include <stdio.h>
+
+
+/*
+ * data types
+ */
+enum fs_id_e
+{
+    FS_ID_LITTLEFS,
+    FS_ID_SD_MMC,
+    FS_ID_CNT,
+};
+
+typedef enum fs_id_e fs_id_t;
+
+typedef void (*fs_file_cb_t)(const char *filename, int depth, uint8_t note);
+
+
+/*
+ * declarations
+ */
+void FS_Setup(void);
+bool FS_OpenFile(fs_id_t id, const char *filename);
+void FS_CloseFile(void);
+void FS_UseTempFile(void);
+uint32_t readBytes(uint8_t *buffer, uint32_t len);
+void fileSeekTo(uint32_t pos);
+uint32_t getCurrentOffset(void);
+uint32_t getStaticPos(void);
+void WavToKeyboard(fs_id_t id, const char *dirname, fs_file_cb_t cb, int depth, int maxDepth, uint8_t note);
+
+/* host only */
+void HostFs_SetRoot(fs_id_t id, const char *dirname);
+FILE *HostFs_OpenStream(fs_id_t id, const char *filename, const char *mode);
+
+
+#endif /* HOST_FS_ACCESS_H_ */
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file host.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the host stand-ins which replace the board specific modules
+ */
+
+
+#ifndef HOST_H_
+#define HOST_H_
+
+
+#include <stdint.h>
+
+
+/*
+ * data types
+ */
+
+/*
+ * control change mapping with the layout of struct midiControllerMapping of the library,
+ * the entries are taken from midi_ctrl_table.h
+ */
+struct hostMidiCtrl_s
+{
+    uint8_t channel;
+    uint8_t data1;
+    const char *desc;
+    void (*callback_mid)(uint8_t ch, uint8_t data1, uint8_t data2);
+    void (*callback_val)(uint8_t userdata, uint8_t value);
+    uint8_t user_data;
+};
+
+extern struct hostMidiCtrl_s hostMidiCtrls[];
+extern const uint32_t hostMidiCtrlCount;
+
+
+/*
+ * declarations
+ */
+bool HostAudio_Open(const char *filename);
+void HostAudio_Close(void);
+uint64_t HostAudio_GetSampleCount(void);
+
+uint64_t HostTime_GetNs(void);
+
+bool HostMidi_LoadFile(const char *filename);
+bool HostMidi_Done(void);
+
+
+#endif /* HOST_H_ */
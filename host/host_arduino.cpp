@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file host_arduino.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Host implementation of the Arduino core functions
+ */
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "host.h"
+
+#include <time.h>
+
+
+/*
+ * global variables
+ */
+HostSerial Serial;
+
+
+/*
+ * extern function definitions
+ */
+uint64_t HostTime_GetNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+uint32_t millis(void)
+{
+    return HostTime_GetNs() / 1000000ULL;
+}
+
+uint32_t micros(void)
+{
+    return HostTime_GetNs() / 1000ULL;
+}
+
+void delay(uint32_t ms __attribute__((unused)))
+{
+    /* nothing to wait for when rendering offline */
+}
+
+void yield(void)
+{
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file host_audio.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Host stand-in of the audio output, all blocks are written to a wav file
+ */
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "host.h"
+#include "ml_wavfile.h"
+
+#include <ml_types.h>
+
+
+/*
+ * static variables
+ */
+static FILE *wavFile = NULL;
+static uint64_t samplesWritten = 0;
+
+
+/*
+ * extern function definitions
+ */
+bool HostAudio_Open(const char *filename)
+{
+    wavFile = fopen(filename, "wb");
+    if (wavFile == NULL)
+    {
+        Serial.printf("Failed to create %s\n", filename);
+        return false;
+    }
+
+    /* placeholder, the header will be completed when the file is closed */
+    union wavHeader wavHdr;
+    memset(wavHdr.wavHdr, 0, sizeof(wavHdr.wavHdr));
+    fwrite(wavHdr.wavHdr, 1, sizeof(wavHdr.wavHdr), wavFile);
+    samplesWritten = 0;
+    return true;
+}
+
+void HostAudio_Close(void)
+{
+    if (wavFile == NULL)
+    {
+        return;
+    }
+
+    uint32_t dataSize = samplesWritten * 2 * sizeof(int16_t);
+
+    union wavHeader wavHdr;
+    memcpy(wavHdr.riff, "RIFF", 4);
+    wavHdr.fileSize = sizeof(wavHdr.wavHdr) - 8 + dataSize;
+    memcpy(wavHdr.waveType, "WAVE", 4);
+    memcpy(wavHdr.format, "fmt ", 4);
+    wavHdr.lengthOfData = 16;
+    wavHdr.format_tag = 0x0001;
+    wavHdr.numberOfChannels = 2;
+    wavHdr.sampleRate = SAMPLE_RATE;
+    wavHdr.byteRate = SAMPLE_RATE * 2 * sizeof(int16_t);
+    wavHdr.bytesPerSample = 2 * sizeof(int16_t);
+    wavHdr.bitsPerSample = 16;
+    memcpy(wavHdr.nextTag.tag_name, "data", 4);
+    wavHdr.nextTag.tag_data_size = dataSize;
+
+    fseek(wavFile, 0, SEEK_SET);
+    fwrite(wavHdr.wavHdr, 1, sizeof(wavHdr.wavHdr), wavFile);
+    fclose(wavFile);
+    wavFile = NULL;
+}
+
+uint64_t HostAudio_GetSampleCount(void)
+{
+    return samplesWritten;
+}
+
+void Audio_Setup(void)
+{
+}
+
+void Audio_Output(const Q1_14 *left, const Q1_14 *right)
+{
+    int16_t frame[SAMPLE_BUFFER_SIZE * 2];
+
+    for (int n = 0; n < SAMPLE_BUFFER_SIZE; n++)
+    {
+        /* Q1_14 has 2 bits headroom, the output uses the full 16 bit range */
+        int32_t l = ((int32_t)left[n].s16) * 2;
+        int32_t r = ((int32_t)right[n].s16) * 2;
+        frame[2 * n] = l > INT16_MAX ? INT16_MAX : (l < INT16_MIN ? INT16_MIN : l);
+        frame[2 * n + 1] = r > INT16_MAX ? INT16_MAX : (r < INT16_MIN ? INT16_MIN : r);
+    }
+
+    if (wavFile != NULL)
+    {
+        fwrite(frame, sizeof(int16_t), SAMPLE_BUFFER_SIZE * 2, wavFile);
+    }
+    samplesWritten += SAMPLE_BUFFER_SIZE;
+}
@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file host_bank_convert.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Converter of soundfonts and wav files into a sample bank image (see smpl_bank.h)
+ * @n       The regions are computed by the same code used by the soundfont loader of the sketch.
+ * @n       Only the sample data referenced by the selected presets will be stored.
+ * @n       The image can also be written as C header to be placed into the flash with the sketch.
+ */
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "smpl_bank.h"
+#include "sf_to_sampler.h"
+
+#include <ml_soundfont.h>
+#include <fs/fs_access.h>
+
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+/*
+ * defines
+ */
+#define BANK_CONVERT_GUARD  8 /*!< samples kept behind the end of a sample for the interpolation */
+
+
+/*
+ * data types
+ */
+struct bank_range_s
+{
+    uint32_t start;
+    uint32_t end;
+    uint32_t dst;
+};
+
+
+/*
+ * static function declarations
+ */
+static void bankConvert_PrintUsage(const char *name);
+static void bankConvert_CollectZone(struct instrLoadInfo_s *info);
+static uint32_t bankConvert_Relocate(const std::vector<struct bank_range_s> &ranges, uint32_t pos);
+static bool bankConvert_AddSoundFont(const char *filename, const std::vector<uint32_t> &presets);
+static bool bankConvert_AddWav(const char *filename, uint8_t rootKey, uint8_t keyLow, uint8_t keyHigh);
+static std::vector<uint8_t> bankConvert_Image(void);
+static bool bankConvert_Write(const char *filename);
+static bool bankConvert_WriteHeader(const char *filename);
+
+
+/*
+ * static variables
+ */
+static std::vector<struct smpl_region_s> bankRegions;
+static std::vector<int16_t> bankPcm;
+static uint32_t bankInstrumentCnt = 0;
+
+static std::vector<struct smpl_region_s> sf2Zones; /*!< zones of the soundfont, positions within the smpl chunk */
+
+
+/*
+ * static function definitions
+ */
+static void bankConvert_PrintUsage(const char *name)
+{
+    printf("usage: %s -o <bank.smpb> [options]\n", name);
+    printf("  -o <bank.smpb>   output file\n");
+    printf("  -c <bank.h>      write the image as C array smplBankImage to be mapped from flash (SmplBank_Map)\n");
+    printf("  -p <n,n,...>     presets (index of the preset header) used from the following soundfonts, default: all\n");
+    printf("  -f <file.sf2>    add each preset of the soundfont as instrument\n");
+    printf("  -k <root,lo,hi>  root key and key range of the following wav files (default: 60,0,127)\n");
+    printf("  -w <file.wav>    add a mono or stereo 16 bit wav file, all wav files form one instrument\n");
+}
+
+static void bankConvert_CollectZone(struct instrLoadInfo_s *info)
+{
+    if ((info->start == 0) && (info->end == 0))
+    {
+        return;
+    }
+
+    struct smpl_region_s region;
+    SF2ToSmpl_RegionFromInfo(info, &region);
+    region.instrument = bankInstrumentCnt;
+    sf2Zones.push_back(region);
+}
+
+static uint32_t bankConvert_Relocate(const std::vector<struct bank_range_s> &ranges, uint32_t pos)
+{
+    for (const struct bank_range_s &range : ranges)
+    {
+        if ((pos >= range.start) && (pos <= range.end))
+        {
+            return range.dst + pos - range.start;
+        }
+    }
+    return 0;
+}
+
+static bool bankConvert_AddSoundFont(const char *filename, const std::vector<uint32_t> &presets)
+{
+    /* the host fs maps the name to a directory, absolute paths are used as they are */
+    HostFs_SetRoot(FS_ID_SD_MMC, (filename[0] == '/') ? "" : ".");
+    if (!FS_OpenFile(FS_ID_SD_MMC, filename))
+    {
+        return false;
+    }
+
+    struct sf2_soundfont_info_s *offset = ML_SF2_GetSoundFontInfo();
+    std::vector<uint32_t> list = presets;
+    if (list.empty())
+    {
+        for (uint32_t i = 0; i + 1 < offset->phdr_cnt; i++)
+        {
+            list.push_back(i);
+        }
+    }
+
+    sf2Zones.clear();
+    for (uint32_t preset : list)
+    {
+        if (bankInstrumentCnt > 0xFF)
+        {
+            printf("too many instruments\n");
+            break;
+        }
+        if (ML_SF2_LoadPresetMultiBag(preset, bankConvert_CollectZone))
+        {
+            bankInstrumentCnt++;
+        }
+        else
+        {
+            printf("preset %u not found\n", preset);
+        }
+    }
+
+    /* the ranges used by the zones, overlapping ranges are merged */
+    std::vector<struct bank_range_s> ranges;
+    for (const struct smpl_region_s &zone : sf2Zones)
+    {
+        struct bank_range_s range = { zone.start, zone.end + BANK_CONVERT_GUARD, 0 };
+        if (zone.loopMode != 0)
+        {
+            range.start = std::min(range.start, zone.loopStart);
+            range.end = std::max(range.end, zone.loopEnd + BANK_CONVERT_GUARD);
+        }
+        range.end = std::min(range.end, offset->smpl_cnt / 2);
+        ranges.push_back(range);
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const struct bank_range_s &a, const struct bank_range_s &b)
+    {
+        return a.start < b.start;
+    });
+
+    std::vector<struct bank_range_s> merged;
+    for (const struct bank_range_s &range : ranges)
+    {
+        if (!merged.empty() && (range.start <= merged.back().end))
+        {
+            merged.back().end = std::max(merged.back().end, range.end);
+        }
+        else
+        {
+            merged.push_back(range);
+        }
+    }
+
+    for (struct bank_range_s &range : merged)
+    {
+        range.dst = bankPcm.size();
+        bankPcm.resize(bankPcm.size() + range.end - range.start);
+        fileSeekTo(offset->smpl + range.start * 2);
+        readBytes((uint8_t *)&bankPcm[range.dst], (range.end - range.start) * 2);
+    }
+
+    for (struct smpl_region_s zone : sf2Zones)
+    {
+        zone.start = bankConvert_Relocate(merged, zone.start);
+        zone.end = bankConvert_Relocate(merged, zone.end);
+        if (zone.loopMode != 0)
+        {
+            zone.loopStart = bankConvert_Relocate(merged, zone.loopStart);
+            zone.loopEnd = bankConvert_Relocate(merged, zone.loopEnd);
+        }
+        else
+        {
+            zone.loopStart = zone.start;
+            zone.loopEnd = zone.end;
+        }
+        bankRegions.push_back(zone);
+    }
+
+    printf("%s: %zu presets, %zu regions, %zu of %u kB\n", filename, list.size(), sf2Zones.size(),
+           bankPcm.size() * 2 / 1024, offset->smpl_cnt / 1024);
+
+    FS_CloseFile();
+    return true;
+}
+
+static bool bankConvert_AddWav(const char *filename, uint8_t rootKey, uint8_t keyLow, uint8_t keyHigh)
+{
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        printf("Failed to open %s\n", filename);
+        return false;
+    }
+
+    uint8_t riff[12];
+    if ((fread(riff, 1, sizeof(riff), file) != sizeof(riff)) || (memcmp(riff, "RIFF", 4) != 0) || (memcmp(&riff[8], "WAVE", 4) != 0))
+    {
+        printf("%s is not a wav file\n", filename);
+        fclose(file);
+        return false;
+    }
+
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    uint32_t sampleRate = 0;
+    std::vector<int16_t> data;
+    bool loop = false;
+    uint32_t loopStart = 0;
+    uint32_t loopEnd = 0;
+
+    uint8_t chunk[8];
+    while (fread(chunk, 1, sizeof(chunk), file) == sizeof(chunk))
+    {
+        uint32_t size = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | ((uint32_t)chunk[7] << 24);
+        std::vector<uint8_t> payload(size);
+        if (fread(payload.data(), 1, size, file) != size)
+        {
+            break;
+        }
+        if (size & 1)
+        {
+            fseek(file, 1, SEEK_CUR);
+        }
+
+        if ((memcmp(chunk, "fmt ", 4) == 0) && (size >= 16))
+        {
+            memcpy(&channels, &payload[2], 2);
+            memcpy(&sampleRate, &payload[4], 4);
+            memcpy(&bits, &payload[14], 2);
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            data.resize(size / 2);
+            memcpy(data.data(), payload.data(), data.size() * 2);
+        }
+        else if ((memcmp(chunk, "smpl", 4) == 0) && (size >= 60))
+        {
+            uint32_t loopCnt;
+            memcpy(&loopCnt, &payload[28], 4);
+            if (loopCnt > 0)
+            {
+                memcpy(&loopStart, &payload[44], 4);
+                memcpy(&loopEnd, &payload[48], 4);
+                loop = true;
+            }
+        }
+    }
+    fclose(file);
+
+    if ((bits != 16) || (channels < 1) || (channels > 2) || data.empty())
+    {
+        printf("%s: only 16 bit mono or stereo is supported\n", filename);
+        return false;
+    }
+
+    uint32_t cnt = data.size() / channels;
+    uint32_t base = bankPcm.size();
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        /* stereo will be mixed down to mono */
+        bankPcm.push_back((channels == 2) ? ((data[i * 2] + data[i * 2 + 1]) / 2) : data[i]);
+    }
+
+    struct smpl_region_s region;
+    memset(&region, 0, sizeof(region));
+    region.start = base;
+    region.end = base + cnt - 1;
+    region.loopStart = region.start;
+    region.loopEnd = region.end;
+    if (loop && (loopEnd > loopStart) && (loopEnd < cnt))
+    {
+        region.loopMode = 1;
+        region.loopStart = base + loopStart;
+        region.loopEnd = base + loopEnd;
+    }
+    region.rootKey = rootKey;
+    region.sampleRate = sampleRate;
+    region.keyLow = keyLow;
+    region.keyHigh = keyHigh;
+    region.velHigh = 127;
+    region.flags = SMPL_REGION_FLAG_KEY_RANGE;
+    region.instrument = bankInstrumentCnt;
+    bankRegions.push_back(region);
+
+    printf("%s: %u samples, root key %u, keys %u - %u%s\n", filename, cnt, rootKey, keyLow, keyHigh, region.loopMode ? ", looped" : "");
+    return true;
+}
+
+/*
+ * returns the complete image: header, region table and sample data
+ */
+static std::vector<uint8_t> bankConvert_Image(void)
+{
+    std::vector<uint8_t> image;
+    struct smpl_bank_hdr_s hdr;
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = SMPL_BANK_MAGIC;
+    hdr.version = SMPL_BANK_VERSION;
+    hdr.regionSize = sizeof(struct smpl_region_s);
+    hdr.regionCnt = bankRegions.size();
+    hdr.instrumentCnt = bankInstrumentCnt;
+    hdr.pcmCnt = bankPcm.size();
+
+    image.insert(image.end(), (uint8_t *)&hdr, (uint8_t *)&hdr + sizeof(hdr));
+    image.insert(image.end(), (uint8_t *)bankRegions.data(), (uint8_t *)bankRegions.data() + bankRegions.size() * sizeof(struct smpl_region_s));
+    image.insert(image.end(), (uint8_t *)bankPcm.data(), (uint8_t *)bankPcm.data() + bankPcm.size() * sizeof(int16_t));
+
+    printf("image: %u instruments, %zu regions, %zu kB\n", bankInstrumentCnt, bankRegions.size(), bankPcm.size() * 2 / 1024);
+    return image;
+}
+
+static bool bankConvert_Write(const char *filename)
+{
+    std::vector<uint8_t> image = bankConvert_Image();
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        printf("Failed to create %s\n", filename);
+        return false;
+    }
+
+    bool ok = (fwrite(image.data(), 1, image.size(), file) == image.size());
+    fclose(file);
+    return ok;
+}
+
+/*
+ * writes the image as C array, the array will be stored in the flash with the sketch
+ */
+static bool bankConvert_WriteHeader(const char *filename)
+{
+    std::vector<uint8_t> image = bankConvert_Image();
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        printf("Failed to create %s\n", filename);
+        return false;
+    }
+
+    fprintf(file, "/* sample bank image generated by ml_bank_convert, see smpl_bank.h */\n");
+    fprintf(file, "#include <stdint.h>\n\n");
+    fprintf(file, "const uint8_t smplBankImage[%zu] __attribute__((aligned(4))) =\n{", image.size());
+    for (size_t i = 0; i < image.size(); i++)
+    {
+        fprintf(file, "%s0x%02x,", ((i % 16) == 0) ? "\n    " : " ", image[i]);
+    }
+    fprintf(file, "\n};\n");
+
+    bool ok = (ferror(file) == 0);
+    fclose(file);
+    return ok;
+}
+
+/*
+ * extern function definitions
+ */
+int main(int argc, char *argv[])
+{
+    const char *outFile = NULL;
+    const char *headerFile = NULL;
+    std::vector<uint32_t> presets;
+    unsigned int rootKey = 60, keyLow = 0, keyHigh = 127;
+    bool wavAdded = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:c:p:f:k:w:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o':
+            outFile = optarg;
+            break;
+        case 'c':
+            headerFile = optarg;
+            break;
+        case 'p':
+            presets.clear();
+            for (char *tok = strtok(optarg, ","); tok != NULL; tok = strtok(NULL, ","))
+            {
+                presets.push_back(atoi(tok));
+            }
+            break;
+        case 'f':
+            if (!bankConvert_AddSoundFont(optarg, presets))
+            {
+                return 1;
+            }
+            break;
+        case 'k':
+            if ((sscanf(optarg, "%u,%u,%u", &rootKey, &keyLow, &keyHigh) != 3) || (rootKey > 127) || (keyLow > keyHigh) || (keyHigh > 127))
+            {
+                printf("invalid key mapping %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'w':
+            if (!bankConvert_AddWav(optarg, rootKey, keyLow, keyHigh))
+            {
+                return 1;
+            }
+            wavAdded = true;
+            break;
+        default:
+            bankConvert_PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((outFile == NULL) && (headerFile == NULL))
+    {
+        bankConvert_PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (wavAdded)
+    {
+        bankInstrumentCnt++;
+    }
+
+    if ((outFile != NULL) && !bankConvert_Write(outFile))
+    {
+        return 1;
+    }
+    if ((headerFile != NULL) && !bankConvert_WriteHeader(headerFile))
+    {
+        return 1;
+    }
+    return 0;
+}
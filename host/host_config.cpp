@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file host_config.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Mapping configuration of the host render target (replaces z_config.ino)
+ */
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "app.h"
+#include "perf_mon.h"
+#include "serial_cmd.h"
+#include "xrun_mon.h"
+#include "quality_gov.h"
+#include "voice_alloc.h"
+#include "preset_cache.h"
+#include "sf2_index.h"
+#include "load_job.h"
+#include "hot_swap.h"
+#include "smpl_arena.h"
+#include "stream_voice.h"
+#include "dual_render.h"
+#include "midi_queue.h"
+#include "host.h"
+
+#include <ml_sampler.h>
+#include <ml_phaser.h>
+#ifdef MAX_DELAY_Q
+#include <ml_delay_q.h>
+#endif
+
+
+/*
+ * commands of the serial console, the same as in z_config.ino
+ */
+struct serialCmd_s serialCmds[] =
+{
+#include "serial_cmd_table.h"
+};
+
+struct serialCmdMapping_s serialCmdMapping =
+{
+    serialCmds,
+    sizeof(serialCmds) / sizeof(serialCmds[0]),
+};
+
+/*
+ * control change mapping, the same as edirolMapping in z_config.ino
+ */
+struct hostMidiCtrl_s hostMidiCtrls[] =
+{
+#include "midi_ctrl_table.h"
+};
+
+const uint32_t hostMidiCtrlCount = sizeof(hostMidiCtrls) / sizeof(hostMidiCtrls[0]);
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file host_fs.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Host implementation of the file system access functions used by the loaders
+ */
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+#include <fs/fs_access.h>
+
+#include <dirent.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+/*
+ * static variables
+ */
+static std::string fsRoot[FS_ID_CNT] = {".", "."};
+static FILE *mainFile = NULL;
+static FILE *tempFile = NULL;
+static FILE *activeFile = NULL;
+
+
+/*
+ * static function declarations
+ */
+static std::string hostFs_Path(fs_id_t id, const char *filename);
+
+
+/*
+ * static function definitions
+ */
+static std::string hostFs_Path(fs_id_t id, const char *filename)
+{
+    std::string path = fsRoot[id];
+    if (filename[0] != '/')
+    {
+        path += "/";
+    }
+    return path + filename;
+}
+
+
+/*
+ * extern function definitions
+ */
+void HostFs_SetRoot(fs_id_t id, const char *dirname)
+{
+    fsRoot[id] = dirname;
+}
+
+/*
+ * opens a second handle used by the stream voices and the snapshot
+ */
+FILE *HostFs_OpenStream(fs_id_t id, const char *filename, const char *mode)
+{
+    return fopen(hostFs_Path(id, filename).c_str(), mode);
+}
+
+void FS_Setup(void)
+{
+    Serial.printf("host fs: littlefs -> %s, sd_mmc -> %s\n", fsRoot[FS_ID_LITTLEFS].c_str(), fsRoot[FS_ID_SD_MMC].c_str());
+}
+
+bool FS_OpenFile(fs_id_t id, const char *filename)
+{
+    FS_CloseFile();
+    std::string path = hostFs_Path(id, filename);
+    mainFile = fopen(path.c_str(), "rb");
+    if (mainFile == NULL)
+    {
+        Serial.printf("Failed to open %s\n", path.c_str());
+        return false;
+    }
+    activeFile = mainFile;
+    return true;
+}
+
+void FS_CloseFile(void)
+{
+    if (mainFile != NULL)
+    {
+        fclose(mainFile);
+        mainFile = NULL;
+    }
+    activeFile = tempFile;
+}
+
+void FS_UseTempFile(void)
+{
+    activeFile = tempFile;
+}
+
+uint32_t readBytes(uint8_t *buffer, uint32_t len)
+{
+    if (activeFile == NULL)
+    {
+        return 0;
+    }
+    return fread(buffer, 1, len, activeFile);
+}
+
+void fileSeekTo(uint32_t pos)
+{
+    if (activeFile != NULL)
+    {
+        fseek(activeFile, pos, SEEK_SET);
+    }
+}
+
+uint32_t getCurrentOffset(void)
+{
+    return (activeFile != NULL) ? ftell(activeFile) : 0;
+}
+
+uint32_t getStaticPos(void)
+{
+    return getCurrentOffset();
+}
+
+void WavToKeyboard(fs_id_t id, const char *dirname, fs_file_cb_t cb, int depth, int maxDepth, uint8_t note)
+{
+    std::string path = hostFs_Path(id, dirname);
+    DIR *dir = opendir(path.c_str());
+    if (dir == NULL)
+    {
+        Serial.printf("Failed to open directory %s\n", path.c_str());
+        return;
+    }
+
+    std::vector<std::string> entries;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] != '.')
+        {
+            entries.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    /* keep the note mapping reproducible */
+    std::sort(entries.begin(), entries.end());
+
+    for (const std::string &name : entries)
+    {
+        std::string filename = std::string(dirname) + "/" + name;
+        std::string fullPath = path + "/" + name;
+
+        DIR *subDir = opendir(fullPath.c_str());
+        if (subDir != NULL)
+        {
+            closedir(subDir);
+            if (depth < maxDepth)
+            {
+                WavToKeyboard(id, filename.c_str(), cb, depth + 1, maxDepth, note);
+            }
+            continue;
+        }
+
+        tempFile = fopen(fullPath.c_str(), "rb");
+        if (tempFile != NULL)
+        {
+            cb(filename.c_str(), depth, note);
+            fclose(tempFile);
+            tempFile = NULL;
+            note++;
+        }
+    }
+    activeFile = mainFile;
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file host_main.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Entry point of the host render target
+ * @n       The complete App_Loop signal chain renders a MIDI file into a wav file as fast as possible
+ * @n       This allows profiling with perf/valgrind without the hardware
+ */
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "app.h"
+#include "host.h"
+#include "perf_mon.h"
+#include "xrun_mon.h"
+#include "voice_alloc.h"
+#include "sf_to_sampler.h"
+#include "wav_to_sampler.h"
+#include "smpl_bank.h"
+#include "smpl_snapshot.h"
+#include "load_job.h"
+
+#include <ml_sampler.h>
+#include <fs/fs_access.h>
+
+#include <unistd.h>
+
+
+/*
+ * static function declarations
+ */
+static void host_PrintUsage(const char *name);
+static void host_LoadData(void);
+
+
+/*
+ * static variables
+ */
+static const char *wavFile = NULL;
+static const char *sf2File = NULL;
+static const char *bankFile = NULL;
+static int loadCtrl = -1;
+
+
+/*
+ * static function definitions
+ */
+static void host_PrintUsage(const char *name)
+{
+    printf("usage: %s -i <file.mid> [options]\n", name);
+    printf("  -i <file.mid>  midi file to render\n");
+    printf("  -o <file.wav>  output file (default: out.wav)\n");
+    printf("  -d <dir>       directory used as LittleFS (default: .)\n");
+    printf("  -s <dir>       directory used as SD card (default: .)\n");
+    printf("  -l <n>         load data using SoundFontSamplerCtrl(n)\n");
+    printf("  -r <n>         request SoundFontSamplerCtrl(n) while rendering (see LoadJob_Request)\n");
+    printf("  -w <file.wav>  load a wav file from the LittleFS directory to all notes\n");
+    printf("  -f <file.sf2>  load a complete soundfont from the SD card directory\n");
+    printf("  -m <bank>      load a sample bank image from the SD card directory (see ml_bank_convert)\n");
+    printf("  -x <bank>      map a sample bank image file like a bank in flash\n");
+    printf("  -p <bank>      restore the data loaded by -l, -w, -f and -m from a snapshot in the SD card\n");
+    printf("                 directory, the snapshot will be created if not available\n");
+    printf("  -t <seconds>   time rendered after the last event (default: 2)\n");
+    printf("  -b <samples>   block size (16, 32, 48, 128, default: %d)\n", SAMPLE_BUFFER_SIZE);
+}
+
+
+static void host_LoadData(void)
+{
+    if (loadCtrl >= 0)
+    {
+        SoundFontSamplerCtrl(loadCtrl);
+    }
+    if (wavFile != NULL)
+    {
+        WavToSmpl_FileToSingleNote(FS_ID_LITTLEFS, wavFile, W2S_ALL_NOTES);
+        SmplBank_InstrumentDone();
+    }
+    if (sf2File != NULL)
+    {
+        SF2ToSmpl_LoadCompleteSoundFont(FS_ID_SD_MMC, sf2File);
+    }
+    if (bankFile != NULL)
+    {
+        SmplBank_Load(FS_ID_SD_MMC, bankFile);
+    }
+}
+
+
+/*
+ * extern function definitions
+ */
+int main(int argc, char *argv[])
+{
+    const char *midiFile = NULL;
+    const char *outFile = "out.wav";
+    const char *mapFile = NULL;
+    const char *snapshotFile = NULL;
+    int requestCtrl = -1;
+    float tailTime = 2.0f;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:o:d:s:l:r:w:f:m:x:p:t:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i':
+            midiFile = optarg;
+            break;
+        case 'o':
+            outFile = optarg;
+            break;
+        case 'd':
+            HostFs_SetRoot(FS_ID_LITTLEFS, optarg);
+            break;
+        case 's':
+            HostFs_SetRoot(FS_ID_SD_MMC, optarg);
+            break;
+        case 'l':
+            loadCtrl = atoi(optarg);
+            break;
+        case 'r':
+            requestCtrl = atoi(optarg);
+            break;
+        case 'w':
+            wavFile = optarg;
+            break;
+        case 'f':
+            sf2File = optarg;
+            break;
+        case 'm':
+            bankFile = optarg;
+            break;
+        case 'x':
+            mapFile = optarg;
+            break;
+        case 'p':
+            snapshotFile = optarg;
+            break;
+        case 't':
+            tailTime = atof(optarg);
+            break;
+        case 'b':
+            if (!App_SetBlockSize(atoi(optarg)))
+            {
+                printf("block size %s is not supported\n", optarg);
+                return 1;
+            }
+            break;
+        default:
+            host_PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (midiFile == NULL)
+    {
+        host_PrintUsage(argv[0]);
+        return 1;
+    }
+
+    App_Setup();
+
+    if (snapshotFile != NULL)
+    {
+        SmplSnapshot_LoadOrCreate(FS_ID_SD_MMC, snapshotFile, host_LoadData);
+    }
+    else
+    {
+        host_LoadData();
+    }
+    if ((mapFile != NULL) && !SmplBank_MapFile(mapFile))
+    {
+        return 1;
+    }
+
+    if (!HostMidi_LoadFile(midiFile) || !HostAudio_Open(outFile))
+    {
+        return 1;
+    }
+
+    if (requestCtrl >= 0)
+    {
+        LoadJob_Request(requestCtrl);
+    }
+
+    uint64_t tailSamples = tailTime * SAMPLE_RATE;
+    uint64_t tailEnd = 0;
+    uint64_t startTime = HostTime_GetNs();
+
+    while (true)
+    {
+        App_Loop();
+
+        if (HostMidi_Done())
+        {
+            if (tailEnd == 0)
+            {
+                tailEnd = HostAudio_GetSampleCount() + tailSamples;
+            }
+            else if (HostAudio_GetSampleCount() >= tailEnd)
+            {
+                break;
+            }
+        }
+    }
+
+    uint64_t renderTime = HostTime_GetNs() - startTime;
+    HostAudio_Close();
+
+    double audioSeconds = ((double)HostAudio_GetSampleCount()) / SAMPLE_RATE;
+    double renderSeconds = ((double)renderTime) / 1e9;
+    printf("rendered %.2f s of audio in %.3f s (%.1fx real time)\n", audioSeconds, renderSeconds, audioSeconds / renderSeconds);
+
+    PerfMon_Print();
+    XrunMon_Print();
+    VoiceAlloc_Cmd("");
+
+    return 0;
+}
@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file host_midi.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Host stand-in of the MIDI input, events are read from a standard MIDI file
+ * @n       The event times are converted to sample positions using the tempo map of the file
+ */
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "app.h"
+#include "host.h"
+#include "midi_sched.h"
+
+#include <ml_sampler.h>
+
+#include <algorithm>
+#include <vector>
+
+
+/*
+ * data types
+ */
+struct hostMidiEvent_s
+{
+    uint64_t tick;
+    uint64_t samplePos;
+    uint32_t order; /*!< keeps events of the same tick in file order */
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+    uint32_t tempo; /*!< only used by tempo events (status 0xFF) */
+};
+
+
+/*
+ * static variables
+ */
+static std::vector<struct hostMidiEvent_s> midiEvents;
+static size_t midiEventIdx = 0;
+static uint64_t midiSamplePos = 0;
+
+
+/*
+ * static function declarations
+ */
+static uint32_t hostMidi_ReadVarLen(const uint8_t *data, size_t len, size_t *pos);
+static bool hostMidi_ParseTrack(const uint8_t *data, size_t len, uint32_t *order);
+static void hostMidi_ControlChange(uint8_t ch, uint8_t data1, uint8_t data2);
+static void hostMidi_Dispatch(const struct hostMidiEvent_s *evt);
+
+
+/*
+ * static function definitions
+ */
+static uint32_t hostMidi_ReadVarLen(const uint8_t *data, size_t len, size_t *pos)
+{
+    uint32_t value = 0;
+    while (*pos < len)
+    {
+        uint8_t c = data[(*pos)++];
+        value = (value << 7) | (c & 0x7F);
+        if ((c & 0x80) == 0)
+        {
+            break;
+        }
+    }
+    return value;
+}
+
+static bool hostMidi_ParseTrack(const uint8_t *data, size_t len, uint32_t *order)
+{
+    size_t pos = 0;
+    uint64_t tick = 0;
+    uint8_t runningStatus = 0;
+
+    while (pos < len)
+    {
+        tick += hostMidi_ReadVarLen(data, len, &pos);
+        if (pos >= len)
+        {
+            return false;
+        }
+
+        uint8_t status = data[pos];
+        if (status & 0x80)
+        {
+            pos++;
+        }
+        else
+        {
+            status = runningStatus;
+        }
+
+        if (status == 0xFF)
+        {
+            if (pos >= len)
+            {
+                return false;
+            }
+            uint8_t type = data[pos++];
+            uint32_t metaLen = hostMidi_ReadVarLen(data, len, &pos);
+            if (pos + metaLen > len)
+            {
+                return false;
+            }
+            if ((type == 0x51) && (metaLen == 3))
+            {
+                struct hostMidiEvent_s evt = {tick, 0, (*order)++, 0xFF, 0, 0, 0};
+                evt.tempo = ((uint32_t)data[pos] << 16) | ((uint32_t)data[pos + 1] << 8) | data[pos + 2];
+                midiEvents.push_back(evt);
+            }
+            if (type == 0x2F)
+            {
+                return true;
+            }
+            pos += metaLen;
+        }
+        else if ((status == 0xF0) || (status == 0xF7))
+        {
+            uint32_t sysexLen = hostMidi_ReadVarLen(data, len, &pos);
+            pos += sysexLen;
+        }
+        else if (status & 0x80)
+        {
+            runningStatus = status;
+            uint8_t cmd = status & 0xF0;
+            uint8_t dataLen = ((cmd == 0xC0) || (cmd == 0xD0)) ? 1 : 2;
+            if (pos + dataLen > len)
+            {
+                return false;
+            }
+            struct hostMidiEvent_s evt = {tick, 0, (*order)++, status, data[pos], 0, 0};
+            if (dataLen == 2)
+            {
+                evt.data2 = data[pos + 1];
+            }
+            pos += dataLen;
+            midiEvents.push_back(evt);
+        }
+        else
+        {
+            /* data byte without running status */
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * walks the control change mapping like the MIDI module of the library does on the device
+ */
+static void hostMidi_ControlChange(uint8_t ch, uint8_t data1, uint8_t data2)
+{
+    for (uint32_t i = 0; i < hostMidiCtrlCount; i++)
+    {
+        const struct hostMidiCtrl_s *ctrl = &hostMidiCtrls[i];
+
+        if ((ctrl->channel == ch) && (ctrl->data1 == data1))
+        {
+            if (ctrl->callback_mid != NULL)
+            {
+                ctrl->callback_mid(ch, data1, data2);
+            }
+            if (ctrl->callback_val != NULL)
+            {
+                ctrl->callback_val(ctrl->user_data, data2);
+            }
+        }
+    }
+}
+
+static void hostMidi_Dispatch(const struct hostMidiEvent_s *evt)
+{
+    uint8_t ch = evt->status & 0x0F;
+
+    switch (evt->status & 0xF0)
+    {
+    case 0x90:
+        App_NoteOn(ch, evt->data1, evt->data2);
+        break;
+    case 0x80:
+        App_NoteOff(ch, evt->data1);
+        break;
+    case 0xB0:
+        hostMidi_ControlChange(ch, evt->data1, evt->data2);
+        break;
+    case 0xC0:
+        App_ProgramChange(ch, evt->data1);
+        break;
+    case 0xE0:
+        App_PitchBend(ch, ((uint16_t)evt->data2 << 7) | evt->data1);
+        break;
+    default:
+        break;
+    }
+}
+
+
+/*
+ * extern function definitions
+ */
+bool HostMidi_LoadFile(const char *filename)
+{
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        Serial.printf("Failed to open %s\n", filename);
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t len;
+    while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + len);
+    }
+    fclose(file);
+
+    if ((data.size() < 14) || (memcmp(data.data(), "MThd", 4) != 0))
+    {
+        Serial.printf("%s is not a standard midi file\n", filename);
+        return false;
+    }
+
+    uint16_t division = ((uint16_t)data[12] << 8) | data[13];
+    if (division & 0x8000)
+    {
+        Serial.printf("SMPTE time division is not supported\n");
+        return false;
+    }
+
+    midiEvents.clear();
+    uint32_t order = 0;
+    size_t pos = 8 + (((uint32_t)data[4] << 24) | ((uint32_t)data[5] << 16) | ((uint32_t)data[6] << 8) | data[7]);
+
+    while (pos + 8 <= data.size())
+    {
+        uint32_t chunkLen = ((uint32_t)data[pos + 4] << 24) | ((uint32_t)data[pos + 5] << 16) | ((uint32_t)data[pos + 6] << 8) | data[pos + 7];
+        if (pos + 8 + chunkLen > data.size())
+        {
+            break;
+        }
+        if (memcmp(&data[pos], "MTrk", 4) == 0)
+        {
+            if (!hostMidi_ParseTrack(&data[pos + 8], chunkLen, &order))
+            {
+                Serial.printf("track at %zu is corrupted, using events read so far\n", pos);
+            }
+        }
+        pos += 8 + chunkLen;
+    }
+
+    std::stable_sort(midiEvents.begin(), midiEvents.end(), [](const struct hostMidiEvent_s &a, const struct hostMidiEvent_s &b)
+    {
+        return (a.tick != b.tick) ? (a.tick < b.tick) : (a.order < b.order);
+    });
+
+    /* convert ticks to sample positions, the default tempo is 120 bpm */
+    double samplesPerTick = (500000.0 * SAMPLE_RATE) / (1000000.0 * division);
+    double samplePos = 0;
+    uint64_t lastTick = 0;
+    for (struct hostMidiEvent_s &evt : midiEvents)
+    {
+        samplePos += (evt.tick - lastTick) * samplesPerTick;
+        lastTick = evt.tick;
+        evt.samplePos = (uint64_t)samplePos;
+        if (evt.status == 0xFF)
+        {
+            samplesPerTick = (((double)evt.tempo) * SAMPLE_RATE) / (1000000.0 * division);
+        }
+    }
+
+    midiEventIdx = 0;
+    midiSamplePos = 0;
+
+    Serial.printf("%s: %zu events, %.1f s\n", filename, midiEvents.size(), ((float)samplePos) / SAMPLE_RATE);
+    return true;
+}
+
+bool HostMidi_Done(void)
+{
+    return midiEventIdx >= midiEvents.size();
+}
+
+void Midi_Setup(void)
+{
+}
+
+/*
+ * called once per block like the serial MIDI input on the device
+ * all events of the upcoming block are scheduled at their position before the block will be rendered
+ */
+void Midi_Process(void)
+{
+    uint64_t blockEnd = midiSamplePos + App_GetBlockSize();
+
+    while ((midiEventIdx < midiEvents.size()) && (midiEvents[midiEventIdx].samplePos < blockEnd))
+    {
+        MidiSched_SetOffset(midiEvents[midiEventIdx].samplePos - midiSamplePos);
+        hostMidi_Dispatch(&midiEvents[midiEventIdx]);
+        midiEventIdx++;
+    }
+    MidiSched_SetOffset(0);
+
+    midiSamplePos = blockEnd;
+}
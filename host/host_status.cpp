@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file host_status.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Host stand-in of the status module, all changes are printed to the console
+ */
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include <ml_status.h>
+
+
+/*
+ * extern function definitions
+ */
+void Status_Loop(uint32_t elapsed_ms __attribute__((unused)))
+{
+}
+
+void Status_LoopMain(void)
+{
+}
+
+void Status_ValueChangedFloat(const char *group, const char *descr, float value)
+{
+    Serial.printf("%s - %s: %f\n", group, descr, value);
+}
+
+void Status_ValueChangedInt(const char *group, const char *descr, int value)
+{
+    Serial.printf("%s - %s: %d\n", group, descr, value);
+}
+
+void Status_ValueChangedStr(const char *group, const char *descr, const char *value)
+{
+    Serial.printf("%s - %s: %s\n", group, descr, value);
+}
@@ -0,0 +1,797 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file hot_swap.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Double banked sample memory, new instruments are loaded while the old ones are playing
+ * @n       The sample memory is split into two banks. After a clear (SoundFontSamplerCtrl(0)) the load
+ * @n       job writes the sample data into the bank which is not playing, the regions are recorded.
+ * @n       When all requested jobs are done the recorded samples are added to the sampler by the
+ * @n       audio core (a few per block) behind the playing instruments and the program changes of all
+ * @n       channels are switched to the new instruments at once. Loads without a clear are appended
+ * @n       to the playing bank.
+ * @n       Voices started before the swap keep playing from the old bank. It will be used for the
+ * @n       next load only when the voice allocation does not track any of them anymore, held notes
+ * @n       are released after HOT_SWAP_DRAIN_MS.
+ * @n       The sampler can only remove all samples at once, the entries of the old bank are removed
+ * @n       from the sampler when no voice is active, the playing bank is added again a few
+ * @n       samples per block.
+ * @n       The sampler uses the complete sample memory, all positions are relative to its start.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "hot_swap.h"
+#include "voice_alloc.h"
+#include "app.h"
+
+#include <ml_sampler.h>
+#include <ml_status.h>
+
+
+/*
+ * defines
+ */
+#define HOT_SWAP_COMMIT_CNT     32 /*!< samples added to the sampler per audio block (commit and rebuild) */
+#define HOT_SWAP_DRAIN_MS       10000 /*!< held voices of the old bank will be released after this time */
+#define HOT_SWAP_CH_CNT         16
+
+
+/*
+ * data types
+ */
+enum hot_swap_state_e
+{
+    HOT_SWAP_IDLE,
+    HOT_SWAP_LOADING, /*!< the job writes into a bank */
+    HOT_SWAP_COMMIT, /*!< the audio core adds the loaded samples */
+    HOT_SWAP_COMPACT, /*!< the audio core adds the active bank again to the cleared sampler */
+};
+
+struct hot_swap_op_s
+{
+    bool instrumentDone; /*!< Sampler_InstrumentDone instead of adding the region */
+    struct smpl_region_s region;
+};
+
+struct hot_swap_bank_s
+{
+    uint32_t start; /*!< first sample of the bank within the sample memory */
+    uint32_t size; /*!< samples available */
+    uint32_t used; /*!< samples loaded */
+    uint32_t commitUsed; /*!< samples loaded when the last commit has been started */
+    struct hot_swap_op_s *ops; /*!< kept to add the bank again after removing the old bank */
+    uint32_t opCnt;
+    uint32_t opCap;
+    uint32_t commitPos; /*!< ops added to the sampler */
+    uint32_t instrBase; /*!< sampler index of the first instrument */
+    uint32_t instrCnt; /*!< instruments added to the sampler */
+};
+
+
+/*
+ * static variables
+ */
+#ifdef HOT_SWAP_ACTIVE
+static struct hot_swap_bank_s hotSwapBanks[2];
+static uint32_t hotSwapState = HOT_SWAP_IDLE;
+static bool hotSwapReady = false; /*!< the sampler uses the complete memory and contains only the banks */
+static int32_t hotSwapActive = -1; /*!< bank used by the program changes */
+static int32_t hotSwapDrain = -1; /*!< bank with voices still playing */
+
+/* written by the job only */
+static int32_t hotSwapLoad = -1;
+static bool hotSwapFresh = false; /*!< the loaded bank replaces the active one */
+static uint32_t hotSwapTransferBase = 0;
+static bool hotSwapFull = false;
+static bool hotSwapOpsLost = false;
+
+/* used by the audio core only */
+static bool hotSwapCommitStarted = false;
+static uint32_t hotSwapTableInstrCnt = 0; /*!< instruments in the sampler */
+static uint32_t hotSwapSwapTime = 0; /*!< voice time of the last swap */
+static uint32_t hotSwapSwapMs = 0;
+static bool hotSwapReleased = false;
+static uint8_t hotSwapProgram[HOT_SWAP_CH_CNT];
+static uint32_t hotSwapSwapCnt = 0;
+static uint32_t hotSwapCompactCnt = 0;
+static uint32_t hotSwapRebuildCnt = 0; /*!< ops of the active bank to be added again */
+#endif
+
+
+/*
+ * static function definitions
+ */
+#ifdef HOT_SWAP_ACTIVE
+static uint32_t hotSwap_GetState(void)
+{
+    return __atomic_load_n(&hotSwapState, __ATOMIC_ACQUIRE);
+}
+
+static void hotSwap_SetState(uint32_t state)
+{
+    __atomic_store_n(&hotSwapState, state, __ATOMIC_RELEASE);
+}
+
+static bool hotSwap_TakeState(uint32_t state)
+{
+    uint32_t idle = HOT_SWAP_IDLE;
+    return __atomic_compare_exchange_n(&hotSwapState, &idle, state, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static bool hotSwap_IsReady(void)
+{
+    return __atomic_load_n(&hotSwapReady, __ATOMIC_ACQUIRE);
+}
+
+static Q1_14 *hotSwap_Mem(void)
+{
+    return (Q1_14 *)App_GetSampleMem();
+}
+
+static void hotSwap_FreeOps(struct hot_swap_bank_s *bank)
+{
+    free(bank->ops);
+    bank->ops = NULL;
+    bank->opCnt = 0;
+    bank->opCap = 0;
+    bank->commitPos = 0;
+}
+
+static struct hot_swap_op_s *hotSwap_AddOp(struct hot_swap_bank_s *bank)
+{
+    if (bank->opCnt == bank->opCap)
+    {
+        uint32_t cap = (bank->opCap > 0) ? (bank->opCap * 2) : 64;
+        struct hot_swap_op_s *ops = (struct hot_swap_op_s *)realloc(bank->ops, cap * sizeof(struct hot_swap_op_s));
+        if (ops == NULL)
+        {
+            hotSwapOpsLost = true;
+            return NULL;
+        }
+        bank->ops = ops;
+        bank->opCap = cap;
+    }
+    return &bank->ops[bank->opCnt++];
+}
+
+/*
+ * the job takes a bank for loading, waits until the last commit is done and the old voices have been drained
+ */
+static void hotSwap_Open(bool fresh)
+{
+    if (hotSwap_GetState() == HOT_SWAP_LOADING)
+    {
+        /* opened by a previous job of the same request sequence */
+        if (!fresh || hotSwapFresh)
+        {
+            if (fresh)
+            {
+                struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapLoad];
+                hotSwap_FreeOps(bank);
+                bank->used = 0;
+            }
+            return;
+        }
+        /* the appended samples will be replaced */
+        struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapLoad];
+        bank->opCnt = bank->commitPos;
+        bank->used = bank->commitUsed;
+    }
+    else
+    {
+        while (!hotSwap_TakeState(HOT_SWAP_LOADING))
+        {
+            LoadJob_Yield();
+        }
+    }
+
+    int32_t active = __atomic_load_n(&hotSwapActive, __ATOMIC_ACQUIRE);
+    if (active < 0)
+    {
+        fresh = true;
+        hotSwapLoad = 0;
+    }
+    else
+    {
+        hotSwapLoad = fresh ? (1 - active) : active;
+    }
+    hotSwapFresh = fresh;
+    hotSwapFull = false;
+    hotSwapOpsLost = false;
+
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapLoad];
+    if (fresh)
+    {
+        if (__atomic_load_n(&hotSwapDrain, __ATOMIC_ACQUIRE) == hotSwapLoad)
+        {
+            Serial.printf("hot swap: waiting for the voices of bank %" PRId32 "\n", hotSwapLoad);
+            while (__atomic_load_n(&hotSwapDrain, __ATOMIC_ACQUIRE) == hotSwapLoad)
+            {
+                LoadJob_Yield();
+            }
+        }
+        hotSwap_FreeOps(bank);
+        bank->used = 0;
+    }
+    bank->commitUsed = bank->used;
+}
+
+/*
+ * returns the memory for the next samples of the loaded bank or NULL when it is full
+ */
+static Q1_14 *hotSwap_Reserve(uint32_t cnt)
+{
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapLoad];
+    if (bank->used + cnt > bank->size)
+    {
+        if (!hotSwapFull)
+        {
+            Serial.printf("hot swap: bank %" PRId32 " is full (%" PRIu32 " kB)\n", hotSwapLoad, (bank->size * 2) / 1024);
+            hotSwapFull = true;
+        }
+        return NULL;
+    }
+
+    Q1_14 *dst = &hotSwap_Mem()[bank->start + bank->used];
+    bank->used += cnt;
+    return dst;
+}
+
+/*
+ * selects the instruments of the active bank on all channels
+ */
+static void hotSwap_SelectPrograms(void)
+{
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapActive];
+
+    for (uint8_t ch = 0; ch < HOT_SWAP_CH_CNT; ch++)
+    {
+        uint32_t instr = bank->instrBase + hotSwapProgram[ch];
+        if ((hotSwapProgram[ch] < bank->instrCnt) && (instr <= 0xFF))
+        {
+            Sampler_ProgramChange(ch, instr);
+        }
+    }
+}
+
+static void hotSwap_CommitOp(struct hot_swap_bank_s *bank)
+{
+    struct hot_swap_op_s *op = &bank->ops[bank->commitPos++];
+    if (op->instrumentDone)
+    {
+        Sampler_InstrumentDone();
+        bank->instrCnt++;
+        hotSwapTableInstrCnt++;
+    }
+    else
+    {
+        SmplBank_AddSample(&op->region);
+    }
+}
+
+/*
+ * the sampler will contain the active bank only, no voice may be active
+ * the sampler can only be cleared completely, the samples are added again by hotSwap_RebuildStep
+ */
+static void hotSwap_RebuildStart(void)
+{
+    Sampler_ClearAllSamples();
+    VoiceAlloc_ClearExclusiveClasses();
+    Sampler_UseStaticBuffer(hotSwap_Mem(), App_GetSampleMemSize() / sizeof(Q1_14));
+    Sampler_StartTransfer();
+    Sampler_EndTransfer();
+    hotSwapTableInstrCnt = 0;
+
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapActive];
+    hotSwapRebuildCnt = bank->commitPos;
+
+    hotSwapBanks[1 - hotSwapActive].instrCnt = 0;
+
+    bank->instrBase = 0;
+    bank->instrCnt = 0;
+    bank->commitPos = 0;
+}
+
+/*
+ * adds up to HOT_SWAP_COMMIT_CNT samples of the active bank per block
+ * the programs of the channels are selected as soon as their instruments are available again
+ */
+static void hotSwap_RebuildStep(void)
+{
+    if (!hotSwap_IsReady() || (hotSwapActive < 0))
+    {
+        /* the banks have been reset in between */
+        hotSwap_SetState(HOT_SWAP_IDLE);
+        return;
+    }
+
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapActive];
+
+    for (uint32_t i = 0; (i < HOT_SWAP_COMMIT_CNT) && (bank->commitPos < hotSwapRebuildCnt); i++)
+    {
+        hotSwap_CommitOp(bank);
+    }
+    hotSwap_SelectPrograms();
+
+    if (bank->commitPos < hotSwapRebuildCnt)
+    {
+        return;
+    }
+
+    hotSwapCompactCnt++;
+    hotSwap_SetState(HOT_SWAP_IDLE);
+}
+
+/*
+ * adds the loaded samples spread over a few blocks, switches to the new bank afterwards
+ */
+static void hotSwap_Commit(void)
+{
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapLoad];
+
+    if (!hotSwap_IsReady())
+    {
+        Serial.printf("hot swap: bank dropped, the sample memory has been used otherwise\n");
+        hotSwap_FreeOps(bank);
+        hotSwap_SetState(HOT_SWAP_IDLE);
+        return;
+    }
+
+    if (!hotSwapCommitStarted)
+    {
+        if (hotSwapFresh)
+        {
+            VoiceAlloc_ClearExclusiveClasses();
+            bank->instrBase = hotSwapTableInstrCnt;
+            bank->instrCnt = 0;
+        }
+        hotSwapCommitStarted = true;
+    }
+
+    for (uint32_t i = 0; (i < HOT_SWAP_COMMIT_CNT) && (bank->commitPos < bank->opCnt); i++)
+    {
+        hotSwap_CommitOp(bank);
+    }
+
+    if (bank->commitPos < bank->opCnt)
+    {
+        return;
+    }
+
+    if (hotSwapFresh && (hotSwapActive >= 0) && (hotSwapActive != hotSwapLoad))
+    {
+        hotSwapSwapTime = VoiceAlloc_GetTime();
+        hotSwapSwapMs = millis();
+        hotSwapReleased = false;
+        __atomic_store_n(&hotSwapDrain, hotSwapActive, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&hotSwapActive, hotSwapLoad, __ATOMIC_RELEASE);
+    hotSwap_SelectPrograms();
+
+    hotSwapCommitStarted = false;
+    hotSwap_SetState(HOT_SWAP_IDLE);
+    if (hotSwapFresh)
+    {
+        hotSwapSwapCnt++;
+        Status_ValueChangedInt("Hot swap", "Bank", hotSwapActive);
+    }
+}
+
+/*
+ * the old bank can be reused when none of its voices is tracked anymore
+ */
+static void hotSwap_CheckDrain(void)
+{
+    if (hotSwapDrain < 0)
+    {
+        return;
+    }
+
+    if (VoiceAlloc_GetActiveCntBefore(hotSwapSwapTime) == 0)
+    {
+        __atomic_store_n(&hotSwapDrain, -1, __ATOMIC_RELEASE);
+    }
+    else if (!hotSwapReleased && (millis() - hotSwapSwapMs > HOT_SWAP_DRAIN_MS))
+    {
+        VoiceAlloc_ReleaseBefore(hotSwapSwapTime);
+        hotSwapReleased = true;
+    }
+}
+#endif
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * replaces the clear of the sample memory by loading into the other bank, to be called by the job
+ * returns false when the sample memory must be cleared (HotSwap_Reset will be called then)
+ */
+bool HotSwap_Clear(void)
+{
+#ifdef HOT_SWAP_ACTIVE
+    if (LoadJob_InJob() && hotSwap_IsReady())
+    {
+        hotSwap_Open(true);
+        return true;
+    }
+#endif
+    return false;
+}
+
+/*
+ * to be called by the audio core after the sample memory has been cleared
+ * the sampler will use the complete memory split into the two banks
+ */
+void HotSwap_Reset(void)
+{
+#ifdef HOT_SWAP_ACTIVE
+    uint32_t cnt = App_GetSampleMemSize() / sizeof(Q1_14);
+
+    for (int i = 0; i < 2; i++)
+    {
+        hotSwap_FreeOps(&hotSwapBanks[i]);
+        hotSwapBanks[i].used = 0;
+        hotSwapBanks[i].instrCnt = 0;
+    }
+    hotSwapBanks[0].start = 0;
+    hotSwapBanks[0].size = cnt / 2;
+    hotSwapBanks[1].start = cnt / 2;
+    hotSwapBanks[1].size = cnt - cnt / 2;
+
+    hotSwapActive = -1;
+    hotSwapDrain = -1;
+    hotSwapCommitStarted = false;
+
+    Sampler_UseStaticBuffer(hotSwap_Mem(), cnt);
+    Sampler_StartTransfer();
+    Sampler_EndTransfer();
+    hotSwapTableInstrCnt = 0;
+
+    __atomic_store_n(&hotSwapReady, true, __ATOMIC_RELEASE);
+#endif
+}
+
+/*
+ * to be called by the audio core when the sample memory will be used without the banks
+ */
+void HotSwap_Invalidate(void)
+{
+#ifdef HOT_SWAP_ACTIVE
+    __atomic_store_n(&hotSwapReady, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&hotSwapActive, -1, __ATOMIC_RELEASE);
+    __atomic_store_n(&hotSwapDrain, -1, __ATOMIC_RELEASE);
+#endif
+}
+
+/*
+ * to be called by the job when no other job is requested, the loaded bank will be added
+ */
+void HotSwap_LoadDone(void)
+{
+#ifdef HOT_SWAP_ACTIVE
+    if (!HotSwap_IsLoading())
+    {
+        return;
+    }
+
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapLoad];
+    if ((bank->opCnt > bank->commitPos) && !bank->ops[bank->opCnt - 1].instrumentDone)
+    {
+        struct hot_swap_op_s *op = hotSwap_AddOp(bank);
+        if (op != NULL)
+        {
+            op->instrumentDone = true;
+        }
+    }
+    if (hotSwapOpsLost)
+    {
+        Serial.printf("hot swap: not enough memory, samples are missing\n");
+    }
+    Serial.printf("hot swap: bank %" PRId32 " %s, %" PRIu32 " kB, %" PRIu32 " samples to add\n", hotSwapLoad,
+                  hotSwapFresh ? "loaded" : "appended", (bank->used * 2) / 1024, bank->opCnt - bank->commitPos);
+
+    hotSwap_SetState(HOT_SWAP_COMMIT);
+#endif
+}
+
+/*
+ * to be called by the audio core at the start of each block before the MIDI processing
+ */
+void HotSwap_Process(void)
+{
+#ifdef HOT_SWAP_ACTIVE
+    if (hotSwap_GetState() == HOT_SWAP_COMMIT)
+    {
+        hotSwap_Commit();
+    }
+    else if (hotSwap_GetState() == HOT_SWAP_COMPACT)
+    {
+        hotSwap_RebuildStep();
+    }
+
+    hotSwap_CheckDrain();
+
+    if (hotSwap_IsReady() && (hotSwapActive >= 0) && (hotSwapBanks[hotSwapActive].instrBase > 0)
+        && (hotSwapDrain < 0) && (VoiceAlloc_GetActiveCnt() == 0) && hotSwap_TakeState(HOT_SWAP_COMPACT))
+    {
+        /* nothing is audible, the instruments of the old bank can be removed */
+        hotSwap_RebuildStart();
+        hotSwap_RebuildStep();
+    }
+#endif
+}
+
+/*
+ * selects the instrument of the active bank, returns false when the banks are not used
+ */
+bool HotSwap_ProgramChange(uint8_t ch, uint8_t program)
+{
+#ifdef HOT_SWAP_ACTIVE
+    if (!hotSwap_IsReady() || (hotSwapActive < 0))
+    {
+        return false;
+    }
+
+    hotSwapProgram[ch % HOT_SWAP_CH_CNT] = program;
+
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapActive];
+    if ((program < bank->instrCnt) && (bank->instrBase + program <= 0xFF))
+    {
+        Sampler_ProgramChange(ch, bank->instrBase + program);
+    }
+    return true;
+#else
+    (void)ch;
+    (void)program;
+    return false;
+#endif
+}
+
+/*
+ * serial command: "swap" prints the state of the banks
+ */
+void HotSwap_Cmd(const char *args)
+{
+    (void)args;
+#ifdef HOT_SWAP_ACTIVE
+    static const char *stateNames[] = { "idle", "loading", "commit", "compact" };
+
+    if (!hotSwap_IsReady())
+    {
+        Serial.printf("hot swap: not used (the next clear will prepare the banks)\n");
+        return;
+    }
+
+    Serial.printf("hot swap: %s, active bank %" PRId32 ", %" PRIu32 " swaps, %" PRIu32 " compactions\n",
+                  stateNames[hotSwap_GetState()], hotSwapActive, hotSwapSwapCnt, hotSwapCompactCnt);
+    for (int i = 0; i < 2; i++)
+    {
+        struct hot_swap_bank_s *bank = &hotSwapBanks[i];
+        Serial.printf("  bank %d: %" PRIu32 " of %" PRIu32 " kB, %" PRIu32 " instruments from %" PRIu32 "%s\n", i,
+                      (bank->used * 2) / 1024, (bank->size * 2) / 1024, bank->instrCnt, bank->instrBase,
+                      (hotSwapDrain == i) ? ", draining" : "");
+    }
+    if (hotSwapDrain >= 0)
+    {
+        Serial.printf("  %" PRIu32 " voices of the old bank\n", VoiceAlloc_GetActiveCntBefore(hotSwapSwapTime));
+    }
+#else
+    Serial.printf("hot swap not available (HOT_SWAP_ENABLED and a load job are required)\n");
+#endif
+}
+
+/*
+ * the samples of the job will be written into the bank, returns true when the transfer belongs to the bank
+ */
+bool HotSwap_TransferStart(void)
+{
+#ifdef HOT_SWAP_ACTIVE
+    if (!LoadJob_InJob() || !hotSwap_IsReady())
+    {
+        return false;
+    }
+    if (hotSwap_GetState() != HOT_SWAP_LOADING)
+    {
+        hotSwap_Open(false);
+    }
+    hotSwapTransferBase = hotSwapBanks[hotSwapLoad].used;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool HotSwap_TransferEnd(void)
+{
+    return HotSwap_IsLoading();
+}
+
+bool HotSwap_IsLoading(void)
+{
+#ifdef HOT_SWAP_ACTIVE
+    return LoadJob_InJob() && (hotSwap_GetState() == HOT_SWAP_LOADING);
+#else
+    return false;
+#endif
+}
+
+/*
+ * gets the samples left in the bank the next transfer of the job will be written to
+ * returns false when the transfer will not use the banks
+ */
+bool HotSwap_GetFree(uint32_t *cnt)
+{
+#ifdef HOT_SWAP_ACTIVE
+    if (!LoadJob_InJob() || !hotSwap_IsReady())
+    {
+        return false;
+    }
+
+    struct hot_swap_bank_s *bank;
+    if (hotSwap_GetState() == HOT_SWAP_LOADING)
+    {
+        bank = &hotSwapBanks[hotSwapLoad];
+    }
+    else
+    {
+        /* see hotSwap_Open, the samples will be appended to the active bank */
+        int32_t active = __atomic_load_n(&hotSwapActive, __ATOMIC_ACQUIRE);
+        if (active < 0)
+        {
+            *cnt = hotSwapBanks[0].size;
+            return true;
+        }
+        bank = &hotSwapBanks[active];
+    }
+    *cnt = bank->size - bank->used;
+    return true;
+#else
+    (void)cnt;
+    return false;
+#endif
+}
+
+/*
+ * returns the memory for the next samples of the bank, to be filled by the caller (no copy)
+ * returns NULL when the bank is full or not used
+ */
+Q1_14 *HotSwap_ReserveSamples(uint32_t cnt)
+{
+#ifdef HOT_SWAP_ACTIVE
+    return hotSwap_Reserve(cnt);
+#else
+    (void)cnt;
+    return NULL;
+#endif
+}
+
+bool HotSwap_AddSamples(const Q1_14 *samples, uint32_t cnt)
+{
+#ifdef HOT_SWAP_ACTIVE
+    Q1_14 *dst = hotSwap_Reserve(cnt);
+    if (dst == NULL)
+    {
+        return false;
+    }
+    memcpy(dst, samples, cnt * sizeof(Q1_14));
+    return true;
+#else
+    (void)samples;
+    (void)cnt;
+    return false;
+#endif
+}
+
+/*
+ * converts unsigned 8 bit samples to the full scale of the 16 bit samples
+ */
+bool HotSwap_AddSamplesU8(const uint8_t *samples, uint32_t cnt)
+{
+#ifdef HOT_SWAP_ACTIVE
+    Q1_14 *dst = hotSwap_Reserve(cnt);
+    if (dst == NULL)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        dst[i].s16 = (int16_t)(((int32_t)samples[i] - 128) * 256);
+    }
+    return true;
+#else
+    (void)samples;
+    (void)cnt;
+    return false;
+#endif
+}
+
+/*
+ * records the region to be added by the audio core, returns false when not loading into a bank
+ */
+bool HotSwap_AddRegion(const struct smpl_region_s *region)
+{
+#ifdef HOT_SWAP_ACTIVE
+    if (!HotSwap_IsLoading())
+    {
+        return false;
+    }
+
+    struct hot_swap_bank_s *bank = &hotSwapBanks[hotSwapLoad];
+    struct hot_swap_op_s *op = hotSwap_AddOp(bank);
+    if (op != NULL)
+    {
+        uint32_t base = bank->start + hotSwapTransferBase;
+
+        op->instrumentDone = false;
+        op->region = *region;
+        op->region.start += base;
+        op->region.end += base;
+        op->region.loopStart += base;
+        op->region.loopEnd += base;
+    }
+    return true;
+#else
+    (void)region;
+    return false;
+#endif
+}
+
+bool HotSwap_InstrumentDone(void)
+{
+#ifdef HOT_SWAP_ACTIVE
+    if (!HotSwap_IsLoading())
+    {
+        return false;
+    }
+
+    struct hot_swap_op_s *op = hotSwap_AddOp(&hotSwapBanks[hotSwapLoad]);
+    if (op != NULL)
+    {
+        op->instrumentDone = true;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file hot_swap.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Double banked sample memory, new instruments are loaded while the old ones are playing
+ * @n       See hot_swap.cpp
+ */
+
+
+#ifndef HOT_SWAP_H_
+#define HOT_SWAP_H_
+
+
+/*
+ * includes
+ */
+#include "config.h"
+#include "load_job.h"
+#include "smpl_bank.h"
+
+#include <ml_types.h>
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#if (defined HOT_SWAP_ENABLED) && (defined LOAD_JOB_ACTIVE)
+#define HOT_SWAP_ACTIVE /*!< the load job loads into the bank which is not playing */
+#endif
+
+
+/*
+ * declarations
+ */
+bool HotSwap_Clear(void);
+void HotSwap_Reset(void);
+void HotSwap_Invalidate(void);
+void HotSwap_LoadDone(void);
+void HotSwap_Process(void);
+bool HotSwap_ProgramChange(uint8_t ch, uint8_t program);
+void HotSwap_Cmd(const char *args);
+
+/* called by the sample transfer and the sample bank */
+bool HotSwap_TransferStart(void);
+bool HotSwap_TransferEnd(void);
+bool HotSwap_IsLoading(void);
+bool HotSwap_GetFree(uint32_t *cnt);
+Q1_14 *HotSwap_ReserveSamples(uint32_t cnt);
+bool HotSwap_AddSamples(const Q1_14 *samples, uint32_t cnt);
+bool HotSwap_AddSamplesU8(const uint8_t *samples, uint32_t cnt);
+bool HotSwap_AddRegion(const struct smpl_region_s *region);
+bool HotSwap_InstrumentDone(void);
+
+
+#endif /* HOT_SWAP_H_ */
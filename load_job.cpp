@@ -0,0 +1,498 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file load_job.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Loading of sample data as job on the second core
+ * @n       SoundFontSamplerCtrl requested by the MIDI callbacks will be executed by App_Loop1 on the
+ * @n       second core, the audio core keeps rendering the samples loaded before.
+ * @n       The sample data is added by the job (one transfer for the whole job), it is written behind
+ * @n       the samples in use. The samples and instruments are added to the sampler by the audio core
+ * @n       at the start of its blocks (LoadJob_Process) when the job has been finished, so the tables
+ * @n       of the sampler are never changed while the audio core uses them.
+ * @n       Operations like clearing the sample memory are passed to the audio core by LoadJob_Sync.
+ * @n       While the job is running the other tasks of App_Loop1 are called after each transferred
+ * @n       block (LoadJob_Yield), the serial commands wait until the job has been finished.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "load_job.h"
+#include "smpl_bank.h"
+#include "hot_swap.h"
+#include "smpl_arena.h"
+#include "load_step.h"
+#include "app.h"
+
+#include <ml_sampler.h>
+#include <ml_status.h>
+
+
+/*
+ * defines
+ */
+#define LOAD_JOB_COMMIT_CNT     32 /*!< samples added to the sampler per audio block */
+#define LOAD_JOB_PROGRESS_KB    512 /*!< progress will be printed after each step */
+#define LOAD_JOB_YIELD_MS       2 /*!< interval of serving the other tasks of the second core */
+#define LOAD_JOB_QUEUE_SIZE     8 /*!< must be a power of two */
+
+
+/*
+ * data types
+ */
+enum load_job_state_e
+{
+    LOAD_JOB_IDLE,
+    LOAD_JOB_RUNNING, /*!< the job is executed by the second core */
+    LOAD_JOB_COMMIT, /*!< the audio core adds the loaded samples */
+};
+
+struct load_job_req_s
+{
+    int ctrl;
+    uint32_t seq; /*!< position + 1 when written */
+};
+
+struct load_job_op_s
+{
+    bool instrumentDone; /*!< Sampler_InstrumentDone instead of adding the region */
+    struct smpl_region_s region;
+};
+
+
+/*
+ * static variables
+ */
+#ifdef LOAD_JOB_ACTIVE
+/* requests can be added from both cores, a slot is reserved by incrementing the head when it is free */
+static struct load_job_req_s loadJobQueue[LOAD_JOB_QUEUE_SIZE];
+static uint32_t loadJobQueueHead = 0;
+static uint32_t loadJobQueueTail = 0; /*!< written by the job only */
+static uint32_t loadJobState = LOAD_JOB_IDLE;
+static void (*loadJobSyncFn)(void) = NULL; /*!< function to be executed by the audio core */
+
+static int loadJobCtrl = -1;
+static uint32_t loadJobCore = 0;
+static uint32_t loadJobStartMs = 0;
+static bool loadJobTransfer = false;
+static uint32_t loadJobPcmCnt = 0; /*!< samples added by the job */
+static uint32_t loadJobBase = 0; /*!< position of the current transfer of the loader within the job */
+static uint32_t loadJobProgress = 0;
+static uint32_t loadJobYieldMs = 0;
+
+static struct load_job_op_s *loadJobOps = NULL;
+static uint32_t loadJobOpCnt = 0;
+static uint32_t loadJobOpCap = 0;
+static uint32_t loadJobCommitPos = 0;
+static bool loadJobOpsLost = false;
+#endif
+
+
+/*
+ * static function definitions
+ */
+#ifdef LOAD_JOB_ACTIVE
+static uint32_t loadJob_CoreId(void)
+{
+#ifdef ESP32
+    return xPortGetCoreID();
+#else
+    return rp2040.cpuid();
+#endif
+}
+
+static uint32_t loadJob_GetState(void)
+{
+    return __atomic_load_n(&loadJobState, __ATOMIC_ACQUIRE);
+}
+
+static void loadJob_SetState(uint32_t state)
+{
+    __atomic_store_n(&loadJobState, state, __ATOMIC_RELEASE);
+}
+
+/*
+ * true when called by the running job, calls of the audio core will not be deferred
+ */
+static bool loadJob_Deferring(void)
+{
+    return (loadJob_GetState() == LOAD_JOB_RUNNING) && (loadJob_CoreId() == loadJobCore);
+}
+
+static struct load_job_op_s *loadJob_AddOp(void)
+{
+    if (loadJobOpCnt == loadJobOpCap)
+    {
+        uint32_t cap = (loadJobOpCap > 0) ? (loadJobOpCap * 2) : 64;
+        struct load_job_op_s *ops = (struct load_job_op_s *)realloc(loadJobOps, cap * sizeof(struct load_job_op_s));
+        if (ops == NULL)
+        {
+            loadJobOpsLost = true;
+            return NULL;
+        }
+        loadJobOps = ops;
+        loadJobOpCap = cap;
+    }
+    return &loadJobOps[loadJobOpCnt++];
+}
+
+static void loadJob_FreeOps(void)
+{
+    free(loadJobOps);
+    loadJobOps = NULL;
+    loadJobOpCnt = 0;
+    loadJobOpCap = 0;
+    loadJobCommitPos = 0;
+}
+#endif
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * requests SoundFontSamplerCtrl(ctrl), executed in steps by the audio core without a second core
+ * the requests are executed in order of arrival, returns false when the request has been dropped
+ */
+bool LoadJob_Request(int ctrl)
+{
+#ifdef LOAD_JOB_ACTIVE
+    uint32_t tail;
+    uint32_t pos = __atomic_load_n(&loadJobQueueHead, __ATOMIC_ACQUIRE);
+    do
+    {
+        /* the capacity is checked again when another request took the slot in between */
+        tail = __atomic_load_n(&loadJobQueueTail, __ATOMIC_ACQUIRE);
+        if (pos - tail >= LOAD_JOB_QUEUE_SIZE)
+        {
+            Serial.printf("load %d dropped, too many requests\n", ctrl);
+            return false;
+        }
+    }
+    while (!__atomic_compare_exchange_n(&loadJobQueueHead, &pos, pos + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    struct load_job_req_s *req = &loadJobQueue[pos & (LOAD_JOB_QUEUE_SIZE - 1)];
+    req->ctrl = ctrl;
+    __atomic_store_n(&req->seq, pos + 1, __ATOMIC_RELEASE);
+
+    if ((pos != tail) || (loadJob_GetState() != LOAD_JOB_IDLE))
+    {
+        Serial.printf("load %d queued\n", ctrl);
+    }
+    return true;
+#else
+    return LoadStep_Request(ctrl);
+#endif
+}
+
+bool LoadJob_IsBusy(void)
+{
+#ifdef LOAD_JOB_ACTIVE
+    return loadJob_GetState() != LOAD_JOB_IDLE;
+#else
+    return LoadStep_IsBusy();
+#endif
+}
+
+/*
+ * true when called by the running job
+ */
+bool LoadJob_InJob(void)
+{
+#ifdef LOAD_JOB_ACTIVE
+    return loadJob_Deferring();
+#else
+    return false;
+#endif
+}
+
+/*
+ * keeps the other tasks of the second core running, to be called by the job while waiting
+ */
+void LoadJob_Yield(void)
+{
+#ifdef LOAD_JOB_ACTIVE
+    /* not App_Loop1, a serial command could close the file of the job */
+    App_Loop1Yield();
+    delay(1);
+    loadJobYieldMs = millis();
+#endif
+}
+
+/*
+ * executes fn by the audio core between two blocks, used for changes which would disturb the playback
+ * the job waits until fn has been executed
+ */
+void LoadJob_Sync(void (*fn)(void))
+{
+#ifdef LOAD_JOB_ACTIVE
+    if (loadJob_Deferring())
+    {
+        __atomic_store_n(&loadJobSyncFn, fn, __ATOMIC_RELEASE);
+        while (__atomic_load_n(&loadJobSyncFn, __ATOMIC_ACQUIRE) != NULL)
+        {
+            LoadJob_Yield();
+        }
+        return;
+    }
+#endif
+    fn();
+}
+
+/*
+ * to be called from App_Loop1, executes a requested job
+ */
+void LoadJob_Loop1(void)
+{
+#ifdef LOAD_JOB_ACTIVE
+    /* also returns when called by loadJob_Yield */
+    if (loadJob_GetState() != LOAD_JOB_IDLE)
+    {
+        return;
+    }
+
+    uint32_t tail = loadJobQueueTail;
+    struct load_job_req_s *req = &loadJobQueue[tail & (LOAD_JOB_QUEUE_SIZE - 1)];
+    if (__atomic_load_n(&req->seq, __ATOMIC_ACQUIRE) != tail + 1)
+    {
+        /* empty or not completely written */
+        return;
+    }
+    int ctrl = req->ctrl;
+    __atomic_store_n(&loadJobQueueTail, tail + 1, __ATOMIC_RELEASE);
+
+    loadJobCtrl = ctrl;
+    loadJobCore = loadJob_CoreId();
+    loadJobStartMs = millis();
+    loadJobTransfer = false;
+    loadJobPcmCnt = 0;
+    loadJobBase = 0;
+    loadJobProgress = 0;
+    loadJobYieldMs = loadJobStartMs;
+    loadJobOpsLost = false;
+    loadJob_SetState(LOAD_JOB_RUNNING);
+
+    SoundFontSamplerCtrl(ctrl);
+    SmplArena_LoadDone();
+
+    if (loadJobTransfer)
+    {
+        Sampler_EndTransfer();
+    }
+    if (__atomic_load_n(&loadJobQueueHead, __ATOMIC_ACQUIRE) == loadJobQueueTail)
+    {
+        /* all requested jobs are done, a new bank of the hot swap is complete */
+        HotSwap_LoadDone();
+    }
+    if (loadJobOpsLost)
+    {
+        Serial.printf("load %d: not enough memory, samples are missing\n", ctrl);
+    }
+    Serial.printf("load %d: %" PRIu32 " kB in %" PRIu32 " ms, %" PRIu32 " samples to add\n",
+                  ctrl, (loadJobPcmCnt * 2) / 1024, millis() - loadJobStartMs, loadJobOpCnt);
+
+    loadJob_SetState(LOAD_JOB_COMMIT);
+#endif
+}
+
+/*
+ * to be called by the audio core at the start of each block before the MIDI processing
+ */
+void LoadJob_Process(void)
+{
+#ifdef LOAD_JOB_ACTIVE
+    void (*fn)(void) = __atomic_load_n(&loadJobSyncFn, __ATOMIC_ACQUIRE);
+    if (fn != NULL)
+    {
+        fn();
+        __atomic_store_n(&loadJobSyncFn, (void (*)(void))NULL, __ATOMIC_RELEASE);
+    }
+
+    if (loadJob_GetState() != LOAD_JOB_COMMIT)
+    {
+        return;
+    }
+
+    /* spread over a few blocks to keep the block in time */
+    for (uint32_t i = 0; (i < LOAD_JOB_COMMIT_CNT) && (loadJobCommitPos < loadJobOpCnt); i++)
+    {
+        struct load_job_op_s *op = &loadJobOps[loadJobCommitPos++];
+        if (op->instrumentDone)
+        {
+            Sampler_InstrumentDone();
+        }
+        else
+        {
+            SmplBank_AddSample(&op->region);
+        }
+    }
+
+    if (loadJobCommitPos >= loadJobOpCnt)
+    {
+        loadJob_FreeOps();
+        loadJob_SetState(LOAD_JOB_IDLE);
+        Status_ValueChangedInt("Load job", "Done", loadJobCtrl);
+    }
+#endif
+}
+
+/*
+ * serial command: "load" prints the state, "load <n>" requests SoundFontSamplerCtrl(n)
+ */
+void LoadJob_Cmd(const char *args)
+{
+    if (args[0] != 0)
+    {
+        LoadJob_Request(atoi(args));
+        return;
+    }
+
+#ifdef LOAD_JOB_ACTIVE
+    static const char *stateNames[] = { "idle", "running", "commit" };
+    uint32_t state = loadJob_GetState();
+    Serial.printf("load job: %s", stateNames[state]);
+    if (state != LOAD_JOB_IDLE)
+    {
+        Serial.printf(" (%d), %" PRIu32 " kB, %" PRIu32 " of %" PRIu32 " samples added", loadJobCtrl, (loadJobPcmCnt * 2) / 1024,
+                      loadJobCommitPos, loadJobOpCnt);
+    }
+    Serial.printf("\n");
+#else
+    LoadStep_PrintState();
+#endif
+}
+
+/*
+ * all transfers of the job are merged into one transfer, ended when the job has finished
+ * returns true when the transfer belongs to the job
+ */
+bool LoadJob_TransferStart(void)
+{
+#ifdef LOAD_JOB_ACTIVE
+    if (loadJob_Deferring())
+    {
+        if (!loadJobTransfer)
+        {
+            Sampler_StartTransfer();
+            loadJobTransfer = true;
+        }
+        loadJobBase = loadJobPcmCnt;
+        return true;
+    }
+#endif
+    return false;
+}
+
+bool LoadJob_TransferEnd(void)
+{
+#ifdef LOAD_JOB_ACTIVE
+    return loadJob_Deferring();
+#else
+    return false;
+#endif
+}
+
+/*
+ * counts the added samples, the other tasks of the second core are served here
+ */
+void LoadJob_Samples(uint32_t cnt)
+{
+#ifdef LOAD_JOB_ACTIVE
+    if (loadJob_Deferring())
+    {
+        loadJobPcmCnt += cnt;
+        if ((loadJobPcmCnt * 2) / 1024 >= loadJobProgress + LOAD_JOB_PROGRESS_KB)
+        {
+            loadJobProgress = (loadJobPcmCnt * 2) / 1024;
+            Serial.printf("load %d: %" PRIu32 " kB\n", loadJobCtrl, loadJobProgress);
+        }
+        if (millis() - loadJobYieldMs >= LOAD_JOB_YIELD_MS)
+        {
+            LoadJob_Yield();
+        }
+    }
+#else
+    (void)cnt;
+#endif
+}
+
+/*
+ * stores the region to be added by the audio core, returns false when not called by the job
+ */
+bool LoadJob_DeferRegion(const struct smpl_region_s *region)
+{
+#ifdef LOAD_JOB_ACTIVE
+    if (loadJob_Deferring())
+    {
+        struct load_job_op_s *op = loadJob_AddOp();
+        if (op != NULL)
+        {
+            op->instrumentDone = false;
+            op->region = *region;
+            op->region.start += loadJobBase;
+            op->region.end += loadJobBase;
+            op->region.loopStart += loadJobBase;
+            op->region.loopEnd += loadJobBase;
+        }
+        return true;
+    }
+#else
+    (void)region;
+#endif
+    return false;
+}
+
+bool LoadJob_DeferInstrumentDone(void)
+{
+#ifdef LOAD_JOB_ACTIVE
+    if (loadJob_Deferring())
+    {
+        struct load_job_op_s *op = loadJob_AddOp();
+        if (op != NULL)
+        {
+            op->instrumentDone = true;
+        }
+        return true;
+    }
+#endif
+    return false;
+}
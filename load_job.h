@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file load_job.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Loading of sample data as job on the second core
+ * @n       See load_job.cpp
+ */
+
+
+#ifndef LOAD_JOB_H_
+#define LOAD_JOB_H_
+
+
+/*
+ * includes
+ */
+#include "config.h"
+#include "dual_render.h"
+#include "smpl_bank.h"
+
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#if (((defined ESP32) && (SOC_CPU_CORES_NUM > 1)) || (defined ARDUINO_ARCH_RP2040)) && !(defined DUAL_RENDER_ACTIVE)
+#define LOAD_JOB_ACTIVE /*!< SoundFontSamplerCtrl will be executed by the second core */
+#endif
+
+
+/*
+ * declarations
+ */
+bool LoadJob_Request(int ctrl);
+bool LoadJob_IsBusy(void);
+bool LoadJob_InJob(void);
+void LoadJob_Yield(void);
+void LoadJob_Sync(void (*fn)(void));
+void LoadJob_Loop1(void);
+void LoadJob_Process(void);
+void LoadJob_Cmd(const char *args);
+
+/* called by the sample transfer and the sample bank */
+bool LoadJob_TransferStart(void);
+bool LoadJob_TransferEnd(void);
+void LoadJob_Samples(uint32_t cnt);
+bool LoadJob_DeferRegion(const struct smpl_region_s *region);
+bool LoadJob_DeferInstrumentDone(void);
+
+
+#endif /* LOAD_JOB_H_ */
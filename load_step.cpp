@@ -0,0 +1,655 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file load_step.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Loading of sample data in steps by App_Loop on boards without a load job
+ * @n       SoundFontSamplerCtrl requested by LoadJob_Request is executed by App_Loop. The loaders
+ * @n       only parse the headers of their file, the positions of the sample data and the regions
+ * @n       are recorded in a plan (one per file, see LoadStep_FileBegin).
+ * @n       The plans are executed by the following calls of LoadStep_Process, each call reads
+ * @n       LOAD_STEP_BYTES from the file or adds LOAD_STEP_OPS samples to the sampler.
+ * @n       Audio and MIDI keep running, the samples loaded before can be played.
+ * @n       Loaders without LoadStep_FileBegin are executed at once like before.
+ * @n       Parsing the headers of a large soundfont takes longer than a block, the parser calls
+ * @n       LoadStep_Yield which renders the due blocks in between (App_Loop is entered again).
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "load_step.h"
+#include "smpl_snapshot.h"
+#include "smpl_arena.h"
+#include "app.h"
+#include "perf_mon.h"
+
+#include <ml_sampler.h>
+#include <ml_status.h>
+
+
+/*
+ * defines
+ */
+#define LOAD_STEP_BYTES         1024 /*!< read from the file per step, must be a multiple of 4 */
+#define LOAD_STEP_OPS           32 /*!< samples added to the sampler per step */
+#define LOAD_STEP_QUEUE_SIZE    8
+#define LOAD_STEP_NAME_LEN      64
+
+
+/*
+ * data types
+ */
+enum load_step_state_e
+{
+    LOAD_STEP_IDLE,
+    LOAD_STEP_TRANSFER, /*!< the sample data is read from the file */
+    LOAD_STEP_APPLY, /*!< the recorded samples are added to the sampler */
+};
+
+struct load_step_range_s
+{
+    uint32_t offset; /*!< position in the file */
+    uint32_t byteCnt;
+    uint8_t *data; /*!< samples passed by the loader instead of reading the file */
+    enum sample_transfer_fmt_e fmt;
+};
+
+struct load_step_op_s
+{
+    bool instrumentDone; /*!< Sampler_InstrumentDone instead of adding the region */
+    struct smpl_region_s region;
+};
+
+struct load_step_plan_s
+{
+    struct load_step_plan_s *next;
+    fs_id_t fsId;
+    char filename[LOAD_STEP_NAME_LEN];
+    struct load_step_range_s *ranges;
+    uint32_t rangeCnt;
+    uint32_t rangeCap;
+    struct load_step_op_s *ops;
+    uint32_t opCnt;
+    uint32_t opCap;
+    uint32_t pcmCnt; /*!< samples of all ranges */
+};
+
+
+/*
+ * static variables
+ */
+#ifdef LOAD_STEP_ACTIVE
+static int loadStepQueue[LOAD_STEP_QUEUE_SIZE];
+static uint32_t loadStepQueueHead = 0;
+static uint32_t loadStepQueueTail = 0;
+static bool loadStepArmed = false; /*!< SoundFontSamplerCtrl is executed by LoadStep_Process */
+static bool loadStepYielding = false; /*!< a block is rendered by LoadStep_Yield */
+static uint32_t loadStepYieldCycles = 0; /*!< start of the last block rendered while the loader runs */
+
+static struct load_step_plan_s *loadStepPlan = NULL; /*!< plan filled by the loader */
+static uint32_t loadStepBase = 0; /*!< position of the current transfer of the loader within the plan */
+static bool loadStepLost = false;
+
+static struct load_step_plan_s *loadStepHead = NULL; /*!< plans to be executed */
+static struct load_step_plan_s *loadStepTail = NULL;
+static enum load_step_state_e loadStepState = LOAD_STEP_IDLE;
+static uint32_t loadStepRange = 0;
+static uint32_t loadStepRangePos = 0;
+static uint32_t loadStepOp = 0;
+static uint32_t loadStepBytes = 0;
+static uint32_t loadStepStartMs = 0;
+
+static uint8_t loadStepBlock[LOAD_STEP_BYTES];
+#endif
+
+
+/*
+ * static function definitions
+ */
+#ifdef LOAD_STEP_ACTIVE
+/*
+ * doubles the capacity of a list when it is full, returns false when the memory is not available
+ */
+static bool loadStep_Grow(void **list, uint32_t cnt, uint32_t *cap, size_t size)
+{
+    if (cnt < *cap)
+    {
+        return true;
+    }
+
+    uint32_t newCap = (*cap > 0) ? (*cap * 2) : 16;
+    void *newList = realloc(*list, newCap * size);
+    if (newList == NULL)
+    {
+        loadStepLost = true;
+        return false;
+    }
+    *list = newList;
+    *cap = newCap;
+    return true;
+}
+
+static uint32_t loadStep_SampleCnt(uint32_t byteCnt, enum sample_transfer_fmt_e fmt)
+{
+    switch (fmt)
+    {
+    case SAMPLE_TRANSFER_U8:
+        return byteCnt;
+    case SAMPLE_TRANSFER_S16_STEREO:
+        return byteCnt / 4;
+    default:
+        return byteCnt / 2;
+    }
+}
+
+static struct load_step_range_s *loadStep_AddRange(void)
+{
+    struct load_step_plan_s *plan = loadStepPlan;
+    if (!loadStep_Grow((void **)&plan->ranges, plan->rangeCnt, &plan->rangeCap, sizeof(struct load_step_range_s)))
+    {
+        return NULL;
+    }
+    return &plan->ranges[plan->rangeCnt++];
+}
+
+static struct load_step_op_s *loadStep_AddOp(void)
+{
+    struct load_step_plan_s *plan = loadStepPlan;
+    if (!loadStep_Grow((void **)&plan->ops, plan->opCnt, &plan->opCap, sizeof(struct load_step_op_s)))
+    {
+        return NULL;
+    }
+    return &plan->ops[plan->opCnt++];
+}
+
+static void loadStep_FreePlan(struct load_step_plan_s *plan)
+{
+    for (uint32_t i = 0; i < plan->rangeCnt; i++)
+    {
+        free(plan->ranges[i].data);
+    }
+    free(plan->ranges);
+    free(plan->ops);
+    free(plan);
+}
+
+/*
+ * removes the executed plan
+ */
+static void loadStep_Next(void)
+{
+    struct load_step_plan_s *plan = loadStepHead;
+
+    loadStepHead = plan->next;
+    if (loadStepHead == NULL)
+    {
+        loadStepTail = NULL;
+    }
+    loadStep_FreePlan(plan);
+    loadStepState = LOAD_STEP_IDLE;
+}
+
+static void loadStep_Start(struct load_step_plan_s *plan)
+{
+    if (!FS_OpenFile(plan->fsId, plan->filename))
+    {
+        Serial.printf("load step: not able to open %s\n", plan->filename);
+        loadStep_Next();
+        return;
+    }
+
+    SampleTransfer_Start();
+    loadStepRange = 0;
+    loadStepRangePos = 0;
+    loadStepOp = 0;
+    loadStepBytes = 0;
+    loadStepStartMs = millis();
+    loadStepState = LOAD_STEP_TRANSFER;
+}
+
+/*
+ * reads the next block of the sample data
+ */
+static void loadStep_Transfer(struct load_step_plan_s *plan)
+{
+    if (loadStepRange >= plan->rangeCnt)
+    {
+        SampleTransfer_End();
+        FS_CloseFile();
+        loadStepState = LOAD_STEP_APPLY;
+        return;
+    }
+
+    struct load_step_range_s *range = &plan->ranges[loadStepRange];
+    uint32_t cnt = range->byteCnt - loadStepRangePos;
+    bool ok;
+
+    if (range->data != NULL)
+    {
+        ok = SampleTransfer_AddBlock(range->data, cnt, range->fmt);
+    }
+    else
+    {
+        if (cnt > LOAD_STEP_BYTES)
+        {
+            cnt = LOAD_STEP_BYTES;
+        }
+        /* the position is set for each step, the file may have been used in between */
+        fileSeekTo(range->offset + loadStepRangePos);
+        ok = (readBytes(loadStepBlock, cnt) == cnt) && SampleTransfer_AddBlock(loadStepBlock, cnt, range->fmt);
+    }
+
+    if (!ok)
+    {
+        Serial.printf("load step: %s failed, %" PRIu32 " kB loaded\n", plan->filename, loadStepBytes / 1024);
+        SampleTransfer_End();
+        FS_CloseFile();
+        Status_ValueChangedStr("Load step", "Loading failed!", plan->filename);
+        loadStep_Next();
+        return;
+    }
+
+    loadStepBytes += cnt;
+    loadStepRangePos += cnt;
+    if (loadStepRangePos >= range->byteCnt)
+    {
+        loadStepRange++;
+        loadStepRangePos = 0;
+    }
+}
+
+/*
+ * adds the recorded samples, spread over a few steps
+ */
+static void loadStep_Apply(struct load_step_plan_s *plan)
+{
+    for (uint32_t i = 0; (i < LOAD_STEP_OPS) && (loadStepOp < plan->opCnt); i++)
+    {
+        struct load_step_op_s *op = &plan->ops[loadStepOp++];
+        if (op->instrumentDone)
+        {
+            SmplBank_InstrumentDone();
+        }
+        else
+        {
+            SmplBank_ApplyRegion(&op->region);
+        }
+    }
+
+    if (loadStepOp >= plan->opCnt)
+    {
+        Serial.printf("load step: %s, %" PRIu32 " kB in %" PRIu32 " ms\n", plan->filename, loadStepBytes / 1024, millis() - loadStepStartMs);
+        Status_ValueChangedStr("Load step", "Loaded", plan->filename);
+        SmplArena_LoadDone();
+        loadStep_Next();
+    }
+}
+#endif
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * requests SoundFontSamplerCtrl(ctrl), the requests are executed in order of arrival
+ * returns false when the request has been dropped
+ */
+bool LoadStep_Request(int ctrl)
+{
+#ifdef LOAD_STEP_ACTIVE
+    if (loadStepQueueHead - loadStepQueueTail >= LOAD_STEP_QUEUE_SIZE)
+    {
+        Serial.printf("load %d dropped, too many requests\n", ctrl);
+        return false;
+    }
+    if (LoadStep_IsBusy())
+    {
+        Serial.printf("load %d queued\n", ctrl);
+    }
+    loadStepQueue[loadStepQueueHead++ % LOAD_STEP_QUEUE_SIZE] = ctrl;
+#else
+    SoundFontSamplerCtrl(ctrl);
+#endif
+    return true;
+}
+
+bool LoadStep_IsBusy(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    return loadStepArmed || (loadStepQueueHead != loadStepQueueTail) || (loadStepHead != NULL);
+#else
+    return false;
+#endif
+}
+
+/*
+ * to be called by the audio core at the start of each block, executes one step of the requested loads
+ */
+void LoadStep_Process(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    if (loadStepArmed)
+    {
+        /* called by the block rendered from LoadStep_Yield */
+        return;
+    }
+
+    if (loadStepHead == NULL)
+    {
+        if (loadStepQueueHead == loadStepQueueTail)
+        {
+            return;
+        }
+
+        /* the loaders fill the plans, the data will be loaded by the next steps */
+        int ctrl = loadStepQueue[loadStepQueueTail++ % LOAD_STEP_QUEUE_SIZE];
+        loadStepArmed = true;
+        loadStepYieldCycles = PERF_CYCLES();
+        SoundFontSamplerCtrl(ctrl);
+        loadStepArmed = false;
+        return;
+    }
+
+    switch (loadStepState)
+    {
+    case LOAD_STEP_IDLE:
+        loadStep_Start(loadStepHead);
+        break;
+    case LOAD_STEP_TRANSFER:
+        loadStep_Transfer(loadStepHead);
+        break;
+    case LOAD_STEP_APPLY:
+        loadStep_Apply(loadStepHead);
+        break;
+    }
+#endif
+}
+
+/*
+ * true while a loader is executed by LoadStep_Process
+ */
+bool LoadStep_InStep(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    return loadStepArmed;
+#else
+    return false;
+#endif
+}
+
+/*
+ * to be called by loaders while parsing (no transfer open), renders a block when the next one is due
+ * the audio keeps running while the headers of a large file are parsed by the first step
+ */
+void LoadStep_Yield(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    if (!loadStepArmed || loadStepYielding || (SampleTransfer_IsOpen() && (loadStepPlan == NULL)))
+    {
+        /* the samples of a load at once are added to the sampler while it would render */
+        return;
+    }
+    /* half of the block period, the output buffer must not run dry */
+    if (PERF_CYCLES() - loadStepYieldCycles < PerfMon_GetBudget() / 2)
+    {
+        return;
+    }
+    loadStepYielding = true;
+    loadStepYieldCycles = PERF_CYCLES();
+    App_Loop();
+    loadStepYielding = false;
+#endif
+}
+
+void LoadStep_PrintState(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    if (loadStepHead == NULL)
+    {
+        Serial.printf("load step: idle");
+    }
+    else
+    {
+        Serial.printf("load step: %s, %" PRIu32 " of %" PRIu32 " kB, %" PRIu32 " of %" PRIu32 " samples added", loadStepHead->filename,
+                      loadStepBytes / 1024, (loadStepHead->pcmCnt * 2) / 1024, loadStepOp, loadStepHead->opCnt);
+    }
+    Serial.printf(", %" PRIu32 " requests queued\n", loadStepQueueHead - loadStepQueueTail);
+#endif
+}
+
+/*
+ * to be called by a loader after opening the file, the following sample data will be recorded in a plan
+ * when the load has been requested by LoadStep_Request
+ */
+void LoadStep_FileBegin(fs_id_t fs_id, const char *filename)
+{
+#ifdef LOAD_STEP_ACTIVE
+    if (!loadStepArmed || (loadStepPlan != NULL) || SmplSnapshot_IsActive() || (strlen(filename) >= LOAD_STEP_NAME_LEN))
+    {
+        /* loaded at once */
+        return;
+    }
+
+    loadStepPlan = (struct load_step_plan_s *)calloc(1, sizeof(struct load_step_plan_s));
+    if (loadStepPlan != NULL)
+    {
+        loadStepPlan->fsId = fs_id;
+        strcpy(loadStepPlan->filename, filename);
+        loadStepBase = 0;
+        loadStepLost = false;
+    }
+#else
+    (void)fs_id;
+    (void)filename;
+#endif
+}
+
+/*
+ * to be called by the loader before closing the file, the plan will be executed by the following steps
+ */
+void LoadStep_FileEnd(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    struct load_step_plan_s *plan = loadStepPlan;
+    if (plan == NULL)
+    {
+        return;
+    }
+    loadStepPlan = NULL;
+
+    if (loadStepLost || ((plan->rangeCnt == 0) && (plan->opCnt == 0)))
+    {
+        if (loadStepLost)
+        {
+            Serial.printf("load step: not enough memory to plan %s\n", plan->filename);
+        }
+        loadStep_FreePlan(plan);
+        return;
+    }
+
+    Serial.printf("load step: %s planned, %" PRIu32 " kB, %" PRIu32 " samples\n", plan->filename, (plan->pcmCnt * 2) / 1024, plan->opCnt);
+    if (loadStepTail != NULL)
+    {
+        loadStepTail->next = plan;
+    }
+    else
+    {
+        loadStepHead = plan;
+    }
+    loadStepTail = plan;
+#endif
+}
+
+/*
+ * returns the samples of the plan being filled, they are not in the sample memory yet
+ * the loaders are executed only when all previous plans have been loaded
+ */
+uint32_t LoadStep_PendingCnt(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    return (loadStepPlan != NULL) ? loadStepPlan->pcmCnt : 0;
+#else
+    return 0;
+#endif
+}
+
+bool LoadStep_IsPlanning(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    return loadStepPlan != NULL;
+#else
+    return false;
+#endif
+}
+
+/*
+ * all transfers of a file are merged into one transfer, returns true while planning
+ */
+bool LoadStep_TransferStart(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    if (loadStepPlan != NULL)
+    {
+        loadStepBase = loadStepPlan->pcmCnt;
+        return true;
+    }
+#endif
+    return false;
+}
+
+/*
+ * records the data at the current position of the file, the file position is moved behind it
+ */
+bool LoadStep_Read(uint32_t byteCnt, enum sample_transfer_fmt_e fmt)
+{
+#ifdef LOAD_STEP_ACTIVE
+    struct load_step_range_s *range = loadStep_AddRange();
+    if (range == NULL)
+    {
+        return false;
+    }
+
+    range->offset = getCurrentOffset();
+    range->byteCnt = byteCnt;
+    range->data = NULL;
+    range->fmt = fmt;
+    loadStepPlan->pcmCnt += loadStep_SampleCnt(byteCnt, fmt);
+    fileSeekTo(range->offset + byteCnt);
+    return true;
+#else
+    (void)byteCnt;
+    (void)fmt;
+    return false;
+#endif
+}
+
+/*
+ * keeps a copy of samples passed by the loader
+ */
+bool LoadStep_AddSamples(const uint8_t *data, uint32_t byteCnt, enum sample_transfer_fmt_e fmt)
+{
+#ifdef LOAD_STEP_ACTIVE
+    uint8_t *copy = (uint8_t *)malloc(byteCnt);
+    struct load_step_range_s *range = (copy != NULL) ? loadStep_AddRange() : NULL;
+    if (range == NULL)
+    {
+        free(copy);
+        loadStepLost = true;
+        return false;
+    }
+
+    memcpy(copy, data, byteCnt);
+    range->offset = 0;
+    range->byteCnt = byteCnt;
+    range->data = copy;
+    range->fmt = fmt;
+    loadStepPlan->pcmCnt += loadStep_SampleCnt(byteCnt, fmt);
+    return true;
+#else
+    (void)data;
+    (void)byteCnt;
+    (void)fmt;
+    return false;
+#endif
+}
+
+/*
+ * stores the region to be added after the sample data, returns false when not planning
+ */
+bool LoadStep_DeferRegion(const struct smpl_region_s *region)
+{
+#ifdef LOAD_STEP_ACTIVE
+    if (loadStepPlan != NULL)
+    {
+        struct load_step_op_s *op = loadStep_AddOp();
+        if (op != NULL)
+        {
+            op->instrumentDone = false;
+            op->region = *region;
+            op->region.start += loadStepBase;
+            op->region.end += loadStepBase;
+            op->region.loopStart += loadStepBase;
+            op->region.loopEnd += loadStepBase;
+        }
+        return true;
+    }
+#else
+    (void)region;
+#endif
+    return false;
+}
+
+bool LoadStep_DeferInstrumentDone(void)
+{
+#ifdef LOAD_STEP_ACTIVE
+    if (loadStepPlan != NULL)
+    {
+        struct load_step_op_s *op = loadStep_AddOp();
+        if (op != NULL)
+        {
+            op->instrumentDone = true;
+        }
+        return true;
+    }
+#endif
+    return false;
+}
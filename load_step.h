@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file load_step.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Loading of sample data in steps by App_Loop on boards without a load job
+ * @n       See load_step.cpp
+ */
+
+
+#ifndef LOAD_STEP_H_
+#define LOAD_STEP_H_
+
+
+/*
+ * includes
+ */
+#include "config.h"
+#include "load_job.h"
+#include "sample_transfer.h"
+#include "smpl_bank.h"
+#include "fs/fs_access.h"
+
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#ifndef LOAD_JOB_ACTIVE
+#define LOAD_STEP_ACTIVE /*!< requested loads are executed in steps between the audio blocks */
+#endif
+
+
+/*
+ * declarations
+ */
+bool LoadStep_Request(int ctrl);
+bool LoadStep_IsBusy(void);
+void LoadStep_Process(void);
+bool LoadStep_InStep(void);
+void LoadStep_Yield(void);
+void LoadStep_PrintState(void);
+
+/* called by the loaders which can be executed in steps */
+void LoadStep_FileBegin(fs_id_t fs_id, const char *filename);
+void LoadStep_FileEnd(void);
+
+/* called by the sample transfer and the sample bank */
+bool LoadStep_IsPlanning(void);
+uint32_t LoadStep_PendingCnt(void);
+bool LoadStep_TransferStart(void);
+bool LoadStep_Read(uint32_t byteCnt, enum sample_transfer_fmt_e fmt);
+bool LoadStep_AddSamples(const uint8_t *data, uint32_t byteCnt, enum sample_transfer_fmt_e fmt);
+bool LoadStep_DeferRegion(const struct smpl_region_s *region);
+bool LoadStep_DeferInstrumentDone(void);
+
+
+#endif /* LOAD_STEP_H_ */
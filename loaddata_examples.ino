@@ -44,10 +44,58 @@
  */
 #include "wav_to_sampler.h"
 #include "sf_to_sampler.h"
+#include "smpl_bank.h"
+#include "sample_transfer.h"
+#include "smpl_snapshot.h"
+#include "voice_alloc.h"
+#include "preset_cache.h"
+#include "load_job.h"
+#include "hot_swap.h"
+#include "smpl_arena.h"
+#include "app.h"
 
 
 #include <ml_sampler.h>
 
+#if __has_include("smpl_bank_image.h")
+#include "smpl_bank_image.h"
+#define SMPL_BANK_IMAGE_AVAILABLE
+#endif
+
+
+/*
+ * static function definitions
+ */
+static void loadData_Rhodes(void)
+{
+    SF2ToSmpl_LoadCompleteSoundFont(FS_ID_SD_MMC, "/198_Rhodes_VS_extreme.sf2");
+}
+
+/*
+ * executed by the audio core when called from the load job (see load_job.cpp)
+ */
+static void loadData_Clear(void)
+{
+    SmplBank_Unmap();
+    Sampler_ClearAllSamples();
+    SampleTransfer_SetMemUsed(0);
+    VoiceAlloc_ClearExclusiveClasses();
+    PresetCache_Disable();
+    HotSwap_Reset();
+    SmplArena_Reset();
+}
+
+static void loadData_MapFlash(void)
+{
+#ifdef SMPL_BANK_IMAGE_AVAILABLE
+    SmplBank_Map(smplBankImage, sizeof(smplBankImage));
+#elif defined ESP32
+    SmplBank_MapPartition("samples");
+#else
+    Serial.printf("no sample bank in flash available\n");
+#endif
+}
+
 /*
  * extern function definitions
  */
@@ -59,8 +107,12 @@ void SoundFontSamplerCtrl(int i)
     case 0:
         /*
          * removing all sample data from sampler
+         * with the hot swap the following loads go into the other bank and replace the samples when done
          */
-        Sampler_ClearAllSamples();
+        if (!HotSwap_Clear())
+        {
+            LoadJob_Sync(loadData_Clear);
+        }
         break;
 
     case 1:
@@ -68,7 +120,7 @@ void SoundFontSamplerCtrl(int i)
          * load a single sample to all keys
          */
         WavToSmpl_FileToSingleNote(FS_ID_LITTLEFS, "/PappRohrSample.wav", W2S_ALL_NOTES);
-        Sampler_InstrumentDone();
+        SmplBank_InstrumentDone();
         break;
 
     case 2:
@@ -87,7 +139,7 @@ void SoundFontSamplerCtrl(int i)
         WavToSmpl_FileToSingleNote(FS_ID_LITTLEFS, "/dirName/fileName-10.wav", 45);
         WavToSmpl_FileToSingleNote(FS_ID_LITTLEFS, "/dirName/fileName-11.wav", 46);
         WavToSmpl_FileToSingleNote(FS_ID_LITTLEFS, "/dirName/fileName-12.wav", 47);
-        Sampler_InstrumentDone();
+        SmplBank_InstrumentDone();
         break;
 
     case 3:
@@ -172,5 +224,73 @@ void SoundFontSamplerCtrl(int i)
         Serial.printf("Load HS TR-808 Drums.sf2\n");
         SF2ToSmpl_LoadCompleteSoundFont(FS_ID_SD_MMC, "/HS TR-808 Drums.sf2");
         break;
+
+    case 13:
+        /*
+         * loading only a few presets of a large general midi soundfont
+         * only the sample data used by these presets will be copied into the memory
+         * this allows to use soundfonts which are much larger than the PSRAM
+         */
+        {
+            static const uint32_t presets[] = {0, 4, 33}; /* index of the preset header */
+            Serial.printf("Load presets of GeneralUser GS.sf2\n");
+            SF2ToSmpl_LoadPresetsCompact(FS_ID_SD_MMC, "/GeneralUser GS.sf2", presets, sizeof(presets) / sizeof(presets[0]));
+        }
+        break;
+
+    case 14:
+        /*
+         * the presets of a general midi soundfont will be loaded on demand by a program change
+         * the least recently used presets are removed from the memory when it is full
+         */
+        Serial.printf("Use GeneralUser GS.sf2 with preset cache\n");
+        PresetCache_Enable(FS_ID_SD_MMC, "/GeneralUser GS.sf2", App_GetSampleMemSize());
+        break;
+
+    case PRESET_CACHE_CTRL:
+        /* a preset of the cache requested by a program change */
+        PresetCache_LoadPending();
+        break;
+
+#ifdef STREAM_VOICE_ACTIVE
+    case 15:
+        /*
+         * the piano of a large soundfont will be streamed from the sd card
+         * only the attack and short loops of the samples are kept in memory
+         */
+        {
+            static const uint32_t presets[] = {0};
+            Serial.printf("Stream piano of GeneralUser GS.sf2\n");
+            SF2ToSmpl_StreamPresets(FS_ID_SD_MMC, "/GeneralUser GS.sf2", presets, sizeof(presets) / sizeof(presets[0]));
+        }
+        break;
+#endif
+
+    case 16:
+        /*
+         * loading a sample bank image created by host/host_bank_convert.cpp
+         * the image is read in one pass without parsing a soundfont
+         */
+        Serial.printf("Load bank.smpb\n");
+        SmplBank_Load(FS_ID_LITTLEFS, "/bank.smpb");
+        break;
+
+    case 17:
+        /*
+         * playing a sample bank directly from the flash without copying it into the RAM
+         * the bank can be compiled into the sketch (ml_bank_convert -c smpl_bank_image.h)
+         * or written into the data partition "samples" of the ESP32
+         */
+        LoadJob_Sync(loadData_MapFlash);
+        break;
+
+    case 18:
+        /*
+         * loading the rhodes soundfont only once, the loaded samples will be stored as snapshot
+         * the following boots restore the snapshot in a single pass without parsing the soundfont
+         * remove /rhodes.smpb when the soundfont has been changed
+         */
+        SmplSnapshot_LoadOrCreate(FS_ID_SD_MMC, "/rhodes.smpb", loadData_Rhodes);
+        break;
     }
 }
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file midi_ctrl_table.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Control change mapping of the edirol pcr-800, shared by z_config.ino and the host build
+ * @n       The file is included within the initializer of edirolMapping[] and has no include guard.
+ * @n       The headers of the callbacks must be included before.
+ */
+
+
+    /* general MIDI */
+    { 0x0, 0x40, "sustain", NULL, NULL, 0},
+
+    /* transport buttons */
+#ifdef MIDI_STREAM_PLAYER_ENABLED
+    { 0x8, 0x52, "back", NULL, MidiStreamPlayerCtrl, MIDI_STREAM_PLAYER_CTRL_PAUSE},
+    { 0xD, 0x52, "stop", NULL, NULL, 0},
+    { 0xe, 0x52, "start", NULL, MidiStreamPlayerCtrl, MIDI_STREAM_PLAYER_CTRL_START},
+    { 0xa, 0x52, "rec", NULL, NULL, 0},
+#else
+    { 0x8, 0x52, "back", NULL, NULL, 0},
+    { 0xD, 0x52, "stop", NULL, NULL, 0},
+    { 0xe, 0x52, "start", NULL, Sampler_LoopEntireSample, 0},
+    { 0xa, 0x52, "rec", NULL, NULL, 0},
+#endif
+
+    /* upper row of buttons */
+    { 0x0, 0x50, "A1", NULL, AppBtn, 0},
+    { 0x1, 0x50, "A2", NULL, AppBtn, 1},
+    { 0x2, 0x50, "A3", NULL, AppBtn, 2},
+    { 0x3, 0x50, "A4", NULL, AppBtn, 3},
+
+    { 0x4, 0x50, "A5", NULL, AppBtn, 4},
+    { 0x5, 0x50, "A6", NULL, AppBtn, 5},
+    { 0x6, 0x50, "A7", NULL, AppBtn, 6},
+    { 0x7, 0x50, "A8", NULL, AppBtn, 7},
+
+    { 0x0, 0x53, "A9", NULL, AppBtn, 8},
+
+    /* lower row of buttons */
+    { 0x0, 0x51, "B1", NULL, AppBtnB, 0},
+    { 0x1, 0x51, "B2", NULL, AppBtnB, 1},
+    { 0x2, 0x51, "B3", NULL, AppBtnB, 2},
+    { 0x3, 0x51, "B4", NULL, AppBtnB, 3},
+
+    { 0x4, 0x51, "B5", NULL, AppBtnB, 4},
+    { 0x5, 0x51, "B6", NULL, AppBtnB, 5},
+    { 0x6, 0x51, "B7", NULL, AppBtnB, 6},
+    { 0x7, 0x51, "B8", NULL, AppBtnB, 7},
+
+    { 0x1, 0x53, "B9", NULL, AppBtnB, 8},
+
+    /* rotary */
+    { 0x0, 0x10, "R1", NULL, Sampler_TuneCoarse, 0},
+    //{ 0x1, 0x10, "R2", NULL, Sampler_TuneFine, 0},
+    { 0x1, 0x10, "R2", NULL, Sampler_ChangeParameterSample, SAMPLER_PARAM_RELEASE},
+    { 0x2, 0x10, "R3", NULL, AppSetInputGain, 0},
+
+#ifdef MAX_DELAY_Q
+    { 0x3, 0x10, "R4", NULL, DelayQ_SetOutputLevel, 3},
+    { 0x4, 0x10, "R5", NULL, DelayQ_SetFeedback, 4},
+    { 0x5, 0x10, "R6", NULL, App_DelayQ_SetLength, 5},
+#endif
+    { 0x6, 0x10, "R7", NULL, Sampler_ChangeParameter, SAMPLER_PARAM_HOLD},
+    { 0x7, 0x10, "R8", NULL, Sampler_ChangeParameter, SAMPLER_PARAM_RELEASE},
+#ifdef REVERB_ENABLED
+    { 0x0, 0x12, "R9", NULL, AppReverb_SetLevel, 0},
+#endif
+
+    /* slider */
+    { 0x0, 0x11, "S1", NULL, Phaser_SetDepth, 0},
+    { 0x1, 0x11, "S2", NULL, AppTremolo_SetDepth, 0},
+    { 0x2, 0x11, "S3", NULL, Phaser_SetG, 0},
+    { 0x3, 0x11, "S4", NULL, Lfo1_SetSpeed, 0},
+
+    { 0x4, 0x11, "S5", NULL, PitchShifter_SetSpeed, 0},
+    { 0x5, 0x11, "S6", NULL, PitchShifter_SetMix, 0},
+    { 0x6, 0x11, "S7", NULL, PitchShifter_SetFeedback, 0},
+    { 0x7, 0x11, "S8", NULL, AppVibrato_SetDepth, 0},
+
+    { 0x1, 0x12, "S9", NULL, AppVibrato_SetIntensity, 0},
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file midi_queue.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Wait-free single producer / single consumer queue for MIDI short messages
+ * @n       The producer (control core) timestamps the events, the audio core drains the queue
+ * @n       at the start of each block. Only the producer writes the head and only the consumer
+ * @n       writes the tail, so no locks are required.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "midi_queue.h"
+
+
+/*
+ * static variables
+ */
+static struct midi_queue_evt_s midiQueue[MIDI_QUEUE_SIZE];
+static uint32_t midiQueueHead = 0; /*!< written by the producer */
+static uint32_t midiQueueTail = 0; /*!< written by the consumer */
+
+static volatile uint32_t midiQueueDropCnt = 0;
+static volatile uint32_t midiQueueFillMax = 0;
+static volatile uint32_t midiQueueLatencyMax = 0; /*!< us between receive and handling */
+static volatile bool midiQueueResetRequest = false;
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * to be called from the producer only, returns false when the queue is full
+ */
+bool MidiQueue_Push(const uint8_t *msg)
+{
+    uint32_t head = midiQueueHead;
+    uint32_t tail = __atomic_load_n(&midiQueueTail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= MIDI_QUEUE_SIZE)
+    {
+        midiQueueDropCnt++;
+        return false;
+    }
+
+    struct midi_queue_evt_s *evt = &midiQueue[head & (MIDI_QUEUE_SIZE - 1)];
+    memcpy(evt->msg, msg, sizeof(evt->msg));
+    evt->timestamp = micros();
+
+    __atomic_store_n(&midiQueueHead, head + 1, __ATOMIC_RELEASE);
+
+    if (head + 1 - tail > midiQueueFillMax)
+    {
+        midiQueueFillMax = head + 1 - tail;
+    }
+
+    return true;
+}
+
+/*
+ * to be called from the consumer only, returns false when the queue is empty
+ */
+bool MidiQueue_Pop(struct midi_queue_evt_s *evt)
+{
+    uint32_t tail = midiQueueTail;
+    uint32_t head = __atomic_load_n(&midiQueueHead, __ATOMIC_ACQUIRE);
+
+    if (midiQueueResetRequest)
+    {
+        midiQueueResetRequest = false;
+        midiQueueLatencyMax = 0;
+    }
+
+    if (head == tail)
+    {
+        return false;
+    }
+
+    *evt = midiQueue[tail & (MIDI_QUEUE_SIZE - 1)];
+
+    __atomic_store_n(&midiQueueTail, tail + 1, __ATOMIC_RELEASE);
+
+    uint32_t latency = micros() - evt->timestamp;
+    if (latency > midiQueueLatencyMax)
+    {
+        midiQueueLatencyMax = latency;
+    }
+
+    return true;
+}
+
+/*
+ * serial command: "midiq" prints the queue statistics, "midiq reset" clears them
+ */
+void MidiQueue_Cmd(const char *args)
+{
+    if (strcmp(args, "reset") == 0)
+    {
+        midiQueueDropCnt = 0;
+        midiQueueFillMax = 0;
+        /* the latency is written by the consumer */
+        midiQueueResetRequest = true;
+    }
+
+    Serial.printf("midi queue: max fill %" PRIu32 " of %d, dropped %" PRIu32 ", max latency %" PRIu32 " us\n",
+                  midiQueueFillMax, MIDI_QUEUE_SIZE, midiQueueDropCnt, midiQueueLatencyMax);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file midi_queue.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the MIDI event queue between the control core and the audio core
+ */
+
+
+#ifndef MIDI_QUEUE_H_
+#define MIDI_QUEUE_H_
+
+
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#define MIDI_QUEUE_SIZE             64 /*!< must be a power of two */
+#define MIDI_QUEUE_MAX_PER_BLOCK    16 /*!< maximum number of events handled by the audio core per block */
+
+
+/*
+ * data types
+ */
+struct midi_queue_evt_s
+{
+    uint8_t msg[4]; /*!< status and data bytes of a short message */
+    uint32_t timestamp; /*!< micros() when the event has been received */
+};
+
+
+/*
+ * declarations
+ */
+bool MidiQueue_Push(const uint8_t *msg);
+bool MidiQueue_Pop(struct midi_queue_evt_s *evt);
+void MidiQueue_Cmd(const char *args);
+
+
+#endif /* MIDI_QUEUE_H_ */
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file midi_sched.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Sample accurate MIDI event scheduling
+ * @n       Note and pitch bend events carry a sample offset within the upcoming block.
+ * @n       MidiSched_Render splits the block at the event offsets and applies the events
+ * @n       between the calls of Sampler_Process, so the timing does not depend on the block size.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "midi_sched.h"
+#include "voice_alloc.h"
+#include "stream_voice.h"
+
+#include <ml_sampler.h>
+
+
+/*
+ * data types
+ */
+enum midi_sched_type_e
+{
+    MIDI_SCHED_NOTE_ON,
+    MIDI_SCHED_NOTE_OFF,
+    MIDI_SCHED_PITCH_BEND,
+};
+
+struct midi_sched_evt_s
+{
+    uint16_t offset;
+    uint8_t type;
+    uint8_t ch;
+    uint16_t data; /*!< note and velocity or pitch bend value */
+};
+
+
+/*
+ * static function declarations
+ */
+static void midiSched_Apply(const struct midi_sched_evt_s *evt);
+static void midiSched_Add(uint8_t type, uint8_t ch, uint16_t data);
+static void midiSched_Process(Q1_14 *left, Q1_14 *right, uint32_t len);
+
+
+/*
+ * static variables
+ */
+static struct midi_sched_evt_s midiSchedEvts[MIDI_SCHED_EVT_CNT];
+static uint32_t midiSchedEvtCnt = 0;
+static uint32_t midiSchedOffset = 0; /*!< offset of events scheduled now */
+static uint32_t midiSchedLen = SAMPLE_BUFFER_SIZE; /*!< length of the upcoming block */
+static uint32_t midiSchedBlockUs = 0; /*!< start of the current block */
+static uint32_t midiSchedPrevBlockUs = 0; /*!< start of the previous block */
+
+
+/*
+ * static function definitions
+ */
+static void midiSched_Apply(const struct midi_sched_evt_s *evt)
+{
+    switch (evt->type)
+    {
+    case MIDI_SCHED_NOTE_ON:
+#ifdef STREAM_VOICE_ACTIVE
+        if (StreamVoice_NoteOn(evt->ch, evt->data >> 8, evt->data & 0xFF))
+        {
+            break;
+        }
+#endif
+        VoiceAlloc_NoteOn(evt->ch, evt->data >> 8, evt->data & 0xFF);
+        break;
+    case MIDI_SCHED_NOTE_OFF:
+#ifdef STREAM_VOICE_ACTIVE
+        StreamVoice_NoteOff(evt->ch, evt->data >> 8);
+#endif
+        VoiceAlloc_NoteOff(evt->ch, evt->data >> 8);
+        break;
+    case MIDI_SCHED_PITCH_BEND:
+        Sampler_PitchBend(evt->ch, evt->data);
+        break;
+    }
+}
+
+static void midiSched_Process(Q1_14 *left, Q1_14 *right, uint32_t len)
+{
+    Sampler_Process(left, right, len);
+#ifdef STREAM_VOICE_ACTIVE
+    StreamVoice_Process(left, right, len);
+#endif
+}
+
+/*
+ * inserts the event behind all events with the same or a lower offset to keep the order of arrival
+ */
+static void midiSched_Add(uint8_t type, uint8_t ch, uint16_t data)
+{
+    struct midi_sched_evt_s evt = { (uint16_t)midiSchedOffset, type, ch, data };
+
+    if (midiSchedEvtCnt >= MIDI_SCHED_EVT_CNT)
+    {
+        /*
+         * no space left, the queued events up to the offset of this one and the event itself
+         * will be applied now in their order, the later events stay queued
+         */
+        uint32_t cnt = 0;
+        while ((cnt < midiSchedEvtCnt) && (midiSchedEvts[cnt].offset <= evt.offset))
+        {
+            midiSched_Apply(&midiSchedEvts[cnt]);
+            cnt++;
+        }
+        midiSched_Apply(&evt);
+
+        memmove(&midiSchedEvts[0], &midiSchedEvts[cnt], (midiSchedEvtCnt - cnt) * sizeof(midiSchedEvts[0]));
+        midiSchedEvtCnt -= cnt;
+        return;
+    }
+
+    uint32_t i = midiSchedEvtCnt;
+    while ((i > 0) && (midiSchedEvts[i - 1].offset > evt.offset))
+    {
+        midiSchedEvts[i] = midiSchedEvts[i - 1];
+        i--;
+    }
+    midiSchedEvts[i] = evt;
+    midiSchedEvtCnt++;
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * to be called at the start of each block, used as time reference of MidiSched_SetOffsetUs
+ * events without an offset will be applied at the start of the block
+ */
+void MidiSched_BlockStart(uint32_t len)
+{
+    midiSchedLen = len;
+    midiSchedPrevBlockUs = midiSchedBlockUs;
+    midiSchedBlockUs = micros();
+    midiSchedOffset = 0;
+}
+
+/*
+ * sets the sample offset of the following events
+ */
+void MidiSched_SetOffset(uint32_t offset)
+{
+    if (offset >= midiSchedLen)
+    {
+        offset = midiSchedLen - 1;
+    }
+    midiSchedOffset = offset - (offset % MIDI_SCHED_GRANULE);
+}
+
+/*
+ * sets the offset of the following events from their receive time
+ * the events received during the previous block keep their distance in the upcoming block
+ */
+void MidiSched_SetOffsetUs(uint32_t timestamp)
+{
+    int32_t delta = (int32_t)(timestamp - midiSchedPrevBlockUs);
+
+    if (delta <= 0)
+    {
+        MidiSched_SetOffset(0);
+    }
+    else
+    {
+        MidiSched_SetOffset((((uint64_t)delta) * SAMPLE_RATE) / 1000000);
+    }
+}
+
+void MidiSched_NoteOn(uint8_t ch, uint8_t note, uint8_t vel)
+{
+    midiSched_Add(MIDI_SCHED_NOTE_ON, ch, ((uint16_t)note << 8) | vel);
+}
+
+void MidiSched_NoteOff(uint8_t ch, uint8_t note)
+{
+    midiSched_Add(MIDI_SCHED_NOTE_OFF, ch, (uint16_t)note << 8);
+}
+
+void MidiSched_PitchBend(uint8_t ch, uint16_t bend)
+{
+    midiSched_Add(MIDI_SCHED_PITCH_BEND, ch, bend);
+}
+
+/*
+ * renders the sampler and applies the scheduled events at their offset
+ */
+void MidiSched_Render(Q1_14 *left, Q1_14 *right, uint32_t len)
+{
+    uint32_t pos = 0;
+
+    for (uint32_t i = 0; i < midiSchedEvtCnt; i++)
+    {
+        const struct midi_sched_evt_s *evt = &midiSchedEvts[i];
+        uint32_t offset = (evt->offset < len) ? evt->offset : pos;
+
+        if (offset > pos)
+        {
+            midiSched_Process(&left[pos], &right[pos], offset - pos);
+            pos = offset;
+        }
+        midiSched_Apply(evt);
+    }
+
+    if (pos < len)
+    {
+        midiSched_Process(&left[pos], &right[pos], len - pos);
+    }
+
+    midiSchedEvtCnt = 0;
+}
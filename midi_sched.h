@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file midi_sched.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the sample accurate MIDI event scheduling
+ */
+
+
+#ifndef MIDI_SCHED_H_
+#define MIDI_SCHED_H_
+
+
+/*
+ * includes
+ */
+#include <ml_types.h>
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#define MIDI_SCHED_EVT_CNT      64 /*!< events per block, further events will be applied at once */
+#define MIDI_SCHED_GRANULE      4 /*!< offsets will be rounded down to a multiple of this to avoid tiny sub blocks */
+#define MIDI_SCHED_PLAYER_STEP  8 /*!< samples the midi stream player will be ticked at once */
+
+
+/*
+ * declarations
+ */
+void MidiSched_BlockStart(uint32_t len);
+void MidiSched_SetOffset(uint32_t offset);
+void MidiSched_SetOffsetUs(uint32_t timestamp);
+void MidiSched_NoteOn(uint8_t ch, uint8_t note, uint8_t vel);
+void MidiSched_NoteOff(uint8_t ch, uint8_t note);
+void MidiSched_PitchBend(uint8_t ch, uint16_t bend);
+void MidiSched_Render(Q1_14 *left, Q1_14 *right, uint32_t len);
+
+
+#endif /* MIDI_SCHED_H_ */
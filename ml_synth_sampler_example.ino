@@ -39,6 +39,7 @@
 
 
 #include "app.h"
+#include "dual_render.h"
 
 
 #if (defined ESP32) && (SOC_CPU_CORES_NUM > 1)
@@ -46,7 +47,7 @@ void Core0TaskInit(void);
 void Core0Task(void *parameter);
 #endif
 
-#ifdef ARDUINO_RP2040
+#ifdef ARDUINO_ARCH_RP2040
 volatile bool g_setup_done = false;
 #endif
 
@@ -56,7 +57,7 @@ void setup()
     Serial.begin(115200);
     App_Setup();
 
-#ifdef ARDUINO_RP2040
+#ifdef ARDUINO_ARCH_RP2040
     g_setup_done = true;
 #endif
 
@@ -70,7 +71,7 @@ void loop()
     App_Loop();
 }
 
-#ifdef ARDUINO_RP2040
+#ifdef ARDUINO_ARCH_RP2040
 
 void wait_until_setup_finished(void)
 {
@@ -128,7 +129,11 @@ void Core0Task(void *parameter)
         Core0TaskLoop();
 
         /* this seems necessary to trigger the watchdog */
+#ifdef DUAL_RENDER_ACTIVE
+        DualRender_Idle();
+#else
         delay(1);
+#endif
         yield();
     }
 }
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file perf_mon.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Per stage cycle counters of App_Loop
+ * @n       Every stage records min/avg/max of its cycles, only the cycle counter is read within the audio loop
+ * @n       The render time of a block is compared with the deadline (block size / SAMPLE_RATE)
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "perf_mon.h"
+
+
+/*
+ * data types
+ */
+struct perf_stat_s
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t cnt;
+    uint32_t last;
+};
+
+
+/*
+ * static function declarations
+ */
+static void perfMon_Add(struct perf_stat_s *stat, uint32_t cycles);
+static void perfMon_Clear(void);
+static void perfMon_PrintStat(const char *name, const struct perf_stat_s *stat);
+
+
+/*
+ * static variables
+ */
+static const char *perfStageNames[PERF_STAGE_CNT] =
+{
+    "control",
+    "sampler",
+    "reverb",
+    "lfo",
+    "phaser",
+    "vibrato",
+    "pitch shifter",
+    "tremolo",
+    "delay",
+    "output (wait)",
+};
+
+static struct perf_stat_s perfStages[PERF_STAGE_CNT];
+static struct perf_stat_s perfRender;
+static uint32_t perfBlockStart = 0;
+static uint32_t perfLast = 0;
+static uint32_t perfLastRender = 0;
+static uint32_t perfLastPeriod = 0;
+static bool perfFirstBlock = true;
+static uint32_t perfBudget = 1;
+static uint32_t perfCyclesPerUs = 1;
+static volatile bool perfResetRequest = false;
+
+
+/*
+ * static function definitions
+ */
+static void perfMon_Add(struct perf_stat_s *stat, uint32_t cycles)
+{
+    if (cycles < stat->min)
+    {
+        stat->min = cycles;
+    }
+    if (cycles > stat->max)
+    {
+        stat->max = cycles;
+    }
+    stat->sum += cycles;
+    stat->cnt++;
+    stat->last = cycles;
+}
+
+static void perfMon_Clear(void)
+{
+    for (int i = 0; i < PERF_STAGE_CNT; i++)
+    {
+        perfStages[i].min = UINT32_MAX;
+        perfStages[i].max = 0;
+        perfStages[i].sum = 0;
+        perfStages[i].cnt = 0;
+    }
+    perfRender.min = UINT32_MAX;
+    perfRender.max = 0;
+    perfRender.sum = 0;
+    perfRender.cnt = 0;
+}
+
+static void perfMon_PrintStat(const char *name, const struct perf_stat_s *stat)
+{
+    if (stat->cnt == 0)
+    {
+        Serial.printf("  %-16s %8s %8s %8s %8s\n", name, "-", "-", "-", "-");
+        return;
+    }
+
+    uint32_t avg = stat->sum / stat->cnt;
+    Serial.printf("  %-16s %8.1f %8.1f %8.1f %7.1f%%\n", name,
+                  ((float)stat->min) / perfCyclesPerUs,
+                  ((float)avg) / perfCyclesPerUs,
+                  ((float)stat->max) / perfCyclesPerUs,
+                  100.0f * ((float)avg) / ((float)perfBudget));
+}
+
+
+/*
+ * extern function definitions
+ */
+void PerfMon_Setup(void)
+{
+#if (defined ARDUINO_ARCH_STM32) && (defined DWT)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    uint64_t cyclesPerSecond = PERF_CYCLES_PER_SECOND();
+    perfCyclesPerUs = cyclesPerSecond / 1000000ULL;
+    if (perfCyclesPerUs == 0)
+    {
+        perfCyclesPerUs = 1;
+    }
+    PerfMon_SetBlockSize(SAMPLE_BUFFER_SIZE);
+
+    Serial.printf("perf: %" PRIu32 " cycles/us, budget %" PRIu32 " cycles per block\n", perfCyclesPerUs, perfBudget);
+}
+
+/*
+ * the budget follows the block size, the statistics will be cleared
+ */
+void PerfMon_SetBlockSize(uint32_t len)
+{
+    perfBudget = (((uint64_t)PERF_CYCLES_PER_SECOND()) * len) / SAMPLE_RATE;
+    perfMon_Clear();
+}
+
+void PerfMon_BlockStart(void)
+{
+    if (perfResetRequest)
+    {
+        perfMon_Clear();
+        perfResetRequest = false;
+    }
+
+    uint32_t now = PERF_CYCLES();
+    /* the time since setup does not count as a block period */
+    perfLastPeriod = perfFirstBlock ? 0 : (now - perfBlockStart);
+    perfFirstBlock = false;
+    perfBlockStart = now;
+    perfLast = now;
+}
+
+void PerfMon_Mark(enum perf_stage_e stage)
+{
+    uint32_t now = PERF_CYCLES();
+    perfMon_Add(&perfStages[stage], now - perfLast);
+    perfLast = now;
+}
+
+/*
+ * to be called before the block will be passed to the output
+ */
+void PerfMon_RenderDone(void)
+{
+    uint32_t now = PERF_CYCLES();
+    perfLastRender = now - perfBlockStart;
+    perfMon_Add(&perfRender, perfLastRender);
+    perfLast = now;
+}
+
+uint32_t PerfMon_GetBudget(void)
+{
+    return perfBudget;
+}
+
+uint32_t PerfMon_GetLastRender(void)
+{
+    return perfLastRender;
+}
+
+uint32_t PerfMon_GetLastStage(enum perf_stage_e stage)
+{
+    return perfStages[stage].last;
+}
+
+/*
+ * time between the start of the previous and the current block
+ */
+uint32_t PerfMon_GetLastPeriod(void)
+{
+    return perfLastPeriod;
+}
+
+uint32_t PerfMon_CyclesToUs(uint32_t cycles)
+{
+    return cycles / perfCyclesPerUs;
+}
+
+void PerfMon_Reset(void)
+{
+    /* the counters belong to the audio loop, it will clear them at the next block */
+    perfResetRequest = true;
+}
+
+void PerfMon_Print(void)
+{
+    Serial.printf("stage timing in us (%" PRIu32 " blocks, budget %.1f us):\n", perfRender.cnt, ((float)perfBudget) / perfCyclesPerUs);
+    Serial.printf("  %-16s %8s %8s %8s %8s\n", "stage", "min", "avg", "max", "budget");
+    for (int i = 0; i < PERF_STAGE_CNT; i++)
+    {
+        perfMon_PrintStat(perfStageNames[i], &perfStages[i]);
+    }
+    perfMon_PrintStat("render total", &perfRender);
+
+    if (perfRender.cnt > 0)
+    {
+        int32_t avg = perfRender.sum / perfRender.cnt;
+        Serial.printf("headroom: avg %.1f us, worst %.1f us\n",
+                      ((float)((int32_t)perfBudget - avg)) / perfCyclesPerUs,
+                      ((float)((int32_t)perfBudget - (int32_t)perfRender.max)) / perfCyclesPerUs);
+    }
+}
+
+/*
+ * serial command: "perf" prints the statistics, "perf reset" clears them
+ */
+void PerfMon_Cmd(const char *args)
+{
+    if (strcmp(args, "reset") == 0)
+    {
+        PerfMon_Reset();
+        Serial.printf("perf: reset\n");
+    }
+    else
+    {
+        PerfMon_Print();
+    }
+}
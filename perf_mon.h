@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file perf_mon.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the per stage cycle counters of App_Loop
+ */
+
+
+#ifndef PERF_MON_H_
+#define PERF_MON_H_
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#if (defined ESP32)
+#define PERF_CYCLES()               ESP.getCycleCount()
+#define PERF_CYCLES_PER_SECOND()    (ESP.getCpuFreqMHz() * 1000000UL)
+#elif (defined ARDUINO_ARCH_RP2040)
+#define PERF_CYCLES()               rp2040.getCycleCount()
+#define PERF_CYCLES_PER_SECOND()    rp2040.f_cpu()
+#elif (defined __IMXRT1062__)
+#define PERF_CYCLES()               ARM_DWT_CYCCNT
+#define PERF_CYCLES_PER_SECOND()    F_CPU_ACTUAL
+#elif (defined ARDUINO_ARCH_STM32) && (defined DWT)
+#define PERF_CYCLES()               DWT->CYCCNT
+#define PERF_CYCLES_PER_SECOND()    SystemCoreClock
+#elif (defined ML_HOST_BUILD)
+#define PERF_CYCLES()               ((uint32_t)HostTime_GetNs())
+#define PERF_CYCLES_PER_SECOND()    1000000000UL
+uint64_t HostTime_GetNs(void);
+#else
+/* no cycle counter available, the resolution will be 1 us */
+#define PERF_CYCLES()               micros()
+#define PERF_CYCLES_PER_SECOND()    1000000UL
+#endif
+
+
+/*
+ * data types
+ */
+enum perf_stage_e
+{
+    PERF_STAGE_CONTROL, /*!< 1Hz loop, MIDI, status */
+    PERF_STAGE_SAMPLER,
+    PERF_STAGE_REVERB, /*!< stereo to mono + reverb */
+    PERF_STAGE_LFO,
+    PERF_STAGE_PHASER,
+    PERF_STAGE_VIBRATO,
+    PERF_STAGE_PITCH_SHIFTER,
+    PERF_STAGE_TREMOLO, /*!< tremolo + conversion to Q1_14 */
+    PERF_STAGE_DELAY,
+    PERF_STAGE_OUTPUT, /*!< time spent in Audio_Output waiting for the DMA */
+    PERF_STAGE_CNT,
+};
+
+
+/*
+ * declarations
+ */
+void PerfMon_Setup(void);
+void PerfMon_SetBlockSize(uint32_t len);
+void PerfMon_BlockStart(void);
+void PerfMon_Mark(enum perf_stage_e stage);
+void PerfMon_RenderDone(void);
+uint32_t PerfMon_GetBudget(void);
+uint32_t PerfMon_GetLastRender(void);
+uint32_t PerfMon_GetLastStage(enum perf_stage_e stage);
+uint32_t PerfMon_GetLastPeriod(void);
+uint32_t PerfMon_CyclesToUs(uint32_t cycles);
+void PerfMon_Reset(void);
+void PerfMon_Print(void);
+void PerfMon_Cmd(const char *args);
+
+
+#endif /* PERF_MON_H_ */
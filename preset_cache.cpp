@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file preset_cache.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   On-demand preset loading with LRU eviction
+ * @n       A program change loads only the sample data of the selected preset from the soundfont.
+ * @n       The load is requested like any other load (LoadJob_Request with PRESET_CACHE_CTRL), it is
+ * @n       executed by the second core or in steps between the audio blocks. The program change
+ * @n       is deferred, the channel keeps its previous preset until the new one is available.
+ * @n       With the sample memory arena (SMPL_ARENA_ENABLED) each preset is an entry of the arena.
+ * @n       When the memory is exhausted the least recently used presets are unloaded one by one,
+ * @n       their memory is reused after the next compaction of the arena.
+ * @n       Without the arena the sampler cannot free a single instrument, the least recently used
+ * @n       presets will be dropped and the remaining ones are loaded again (all notes are stopped).
+ * @n       Presets selected by a channel will not be evicted.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "preset_cache.h"
+#include "sf_to_sampler.h"
+#include "sample_transfer.h"
+#include "voice_alloc.h"
+#include "load_job.h"
+#include "hot_swap.h"
+#include "smpl_arena.h"
+
+#include <ml_sampler.h>
+#include <ml_status.h>
+
+
+/*
+ * defines
+ */
+#define PRESET_CACHE_SLOTS          16 /*!< presets which can be kept in memory */
+#define PRESET_CACHE_CH_CNT         16
+#define PRESET_CACHE_FILENAME_LEN   64
+#define PRESET_CACHE_NONE           0xFFFF
+
+
+/*
+ * data types
+ */
+enum preset_cache_load_e
+{
+    PRESET_CACHE_LOAD_IDLE,
+    PRESET_CACHE_LOAD_REQUESTED, /*!< the load of cacheLoadPreset has been requested */
+    PRESET_CACHE_LOAD_DONE, /*!< the preset has been loaded, it is added to the entries by the audio core */
+    PRESET_CACHE_LOAD_FAILED,
+    PRESET_CACHE_LOAD_WAIT_FREE, /*!< presets have been unloaded, the load waits for the compaction of the arena */
+};
+
+enum preset_cache_evict_e
+{
+    PRESET_CACHE_EVICT_OK,
+    PRESET_CACHE_EVICT_IN_USE, /*!< all cached presets are selected */
+    PRESET_CACHE_EVICT_WAIT, /*!< the memory of the unloaded presets is not free yet */
+    PRESET_CACHE_EVICT_REBUILD, /*!< presets have been dropped, the sample memory must be loaded again */
+};
+
+struct preset_cache_entry_s
+{
+    uint16_t preset; /*!< index of the preset header */
+    uint32_t bytes; /*!< sampler memory used */
+    uint32_t lastUse; /*!< value of cacheTick when selected last time */
+    int32_t handle; /*!< entry of the arena */
+};
+
+
+/*
+ * static function declarations
+ */
+static int32_t presetCache_Find(uint16_t preset);
+static bool presetCache_InUse(uint16_t preset);
+static int32_t presetCache_Instrument(int32_t slot);
+static void presetCache_Select(uint8_t ch);
+static bool presetCache_EvictOne(void);
+static void presetCache_Evict(void);
+static void presetCache_ClearSamples(void);
+static void presetCache_RequestNext(void);
+static void presetCache_LoadFinished(void);
+
+
+/*
+ * static variables
+ */
+/* used by the audio core */
+static struct preset_cache_entry_s cacheEntries[PRESET_CACHE_SLOTS];
+static uint32_t cacheCnt = 0;
+static uint32_t cacheBytes = 0;
+static uint32_t cacheTick = 0;
+static bool cacheActive = false;
+
+static uint16_t chPreset[PRESET_CACHE_CH_CNT]; /*!< preset selected per channel */
+static uint16_t chPending[PRESET_CACHE_CH_CNT]; /*!< preset of a deferred program change */
+static int32_t chInstr[PRESET_CACHE_CH_CNT]; /*!< instrument passed to the sampler */
+
+static uint32_t cacheHitCnt = 0;
+static uint32_t cacheMissCnt = 0;
+static uint32_t cacheEvictCnt = 0;
+
+/* shared with the loader, written before the load is requested */
+static fs_id_t cacheFsId;
+static char cacheFilename[PRESET_CACHE_FILENAME_LEN];
+static uint32_t cacheCapacity = 0;
+static uint32_t cacheLoadState = PRESET_CACHE_LOAD_IDLE;
+static uint16_t cacheLoadPreset = PRESET_CACHE_NONE;
+static uint32_t cacheLoadBytes = 0;
+static uint32_t cacheEvictResult = PRESET_CACHE_EVICT_OK;
+
+
+/*
+ * static function definitions
+ */
+static uint32_t presetCache_GetLoadState(void)
+{
+    return __atomic_load_n(&cacheLoadState, __ATOMIC_ACQUIRE);
+}
+
+static void presetCache_SetLoadState(uint32_t state)
+{
+    __atomic_store_n(&cacheLoadState, state, __ATOMIC_RELEASE);
+}
+
+static int32_t presetCache_Find(uint16_t preset)
+{
+    for (uint32_t i = 0; i < cacheCnt; i++)
+    {
+        if (cacheEntries[i].preset == preset)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool presetCache_InUse(uint16_t preset)
+{
+    for (uint32_t ch = 0; ch < PRESET_CACHE_CH_CNT; ch++)
+    {
+        /* the preset of a channel waiting for a program change may be replaced */
+        if (((chPreset[ch] == preset) && (chPending[ch] == PRESET_CACHE_NONE)) || (chPending[ch] == preset))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * returns the program of the cached preset, the arena numbers its programs over all entries
+ * without the arena the presets are stored as sampler instruments in the order of cacheEntries
+ */
+static int32_t presetCache_Instrument(int32_t slot)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    return SmplArena_HandleToProgram(cacheEntries[slot].handle);
+#else
+    return slot;
+#endif
+}
+
+/*
+ * passes the instrument of the selected preset to the sampler
+ * the instruments move when presets are loaded or evicted
+ */
+static void presetCache_Select(uint8_t ch)
+{
+#ifndef SMPL_ARENA_ACTIVE
+    if (LoadJob_IsBusy())
+    {
+        /* the sampler memory may be loaded again */
+        return;
+    }
+#endif
+
+    int32_t slot = (chPreset[ch] != PRESET_CACHE_NONE) ? presetCache_Find(chPreset[ch]) : -1;
+    int32_t instr = (slot >= 0) ? presetCache_Instrument(slot) : -1;
+    if ((instr >= 0) && (instr <= 0xFF) && (instr != chInstr[ch]))
+    {
+        chInstr[ch] = instr;
+#ifdef SMPL_ARENA_ACTIVE
+        SmplArena_ProgramChange(ch, instr);
+#else
+        Sampler_ProgramChange(ch, instr);
+#endif
+    }
+}
+
+/*
+ * removes the least recently used preset which is not selected by any channel
+ */
+static bool presetCache_EvictOne(void)
+{
+    int32_t victim = -1;
+
+    for (uint32_t i = 0; i < cacheCnt; i++)
+    {
+        if (presetCache_InUse(cacheEntries[i].preset))
+        {
+            continue;
+        }
+        if ((victim < 0) || (cacheEntries[i].lastUse < cacheEntries[victim].lastUse))
+        {
+            victim = i;
+        }
+    }
+
+    if (victim < 0)
+    {
+        return false;
+    }
+
+#ifdef SMPL_ARENA_ACTIVE
+    /* the instruments are removed by the audio core, the memory is freed by the next compaction */
+    SmplArena_Unload(cacheEntries[victim].handle);
+#endif
+    cacheBytes -= cacheEntries[victim].bytes;
+    cacheCnt--;
+    for (uint32_t i = victim; i < cacheCnt; i++)
+    {
+        cacheEntries[i] = cacheEntries[i + 1];
+    }
+    cacheEvictCnt++;
+    return true;
+}
+
+/*
+ * executed by the audio core (see LoadJob_Sync), makes room for cacheLoadBytes
+ */
+static void presetCache_Evict(void)
+{
+    bool evicted = false;
+
+    cacheEvictResult = PRESET_CACHE_EVICT_OK;
+    while ((cacheCnt >= PRESET_CACHE_SLOTS) || (cacheBytes + cacheLoadBytes > cacheCapacity))
+    {
+        if (!presetCache_EvictOne())
+        {
+            cacheEvictResult = PRESET_CACHE_EVICT_IN_USE;
+            return;
+        }
+        evicted = true;
+    }
+
+#ifdef SMPL_ARENA_ACTIVE
+    (void)evicted;
+    uint32_t freeCnt;
+    if (SmplArena_GetFree(&freeCnt) && (freeCnt * sizeof(Q1_14) < cacheLoadBytes))
+    {
+        cacheEvictResult = PRESET_CACHE_EVICT_WAIT;
+    }
+#else
+    if (evicted)
+    {
+        cacheEvictResult = PRESET_CACHE_EVICT_REBUILD;
+    }
+#endif
+}
+
+/*
+ * stops all notes and clears the sample memory, the arena takes the memory when available
+ */
+static void presetCache_ClearSamples(void)
+{
+    VoiceAlloc_AllNotesOff();
+    Sampler_AllNotesOff();
+    Sampler_ClearAllSamples();
+    SampleTransfer_SetMemUsed(0);
+    VoiceAlloc_ClearExclusiveClasses();
+    HotSwap_Invalidate();
+    SmplArena_Reset();
+    for (uint32_t ch = 0; ch < PRESET_CACHE_CH_CNT; ch++)
+    {
+        chInstr[ch] = -1;
+    }
+}
+
+/*
+ * requests the load of the next preset of a deferred program change
+ */
+static void presetCache_RequestNext(void)
+{
+    for (uint32_t ch = 0; ch < PRESET_CACHE_CH_CNT; ch++)
+    {
+        if ((chPending[ch] != PRESET_CACHE_NONE) && (presetCache_Find(chPending[ch]) < 0))
+        {
+            cacheLoadPreset = chPending[ch];
+            presetCache_SetLoadState(PRESET_CACHE_LOAD_REQUESTED);
+            if (!LoadJob_Request(PRESET_CACHE_CTRL))
+            {
+                /* tried again by the next program change */
+                chPending[ch] = PRESET_CACHE_NONE;
+                presetCache_SetLoadState(PRESET_CACHE_LOAD_IDLE);
+            }
+            return;
+        }
+    }
+}
+
+/*
+ * adds the loaded preset to the entries, to be called when all loads are done
+ */
+static void presetCache_LoadFinished(void)
+{
+    switch (presetCache_GetLoadState())
+    {
+    case PRESET_CACHE_LOAD_DONE:
+        cacheEntries[cacheCnt].preset = cacheLoadPreset;
+        cacheEntries[cacheCnt].bytes = cacheLoadBytes;
+        cacheEntries[cacheCnt].lastUse = cacheTick;
+        cacheEntries[cacheCnt].handle = SmplArena_LastHandle();
+        cacheBytes += cacheLoadBytes;
+        cacheCnt++;
+        presetCache_SetLoadState(PRESET_CACHE_LOAD_IDLE);
+        break;
+
+    case PRESET_CACHE_LOAD_FAILED:
+        for (uint32_t ch = 0; ch < PRESET_CACHE_CH_CNT; ch++)
+        {
+            if (chPending[ch] == cacheLoadPreset)
+            {
+                chPending[ch] = PRESET_CACHE_NONE;
+            }
+        }
+        presetCache_SetLoadState(PRESET_CACHE_LOAD_IDLE);
+        break;
+
+    case PRESET_CACHE_LOAD_WAIT_FREE:
+        {
+            uint32_t freeCnt;
+            if (SmplArena_GetFree(&freeCnt) && (freeCnt * sizeof(Q1_14) >= cacheLoadBytes))
+            {
+                presetCache_SetLoadState(PRESET_CACHE_LOAD_REQUESTED);
+                if (!LoadJob_Request(PRESET_CACHE_CTRL))
+                {
+                    presetCache_SetLoadState(PRESET_CACHE_LOAD_WAIT_FREE);
+                }
+            }
+        }
+        break;
+    }
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * clears the sampler memory and uses up to capacity bytes for presets of the soundfont
+ */
+bool PresetCache_Enable(fs_id_t fs_id, const char *filename, uint32_t capacity)
+{
+    if (!SF2ToSmpl_ScanPresets(fs_id, filename))
+    {
+        Status_ValueChangedStr("Preset cache", "Loading failed!", filename);
+        return false;
+    }
+
+    /* executed by the audio core when called from the load job */
+    LoadJob_Sync(presetCache_ClearSamples);
+
+    cacheFsId = fs_id;
+    strncpy(cacheFilename, filename, PRESET_CACHE_FILENAME_LEN - 1);
+    cacheFilename[PRESET_CACHE_FILENAME_LEN - 1] = 0;
+    cacheCapacity = capacity;
+    cacheCnt = 0;
+    cacheBytes = 0;
+    cacheTick = 0;
+    cacheHitCnt = 0;
+    cacheMissCnt = 0;
+    cacheEvictCnt = 0;
+    for (uint32_t ch = 0; ch < PRESET_CACHE_CH_CNT; ch++)
+    {
+        chPreset[ch] = PRESET_CACHE_NONE;
+        chPending[ch] = PRESET_CACHE_NONE;
+        chInstr[ch] = -1;
+    }
+    presetCache_SetLoadState(PRESET_CACHE_LOAD_IDLE);
+    __atomic_store_n(&cacheActive, true, __ATOMIC_RELEASE);
+
+    Status_ValueChangedStr("Preset cache", "Enabled", filename);
+    return true;
+}
+
+void PresetCache_Disable(void)
+{
+    __atomic_store_n(&cacheActive, false, __ATOMIC_RELEASE);
+}
+
+bool PresetCache_IsActive(void)
+{
+    return __atomic_load_n(&cacheActive, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * selects the preset of the program (bank 0), a preset not in memory will be loaded and selected afterwards
+ */
+void PresetCache_ProgramChange(uint8_t ch, uint8_t program)
+{
+    ch &= 0x0F;
+
+    int32_t preset = SF2ToSmpl_ProgramToPreset(program);
+    if (preset < 0)
+    {
+        Serial.printf("program %u not available\n", program);
+        return;
+    }
+
+    int32_t slot = presetCache_Find(preset);
+    if (slot >= 0)
+    {
+        cacheHitCnt++;
+        cacheEntries[slot].lastUse = ++cacheTick;
+        chPending[ch] = PRESET_CACHE_NONE;
+        chPreset[ch] = preset;
+        presetCache_Select(ch);
+        return;
+    }
+
+    cacheMissCnt++;
+    chPending[ch] = preset;
+    if (presetCache_GetLoadState() == PRESET_CACHE_LOAD_IDLE)
+    {
+        presetCache_RequestNext();
+    }
+}
+
+/*
+ * to be called by the audio core at the start of each block before the MIDI processing
+ * completes the loads and selects the instruments of the channels
+ */
+void PresetCache_Process(void)
+{
+    if (!PresetCache_IsActive())
+    {
+        return;
+    }
+
+    if (!LoadJob_IsBusy())
+    {
+        presetCache_LoadFinished();
+
+        for (uint32_t ch = 0; ch < PRESET_CACHE_CH_CNT; ch++)
+        {
+            int32_t slot = (chPending[ch] != PRESET_CACHE_NONE) ? presetCache_Find(chPending[ch]) : -1;
+            if (slot >= 0)
+            {
+                /* the deferred program change */
+                cacheEntries[slot].lastUse = ++cacheTick;
+                chPreset[ch] = chPending[ch];
+                chPending[ch] = PRESET_CACHE_NONE;
+            }
+        }
+
+        if (presetCache_GetLoadState() == PRESET_CACHE_LOAD_IDLE)
+        {
+            presetCache_RequestNext();
+        }
+    }
+
+    for (uint32_t ch = 0; ch < PRESET_CACHE_CH_CNT; ch++)
+    {
+        presetCache_Select(ch);
+    }
+}
+
+/*
+ * executed by the loader (SoundFontSamplerCtrl(PRESET_CACHE_CTRL)), loads the requested preset
+ */
+void PresetCache_LoadPending(void)
+{
+    if (!PresetCache_IsActive() || (presetCache_GetLoadState() != PRESET_CACHE_LOAD_REQUESTED))
+    {
+        return;
+    }
+
+    uint32_t list[1] = {cacheLoadPreset};
+    uint32_t bytes = SF2ToSmpl_PresetsCompactSize(cacheFsId, cacheFilename, list, 1);
+
+    if ((bytes == 0) || (bytes > cacheCapacity))
+    {
+        Serial.printf("preset %u cannot be loaded (%" PRIu32 " bytes)\n", cacheLoadPreset, bytes);
+        presetCache_SetLoadState(PRESET_CACHE_LOAD_FAILED);
+        return;
+    }
+
+    cacheLoadBytes = bytes;
+    LoadJob_Sync(presetCache_Evict);
+
+    switch (cacheEvictResult)
+    {
+    case PRESET_CACHE_EVICT_IN_USE:
+        Serial.printf("preset %u does not fit, all cached presets are in use\n", cacheLoadPreset);
+        presetCache_SetLoadState(PRESET_CACHE_LOAD_FAILED);
+        return;
+
+    case PRESET_CACHE_EVICT_WAIT:
+        Serial.printf("preset %u waits for the compaction of the arena\n", cacheLoadPreset);
+        presetCache_SetLoadState(PRESET_CACHE_LOAD_WAIT_FREE);
+        return;
+
+    case PRESET_CACHE_EVICT_REBUILD:
+        {
+            /* the remaining presets keep their order, the new one is appended */
+            uint32_t presets[PRESET_CACHE_SLOTS];
+            uint32_t cnt = 0;
+            for (uint32_t i = 0; i < cacheCnt; i++)
+            {
+                presets[cnt++] = cacheEntries[i].preset;
+            }
+            presets[cnt++] = cacheLoadPreset;
+
+            LoadJob_Sync(presetCache_ClearSamples);
+            SF2ToSmpl_LoadPresetsCompact(cacheFsId, cacheFilename, presets, cnt);
+        }
+        break;
+
+    default:
+        SF2ToSmpl_LoadPresetsCompact(cacheFsId, cacheFilename, list, 1);
+        break;
+    }
+
+    presetCache_SetLoadState(PRESET_CACHE_LOAD_DONE);
+}
+
+/*
+ * serial command: "cache" prints the cached presets
+ */
+void PresetCache_Cmd(const char *args __attribute__((unused)))
+{
+    if (!PresetCache_IsActive())
+    {
+        Serial.printf("preset cache not active\n");
+        return;
+    }
+
+    static const char *loadNames[] = { "idle", "requested", "done", "failed", "waiting for the compaction" };
+    Serial.printf("preset cache: %s, %" PRIu32 " of %" PRIu32 " kB used\n", cacheFilename, cacheBytes / 1024, cacheCapacity / 1024);
+    Serial.printf("hits: %" PRIu32 ", misses: %" PRIu32 ", evicted: %" PRIu32 ", load: %s\n", cacheHitCnt, cacheMissCnt, cacheEvictCnt,
+                  loadNames[presetCache_GetLoadState()]);
+    for (uint32_t i = 0; i < cacheCnt; i++)
+    {
+        Serial.printf("  [%" PRIu32 "] preset %u: %" PRIu32 " kB, last use %" PRIu32 "%s\n", i, cacheEntries[i].preset,
+                      cacheEntries[i].bytes / 1024, cacheEntries[i].lastUse, presetCache_InUse(cacheEntries[i].preset) ? " (selected)" : "");
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file preset_cache.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the on-demand preset loading with LRU eviction
+ */
+
+
+#ifndef PRESET_CACHE_H_
+#define PRESET_CACHE_H_
+
+
+#include <stdint.h>
+
+#include "fs/fs_access.h"
+
+
+/*
+ * defines
+ */
+#define PRESET_CACHE_CTRL   100 /*!< load request of the preset cache, see PresetCache_LoadPending */
+
+
+/*
+ * declarations
+ */
+bool PresetCache_Enable(fs_id_t fs_id, const char *filename, uint32_t capacity);
+void PresetCache_Disable(void);
+bool PresetCache_IsActive(void);
+void PresetCache_ProgramChange(uint8_t ch, uint8_t program);
+void PresetCache_Process(void);
+void PresetCache_LoadPending(void);
+void PresetCache_Cmd(const char *args);
+
+
+#endif /* PRESET_CACHE_H_ */
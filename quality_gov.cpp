@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file quality_gov.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Adaptive quality governor of the HQ effect paths
+ * @n       When the render time of the blocks gets close to the deadline the effects are switched
+ * @n       one by one to their normal variant. When there is enough headroom for a while they are switched back.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "app.h"
+#include "quality_gov.h"
+
+#include <ml_status.h>
+
+
+/*
+ * defines
+ */
+#define QGOV_DOWN_PERCENT   85 /*!< render time in percent of the budget to step down */
+#define QGOV_DOWN_BLOCKS    2 /*!< consecutive blocks above the threshold required to step down */
+#define QGOV_UP_PERCENT     60 /*!< render time in percent of the budget to step up */
+#define QGOV_UP_SAMPLES     SAMPLE_RATE /*!< time below the threshold in samples required to step up (1s) */
+#define QGOV_LEVEL_CNT      (sizeof(qgovLevels) / sizeof(qgovLevels[0]))
+
+
+/*
+ * data types
+ */
+struct qgov_level_s
+{
+    const char *name;
+    uint32_t hqMask;
+};
+
+
+/*
+ * static variables
+ */
+
+/* the effects are stepped down in this order and back up in reverse order */
+static const struct qgov_level_s qgovLevels[] =
+{
+    {"all HQ", APP_CHAIN_PHASER_HQ | APP_CHAIN_VIBRATO_HQ | APP_CHAIN_PITCH_SHIFTER_HQ},
+    {"pitch shifter LQ", APP_CHAIN_PHASER_HQ | APP_CHAIN_VIBRATO_HQ},
+    {"pitch shifter + vibrato LQ", APP_CHAIN_PHASER_HQ},
+    {"all LQ", 0},
+};
+
+static volatile enum qgov_mode_e qgovMode = QGOV_MODE_AUTO;
+static volatile uint32_t qgovLevel = 0;
+static uint32_t qgovDownCnt = 0;
+static uint32_t qgovUpCnt = 0; /*!< samples below the threshold */
+static uint32_t qgovSteps = 0;
+
+
+/*
+ * static function declarations
+ */
+static void qualityGov_SetLevel(uint32_t level);
+
+
+/*
+ * static function definitions
+ */
+static void qualityGov_SetLevel(uint32_t level)
+{
+    if (level != qgovLevel)
+    {
+        qgovLevel = level;
+        qgovSteps++;
+        Status_ValueChangedStr("Quality", "Effects", qgovLevels[level].name);
+    }
+    qgovDownCnt = 0;
+    qgovUpCnt = 0;
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * to be called once per block with the render time and the budget in cycles and the block length
+ */
+void QualityGov_Process(uint32_t render, uint32_t budget, uint32_t len)
+{
+    if (qgovMode != QGOV_MODE_AUTO)
+    {
+        return;
+    }
+
+    uint64_t render100 = ((uint64_t)render) * 100;
+
+    if (render100 > ((uint64_t)budget) * QGOV_DOWN_PERCENT)
+    {
+        qgovUpCnt = 0;
+        qgovDownCnt++;
+        if ((qgovDownCnt >= QGOV_DOWN_BLOCKS) && (qgovLevel < QGOV_LEVEL_CNT - 1))
+        {
+            qualityGov_SetLevel(qgovLevel + 1);
+        }
+    }
+    else if (render100 < ((uint64_t)budget) * QGOV_UP_PERCENT)
+    {
+        qgovDownCnt = 0;
+        qgovUpCnt += len;
+        if ((qgovUpCnt >= QGOV_UP_SAMPLES) && (qgovLevel > 0))
+        {
+            qualityGov_SetLevel(qgovLevel - 1);
+        }
+    }
+    else
+    {
+        qgovDownCnt = 0;
+        qgovUpCnt = 0;
+    }
+}
+
+/*
+ * returns the effects which shall use the HQ variant (APP_CHAIN_..._HQ)
+ */
+uint32_t QualityGov_GetHqMask(void)
+{
+    return qgovLevels[qgovLevel].hqMask;
+}
+
+void QualityGov_SetMode(enum qgov_mode_e mode)
+{
+    qgovMode = mode;
+    switch (mode)
+    {
+    case QGOV_MODE_HQ:
+        qualityGov_SetLevel(0);
+        break;
+    case QGOV_MODE_LQ:
+        qualityGov_SetLevel(QGOV_LEVEL_CNT - 1);
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * serial command: "gov" prints the state, "gov auto", "gov hq", "gov lq" select the mode
+ */
+void QualityGov_Cmd(const char *args)
+{
+    if (strcmp(args, "auto") == 0)
+    {
+        QualityGov_SetMode(QGOV_MODE_AUTO);
+    }
+    else if (strcmp(args, "hq") == 0)
+    {
+        QualityGov_SetMode(QGOV_MODE_HQ);
+    }
+    else if (strcmp(args, "lq") == 0)
+    {
+        QualityGov_SetMode(QGOV_MODE_LQ);
+    }
+
+    Serial.printf("quality governor: %s, level %" PRIu32 " (%s), %" PRIu32 " steps\n",
+                  (qgovMode == QGOV_MODE_AUTO) ? "auto" : ((qgovMode == QGOV_MODE_HQ) ? "hq" : "lq"),
+                  qgovLevel, qgovLevels[qgovLevel].name, qgovSteps);
+}
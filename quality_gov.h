@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file quality_gov.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the adaptive quality governor of the HQ effect paths
+ */
+
+
+#ifndef QUALITY_GOV_H_
+#define QUALITY_GOV_H_
+
+
+#include <stdint.h>
+
+
+/*
+ * data types
+ */
+enum qgov_mode_e
+{
+    QGOV_MODE_AUTO, /*!< quality follows the measured render time */
+    QGOV_MODE_HQ, /*!< all effects use the HQ variant */
+    QGOV_MODE_LQ, /*!< all effects use the normal variant */
+};
+
+
+/*
+ * declarations
+ */
+void QualityGov_Process(uint32_t render, uint32_t budget, uint32_t len);
+uint32_t QualityGov_GetHqMask(void);
+void QualityGov_SetMode(enum qgov_mode_e mode);
+void QualityGov_Cmd(const char *args);
+
+
+#endif /* QUALITY_GOV_H_ */
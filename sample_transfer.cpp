@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file sample_transfer.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Bulk transfer of sample data from a file to the sampler
+ * @n       The sample data is read in large 32 bit aligned blocks and passed with a single call
+ * @n       of Sampler_AddSamples per block. This reduces the calls into the file system and the
+ * @n       sampler by a factor of 64 compared to the previous 256 byte blocks.
+ * @n       The block is allocated for the duration of the transfer only.
+ * @n       16 bit mono data loaded into the hot swap banks or the arena is read directly into the
+ * @n       sample memory of the sketch, the block is only used for the memory of the sampler library.
+ * @n       All sample data of the loaders passes this module, so it is also recorded here for a
+ * @n       snapshot of the sample memory (see smpl_snapshot.cpp).
+ * @n       The samples added to the sampler are counted to plan a load against the free memory
+ * @n       before any data will be copied (see SampleTransfer_GetFreeBytes).
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "sample_transfer.h"
+#include "smpl_snapshot.h"
+#include "load_job.h"
+#include "hot_swap.h"
+#include "load_step.h"
+#include "smpl_arena.h"
+#include "app.h"
+
+#include <ml_types.h>
+#include <ml_sampler.h>
+#include <fs/fs_access.h>
+
+
+/*
+ * defines
+ */
+//#define SAMPLE_TRANSFER_INFO_MESSAGES /*!< prints the duration of each transfer */
+
+
+/*
+ * static function declarations
+ */
+static bool sampleTransfer_ReadDirect(uint32_t byteCnt);
+
+
+/*
+ * static variables
+ */
+static uint32_t sampleTransferUsed = 0; /*!< samples added to the sampler since the sample memory has been cleared */
+static bool sampleTransferOpen = false;
+
+
+/*
+ * static function definitions
+ */
+
+/*
+ * reads 16 bit mono samples into the memory reserved by the hot swap bank or the arena
+ */
+static bool sampleTransfer_ReadDirect(uint32_t byteCnt)
+{
+#ifdef SAMPLE_TRANSFER_INFO_MESSAGES
+    uint32_t startTime = millis();
+#endif
+    uint32_t bytesLeft = byteCnt & ~1UL;
+    bool ret = true;
+
+    while (bytesLeft > 0)
+    {
+        uint32_t bytes = (bytesLeft > SAMPLE_TRANSFER_BLOCK_BYTES) ? SAMPLE_TRANSFER_BLOCK_BYTES : bytesLeft;
+        uint32_t cnt = bytes / sizeof(Q1_14);
+        Q1_14 *dst = HotSwap_IsLoading() ? HotSwap_ReserveSamples(cnt) : SmplArena_ReserveSamples(cnt);
+        if (dst == NULL)
+        {
+            Serial.printf("Failed to add %" PRIu32 " bytes, %" PRIu32 " bytes left\n", bytes, bytesLeft);
+            ret = false;
+            break;
+        }
+        /* the reserved samples would keep the old data after a short read */
+        if (readBytes((uint8_t *)dst, bytes) != bytes)
+        {
+            Serial.printf("readError, %" PRIu32 " bytes left\n", bytesLeft);
+            ret = false;
+            break;
+        }
+        LoadJob_Samples(cnt);
+        SmplSnapshot_Samples(dst, cnt);
+        bytesLeft -= bytes;
+    }
+
+#ifdef SAMPLE_TRANSFER_INFO_MESSAGES
+    Serial.printf("transferred %" PRIu32 " kB in %" PRIu32 " ms (direct)\n", (byteCnt - bytesLeft) / 1024, millis() - startTime);
+#endif
+
+    return ret;
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * to be called when the sample memory has been cleared (0) or replaced by a mapped image
+ */
+void SampleTransfer_SetMemUsed(uint32_t cnt)
+{
+    sampleTransferUsed = cnt;
+}
+
+/*
+ * returns the bytes of sample memory which can be filled by the next load
+ * the samples of a stepped load which has been planned but not loaded yet are already subtracted
+ */
+uint32_t SampleTransfer_GetFreeBytes(void)
+{
+    uint32_t freeCnt;
+
+    if (!HotSwap_GetFree(&freeCnt) && !SmplArena_GetFree(&freeCnt))
+    {
+        uint32_t size = App_GetSampleMemSize() / sizeof(Q1_14);
+        freeCnt = (sampleTransferUsed < size) ? (size - sampleTransferUsed) : 0;
+    }
+
+    uint32_t pendingCnt = LoadStep_PendingCnt();
+    freeCnt = (pendingCnt < freeCnt) ? (freeCnt - pendingCnt) : 0;
+
+    return freeCnt * sizeof(Q1_14);
+}
+
+/*
+ * starts a transfer, the positions of the following samples are relative to its start
+ */
+void SampleTransfer_Start(void)
+{
+    App_StopSampleMemClear();
+    if (!HotSwap_TransferStart() && !LoadStep_TransferStart() && !SmplArena_TransferStart() && !LoadJob_TransferStart())
+    {
+        Sampler_StartTransfer();
+    }
+    SmplSnapshot_TransferStart();
+    sampleTransferOpen = true;
+}
+
+void SampleTransfer_End(void)
+{
+    sampleTransferOpen = false;
+    if (!HotSwap_TransferEnd() && !SmplArena_TransferEnd() && !LoadJob_TransferEnd() && !LoadStep_IsPlanning())
+    {
+        Sampler_EndTransfer();
+    }
+}
+
+/*
+ * true between SampleTransfer_Start and SampleTransfer_End
+ */
+bool SampleTransfer_IsOpen(void)
+{
+    return sampleTransferOpen;
+}
+
+/*
+ * adds samples which are already in memory
+ */
+bool SampleTransfer_Add(Q1_14 *samples, uint32_t cnt)
+{
+    if (LoadStep_IsPlanning())
+    {
+        return LoadStep_AddSamples((uint8_t *)samples, cnt * sizeof(Q1_14), SAMPLE_TRANSFER_S16);
+    }
+
+    bool added;
+    if (HotSwap_IsLoading())
+    {
+        added = HotSwap_AddSamples(samples, cnt);
+    }
+    else if (SmplArena_IsLoading())
+    {
+        added = SmplArena_AddSamples(samples, cnt);
+    }
+    else
+    {
+        added = Sampler_AddSamples(samples, cnt);
+        if (added)
+        {
+            sampleTransferUsed += cnt;
+        }
+    }
+    if (!added)
+    {
+        return false;
+    }
+    LoadJob_Samples(cnt);
+    SmplSnapshot_Samples(samples, cnt);
+    return true;
+}
+
+/*
+ * adds 8 bit samples, converted by the sampler
+ */
+bool SampleTransfer_AddU8(uint8_t *samples, uint32_t cnt)
+{
+    if (LoadStep_IsPlanning())
+    {
+        return LoadStep_AddSamples(samples, cnt, SAMPLE_TRANSFER_U8);
+    }
+
+    /* the converted data is not visible to the snapshot */
+    SmplSnapshot_Invalidate("8 bit sample data");
+    bool added;
+    if (HotSwap_IsLoading())
+    {
+        added = HotSwap_AddSamplesU8(samples, cnt);
+    }
+    else if (SmplArena_IsLoading())
+    {
+        added = SmplArena_AddSamplesU8(samples, cnt);
+    }
+    else
+    {
+        added = Sampler_AddSamplesU8(samples, cnt);
+        if (added)
+        {
+            sampleTransferUsed += cnt;
+        }
+    }
+    if (!added)
+    {
+        return false;
+    }
+    LoadJob_Samples(cnt);
+    return true;
+}
+
+/*
+ * converts the block in place and adds its samples
+ */
+bool SampleTransfer_AddBlock(uint8_t *block, uint32_t byteCnt, enum sample_transfer_fmt_e fmt)
+{
+    Q1_14 *samples = (Q1_14 *)block;
+
+    switch (fmt)
+    {
+    case SAMPLE_TRANSFER_U8:
+        return SampleTransfer_AddU8(block, byteCnt);
+
+    case SAMPLE_TRANSFER_S16_STEREO:
+        for (uint32_t i = 0; i < byteCnt / 4; i++)
+        {
+            samples[i] = samples[2 * i];
+        }
+        return SampleTransfer_Add(samples, byteCnt / 4);
+
+    default:
+        return SampleTransfer_Add(samples, byteCnt / 2);
+    }
+}
+
+/*
+ * reads 16 bit samples from the current position of the opened file and adds them to the sampler
+ * SampleTransfer_Start must be called before
+ */
+bool SampleTransfer_Read(uint32_t byteCnt)
+{
+    return SampleTransfer_ReadFmt(byteCnt, SAMPLE_TRANSFER_S16);
+}
+
+/*
+ * reads samples of the given format from the current position of the opened file
+ * while a stepped load is planned only the position of the data will be recorded
+ */
+bool SampleTransfer_ReadFmt(uint32_t byteCnt, enum sample_transfer_fmt_e fmt)
+{
+    if (LoadStep_IsPlanning())
+    {
+        return LoadStep_Read(byteCnt, fmt);
+    }
+
+    if ((fmt == SAMPLE_TRANSFER_S16) && (HotSwap_IsLoading() || SmplArena_IsLoading()))
+    {
+        /* the sample memory belongs to the sketch, no bounce buffer required */
+        return sampleTransfer_ReadDirect(byteCnt);
+    }
+
+    uint32_t blockBytes = SAMPLE_TRANSFER_BLOCK_BYTES;
+    Q1_14 *block = NULL;
+    bool ret = true;
+
+    while (blockBytes > byteCnt && blockBytes > SAMPLE_TRANSFER_BLOCK_MIN_BYTES)
+    {
+        blockBytes /= 2;
+    }
+
+    while ((block == NULL) && (blockBytes >= SAMPLE_TRANSFER_BLOCK_MIN_BYTES))
+    {
+        block = (Q1_14 *)malloc(blockBytes);
+        if (block == NULL)
+        {
+            blockBytes /= 2;
+        }
+    }
+
+    if (block == NULL)
+    {
+        Serial.printf("Not able to allocate a transfer block!\n");
+        return false;
+    }
+
+#ifdef SAMPLE_TRANSFER_INFO_MESSAGES
+    uint32_t startTime = millis();
+#endif
+    uint32_t bytesLeft = byteCnt;
+
+    while (bytesLeft > 0)
+    {
+        uint32_t bytesRead = readBytes((uint8_t *)block, (bytesLeft > blockBytes) ? blockBytes : bytesLeft);
+        if (bytesRead == 0)
+        {
+            Serial.printf("readError, %" PRIu32 " bytes left\n", bytesLeft);
+            ret = false;
+            break;
+        }
+        if (!SampleTransfer_AddBlock((uint8_t *)block, bytesRead, fmt))
+        {
+            Serial.printf("Failed to add %" PRIu32 " bytes, %" PRIu32 " bytes left\n", bytesRead, bytesLeft);
+            ret = false;
+            break;
+        }
+        bytesLeft -= bytesRead;
+    }
+
+    free(block);
+
+#ifdef SAMPLE_TRANSFER_INFO_MESSAGES
+    uint32_t duration = millis() - startTime;
+    Serial.printf("transferred %" PRIu32 " kB in %" PRIu32 " ms (%" PRIu32 " byte blocks)\n", (byteCnt - bytesLeft) / 1024, duration, blockBytes);
+#endif
+
+    return ret;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file sample_transfer.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the bulk transfer of sample data from a file to the sampler
+ */
+
+
+#ifndef SAMPLE_TRANSFER_H_
+#define SAMPLE_TRANSFER_H_
+
+
+#include <ml_types.h>
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#define SAMPLE_TRANSFER_BLOCK_BYTES     (16 * 1024) /*!< size of one read, will be reduced when the memory is not available */
+#define SAMPLE_TRANSFER_BLOCK_MIN_BYTES 256
+
+
+/*
+ * data types
+ */
+enum sample_transfer_fmt_e
+{
+    SAMPLE_TRANSFER_S16, /*!< mono 16 bit, passed without conversion */
+    SAMPLE_TRANSFER_S16_STEREO, /*!< stereo 16 bit, only the left channel is used */
+    SAMPLE_TRANSFER_U8, /*!< mono unsigned 8 bit */
+};
+
+
+/*
+ * declarations
+ */
+void SampleTransfer_Start(void);
+void SampleTransfer_End(void);
+bool SampleTransfer_IsOpen(void);
+bool SampleTransfer_Add(Q1_14 *samples, uint32_t cnt);
+bool SampleTransfer_AddU8(uint8_t *samples, uint32_t cnt);
+bool SampleTransfer_AddBlock(uint8_t *block, uint32_t byteCnt, enum sample_transfer_fmt_e fmt);
+bool SampleTransfer_Read(uint32_t byteCnt);
+bool SampleTransfer_ReadFmt(uint32_t byteCnt, enum sample_transfer_fmt_e fmt);
+void SampleTransfer_SetMemUsed(uint32_t cnt);
+uint32_t SampleTransfer_GetFreeBytes(void);
+
+
+#endif /* SAMPLE_TRANSFER_H_ */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file serial_cmd.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Simple line based command console on the serial port
+ * @n       The available commands are listed in serialCmdMapping (z_config.ino)
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "serial_cmd.h"
+
+
+/*
+ * defines
+ */
+#define SERIAL_CMD_LINE_LEN 64
+
+
+/*
+ * static function declarations
+ */
+static void serialCmd_Execute(char *line);
+
+
+/*
+ * static variables
+ */
+static char serialCmdLine[SERIAL_CMD_LINE_LEN];
+static uint32_t serialCmdLineLen = 0;
+
+
+/*
+ * static function definitions
+ */
+static void serialCmd_Execute(char *line)
+{
+    char *args = strchr(line, ' ');
+    if (args != NULL)
+    {
+        *args = 0;
+        args++;
+        while (*args == ' ')
+        {
+            args++;
+        }
+    }
+    else
+    {
+        args = &line[strlen(line)];
+    }
+
+    for (uint32_t i = 0; i < serialCmdMapping.cmdCnt; i++)
+    {
+        if (strcmp(line, serialCmdMapping.cmds[i].name) == 0)
+        {
+            serialCmdMapping.cmds[i].cmd(args);
+            return;
+        }
+    }
+
+    Serial.printf("available commands:\n");
+    for (uint32_t i = 0; i < serialCmdMapping.cmdCnt; i++)
+    {
+        Serial.printf("  %-8s %s\n", serialCmdMapping.cmds[i].name, serialCmdMapping.cmds[i].help);
+    }
+}
+
+
+/*
+ * extern function definitions
+ */
+void SerialCmd_Loop(void)
+{
+    while (Serial.available() > 0)
+    {
+        int c = Serial.read();
+        if ((c == '\n') || (c == '\r'))
+        {
+            if (serialCmdLineLen > 0)
+            {
+                serialCmdLine[serialCmdLineLen] = 0;
+                serialCmdLineLen = 0;
+                serialCmd_Execute(serialCmdLine);
+            }
+        }
+        else if ((c >= 0) && (serialCmdLineLen < SERIAL_CMD_LINE_LEN - 1))
+        {
+            serialCmdLine[serialCmdLineLen++] = c;
+        }
+    }
+}
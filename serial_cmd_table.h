@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file serial_cmd_table.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Entries of the serial console commands, shared by z_config.ino and the host build
+ * @n       The file is included within the initializer of serialCmds[] and has no include guard.
+ * @n       The headers of the commands must be included before.
+ */
+
+
+    { "block", "block size in samples (block 16|32|48|128)", App_BlockCmd },
+    { "perf", "stage timing of the audio loop (perf reset: clear)", PerfMon_Cmd },
+    { "xrun", "late blocks and underruns (xrun reset: clear)", XrunMon_Cmd },
+    { "gov", "quality governor of the HQ effects (gov auto|hq|lq)", QualityGov_Cmd },
+    { "voice", "voice stealing state and policy (voice oldest|quietest|samenote)", VoiceAlloc_Cmd },
+    { "cache", "presets loaded on demand by program change", PresetCache_Cmd },
+    { "sf2", "presets of a soundfont on the SD card (sf2 /file.sf2)", SF2Index_Cmd },
+    { "load", "state of the load job (load <n>: SoundFontSamplerCtrl(n))", LoadJob_Cmd },
+    { "swap", "state of the hot swap banks", HotSwap_Cmd },
+    { "arena", "entries of the sample memory arena (arena free <n>: unloads entry n)", SmplArena_Cmd },
+    { "midiq", "MIDI queue between the cores, filled by USB MIDI (midiq reset)", MidiQueue_Cmd },
+#ifdef STREAM_VOICE_ACTIVE
+    { "stream", "voices streaming from the file system (stream reset, stream codec <pcm|ulaw|adpcm> for the streamed samples)", StreamVoice_Cmd },
+#endif
+#ifdef DUAL_RENDER_ACTIVE
+    { "dual", "load of the render core (dual reset)", DualRender_Cmd },
+#endif
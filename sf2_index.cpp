@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file sf2_index.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Index of the presets of a soundfont stored next to the soundfont
+ * @n       Walking a preset with ML_SF2_LoadPresetMultiBag reads and resolves the preset, instrument
+ * @n       and sample headers (pdta) of the soundfont again for every preset.
+ * @n       The index stores the resolved zones of all presets (struct instrLoadInfo_s) together with
+ * @n       the preset names and the soundfont info. It is written on the first open of a soundfont
+ * @n       and used as long as size and last write of the soundfont are unchanged.
+ * @n       With the index the presets can be listed and walked without parsing the soundfont.
+ * @n       Layout: header, soundfont info, preset table, zones.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "sf2_index.h"
+#include "sf_to_sampler.h"
+#include "load_job.h"
+
+#ifdef ML_HOST_BUILD
+#include <stdio.h>
+#include <sys/stat.h>
+#elif defined ESP32
+#include <FS.h>
+#include <SD_MMC.h>
+#include <LittleFS.h>
+#define SF2_INDEX_FILE
+#elif defined ARDUINO_ARCH_RP2040
+#include <LittleFS.h>
+#define SF2_INDEX_FILE
+#endif
+
+
+/*
+ * defines
+ */
+#define SF2_INDEX_PATH_LEN  128
+
+
+/*
+ * static variables
+ */
+#ifdef ML_HOST_BUILD
+static FILE *indexFile = NULL;
+#elif defined SF2_INDEX_FILE
+static File indexFile;
+#endif
+
+static bool indexValid = false;
+static bool indexPending = false; /*!< the index will be built after the soundfont has been parsed */
+static fs_id_t indexFsId;
+static char indexPath[SF2_INDEX_PATH_LEN];
+
+static struct sf2_index_hdr_s indexHdr;
+static struct sf2_soundfont_info_s indexInfo;
+static struct sf2_index_preset_s *indexPresets = NULL;
+static uint32_t indexPresetCap = 0;
+
+static uint32_t indexBuildPreset = 0;
+static bool indexBuildOk = false;
+
+
+/*
+ * static function definitions
+ */
+
+/*
+ * returns size and last write of the soundfont, the last write is 0 if not supported
+ */
+static bool sf2Index_Stat(fs_id_t fs_id, const char *filename, uint32_t *size, uint32_t *time)
+{
+#ifdef ML_HOST_BUILD
+    FILE *file = HostFs_OpenStream(fs_id, filename, "rb");
+    struct stat st;
+    bool ret = (file != NULL) && (fstat(fileno(file), &st) == 0);
+    if (ret)
+    {
+        *size = st.st_size;
+        *time = st.st_mtime;
+    }
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+    return ret;
+#elif defined SF2_INDEX_FILE
+#ifdef ESP32
+    File file = (fs_id == FS_ID_SD_MMC) ? SD_MMC.open(filename) : LittleFS.open(filename, "r");
+#else
+    (void)fs_id;
+    File file = LittleFS.open(filename, "r");
+#endif
+    if (!file)
+    {
+        return false;
+    }
+    *size = file.size();
+    *time = file.getLastWrite();
+    file.close();
+    return true;
+#else
+    (void)fs_id;
+    (void)filename;
+    (void)size;
+    (void)time;
+    return false;
+#endif
+}
+
+static bool sf2Index_FileOpen(bool write)
+{
+#ifdef ML_HOST_BUILD
+    indexFile = HostFs_OpenStream(indexFsId, indexPath, write ? "wb" : "rb");
+    return indexFile != NULL;
+#elif defined ESP32
+    const char *mode = write ? FILE_WRITE : FILE_READ;
+    indexFile = (indexFsId == FS_ID_SD_MMC) ? SD_MMC.open(indexPath, mode) : LittleFS.open(indexPath, mode);
+    return (bool)indexFile;
+#elif defined ARDUINO_ARCH_RP2040
+    indexFile = LittleFS.open(indexPath, write ? "w" : "r");
+    return (bool)indexFile;
+#else
+    (void)write;
+    return false;
+#endif
+}
+
+static void sf2Index_FileClose(void)
+{
+#ifdef ML_HOST_BUILD
+    if (indexFile != NULL)
+    {
+        fclose(indexFile);
+        indexFile = NULL;
+    }
+#elif defined SF2_INDEX_FILE
+    indexFile.close();
+#endif
+}
+
+static bool sf2Index_FileSeek(uint32_t pos)
+{
+#ifdef ML_HOST_BUILD
+    return fseek(indexFile, pos, SEEK_SET) == 0;
+#elif defined SF2_INDEX_FILE
+    return indexFile.seek(pos);
+#else
+    (void)pos;
+    return false;
+#endif
+}
+
+static bool sf2Index_FileRead(void *data, uint32_t len)
+{
+#ifdef ML_HOST_BUILD
+    return fread(data, 1, len, indexFile) == len;
+#elif defined SF2_INDEX_FILE
+    return indexFile.read((uint8_t *)data, len) == len;
+#else
+    (void)data;
+    (void)len;
+    return false;
+#endif
+}
+
+static bool sf2Index_FileWrite(const void *data, uint32_t len)
+{
+#ifdef ML_HOST_BUILD
+    return fwrite(data, 1, len, indexFile) == len;
+#elif defined SF2_INDEX_FILE
+    return indexFile.write((const uint8_t *)data, len) == len;
+#else
+    (void)data;
+    (void)len;
+    return false;
+#endif
+}
+
+/*
+ * the index of "/name.sf2" is "/name.sfi"
+ */
+static bool sf2Index_SetPath(const char *filename)
+{
+    uint32_t len = strlen(filename);
+    if (len + 5 > sizeof(indexPath))
+    {
+        return false;
+    }
+    strcpy(indexPath, filename);
+    if ((len > 4) && (strcasecmp(&indexPath[len - 4], ".sf2") == 0))
+    {
+        len -= 4;
+    }
+    strcpy(&indexPath[len], ".sfi");
+    return true;
+}
+
+/*
+ * makes sure the preset table has space for cnt entries, new entries are cleared
+ */
+static bool sf2Index_Reserve(uint32_t cnt)
+{
+    if (cnt <= indexPresetCap)
+    {
+        return true;
+    }
+    uint32_t cap = (cnt + 63) & ~63;
+    struct sf2_index_preset_s *presets = (struct sf2_index_preset_s *)realloc(indexPresets, cap * sizeof(struct sf2_index_preset_s));
+    if (presets == NULL)
+    {
+        Serial.printf("Not enough memory for the sf2 index\n");
+        return false;
+    }
+    memset(&presets[indexPresetCap], 0, (cap - indexPresetCap) * sizeof(struct sf2_index_preset_s));
+    indexPresets = presets;
+    indexPresetCap = cap;
+    return true;
+}
+
+static uint32_t sf2Index_ZonesOffset(void)
+{
+    return sizeof(struct sf2_index_hdr_s) + sizeof(struct sf2_soundfont_info_s) + indexHdr.presetCnt * sizeof(struct sf2_index_preset_s);
+}
+
+/*
+ * reads the index and checks if it belongs to the current soundfont
+ */
+static bool sf2Index_Load(uint32_t fileSize, uint32_t fileTime)
+{
+    struct sf2_index_hdr_s hdr;
+
+    if (!sf2Index_FileOpen(false))
+    {
+        return false;
+    }
+
+    if (!sf2Index_FileRead(&hdr, sizeof(hdr))
+        || (hdr.magic != SF2_INDEX_MAGIC) || (hdr.version != SF2_INDEX_VERSION)
+        || (hdr.zoneSize != sizeof(struct instrLoadInfo_s)) || (hdr.infoSize != sizeof(struct sf2_soundfont_info_s))
+        || (hdr.fileSize != fileSize) || (hdr.fileTime != fileTime))
+    {
+        Serial.printf("sf2 index %s outdated\n", indexPath);
+        sf2Index_FileClose();
+        return false;
+    }
+
+    indexHdr = hdr;
+    if (!sf2Index_FileRead(&indexInfo, sizeof(indexInfo))
+        || !sf2Index_Reserve(hdr.presetCnt)
+        || !sf2Index_FileRead(indexPresets, hdr.presetCnt * sizeof(struct sf2_index_preset_s)))
+    {
+        Serial.printf("sf2 index %s truncated\n", indexPath);
+        sf2Index_FileClose();
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * called by ML_SF2_LoadPresetMultiBag while building the index
+ */
+static void sf2Index_CollectZone(struct instrLoadInfo_s *info)
+{
+    if (indexBuildOk && !sf2Index_FileWrite(info, sizeof(*info)))
+    {
+        indexBuildOk = false;
+    }
+    indexPresets[indexBuildPreset].zoneCnt++;
+    indexHdr.zoneCnt++;
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * opens the index of a soundfont, returns false if the index is not available or outdated
+ * in that case the index can be built by SF2Index_Build after opening the soundfont with FS_OpenFile
+ */
+bool SF2Index_Open(fs_id_t fs_id, const char *filename)
+{
+    SF2Index_Close();
+
+    uint32_t fileSize, fileTime;
+    if (!sf2Index_SetPath(filename) || !sf2Index_Stat(fs_id, filename, &fileSize, &fileTime))
+    {
+        return false;
+    }
+    indexFsId = fs_id;
+
+    indexValid = sf2Index_Load(fileSize, fileTime);
+    if (!indexValid)
+    {
+        memset(&indexHdr, 0, sizeof(indexHdr));
+        indexHdr.fileSize = fileSize;
+        indexHdr.fileTime = fileTime;
+        indexPending = true;
+    }
+
+    return indexValid;
+}
+
+/*
+ * walks all presets of the soundfont opened by FS_OpenFile and writes the index
+ */
+bool SF2Index_Build(void)
+{
+    if (!indexPending)
+    {
+        return false;
+    }
+    indexPending = false;
+
+    indexInfo = *ML_SF2_GetSoundFontInfo();
+    uint32_t presetCnt = (indexInfo.phdr_cnt > 0) ? (indexInfo.phdr_cnt - 1) : 0; /* without the terminal record */
+
+    if ((presetCnt > 0xFFFF) || !sf2Index_Reserve(presetCnt) || !sf2Index_FileOpen(true))
+    {
+        Serial.printf("Failed to create sf2 index %s\n", indexPath);
+        return false;
+    }
+
+    struct sf2_index_hdr_s hdr = indexHdr;
+    hdr.magic = 0; /* invalid until completed */
+    indexHdr.presetCnt = presetCnt;
+    indexHdr.zoneCnt = 0;
+
+    indexBuildOk = sf2Index_FileWrite(&hdr, sizeof(hdr))
+                   && sf2Index_FileWrite(&indexInfo, sizeof(indexInfo))
+                   && sf2Index_FileWrite(indexPresets, presetCnt * sizeof(struct sf2_index_preset_s));
+
+    for (uint32_t i = 0; (i < presetCnt) && indexBuildOk; i++)
+    {
+        indexBuildPreset = i;
+        indexPresets[i].firstZone = indexHdr.zoneCnt;
+        indexPresets[i].zoneCnt = 0;
+        indexPresets[i].valid = ML_SF2_LoadPresetMultiBag(i, sf2Index_CollectZone) ? 1 : 0;
+    }
+
+    indexHdr.magic = SF2_INDEX_MAGIC;
+    indexHdr.version = SF2_INDEX_VERSION;
+    indexHdr.zoneSize = sizeof(struct instrLoadInfo_s);
+    indexHdr.infoSize = sizeof(struct sf2_soundfont_info_s);
+
+    indexBuildOk = indexBuildOk
+                   && sf2Index_FileSeek(sizeof(hdr) + sizeof(indexInfo))
+                   && sf2Index_FileWrite(indexPresets, presetCnt * sizeof(struct sf2_index_preset_s))
+                   && sf2Index_FileSeek(0)
+                   && sf2Index_FileWrite(&indexHdr, sizeof(indexHdr));
+    sf2Index_FileClose();
+
+    if (!indexBuildOk)
+    {
+        Serial.printf("Failed to write sf2 index %s\n", indexPath);
+        return false;
+    }
+
+    Serial.printf("sf2 index: %" PRIu32 " presets, %" PRIu32 " zones\n", presetCnt, indexHdr.zoneCnt);
+    indexValid = sf2Index_FileOpen(false);
+    return indexValid;
+}
+
+void SF2Index_Close(void)
+{
+    if (indexValid)
+    {
+        sf2Index_FileClose();
+    }
+    free(indexPresets);
+    indexPresets = NULL;
+    indexPresetCap = 0;
+    indexValid = false;
+    indexPending = false;
+}
+
+bool SF2Index_IsValid(void)
+{
+    return indexValid;
+}
+
+struct sf2_soundfont_info_s *SF2Index_GetSoundFontInfo(void)
+{
+    return &indexInfo;
+}
+
+uint32_t SF2Index_GetPresetCnt(void)
+{
+    return indexValid ? indexHdr.presetCnt : 0;
+}
+
+const struct sf2_index_preset_s *SF2Index_GetPreset(uint32_t idx)
+{
+    return (indexValid && (idx < indexHdr.presetCnt)) ? &indexPresets[idx] : NULL;
+}
+
+/*
+ * same as ML_SF2_LoadPresetMultiBag using the zones of the index
+ */
+bool SF2Index_LoadPresetMultiBag(uint32_t idx, void (*cb)(struct instrLoadInfo_s *info))
+{
+    const struct sf2_index_preset_s *preset = SF2Index_GetPreset(idx);
+    if (preset == NULL)
+    {
+        return false;
+    }
+
+    if (!sf2Index_FileSeek(sf2Index_ZonesOffset() + preset->firstZone * sizeof(struct instrLoadInfo_s)))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < preset->zoneCnt; i++)
+    {
+        struct instrLoadInfo_s info;
+        if (!sf2Index_FileRead(&info, sizeof(info)))
+        {
+            Serial.printf("sf2 index %s truncated\n", indexPath);
+            return false;
+        }
+        cb(&info);
+    }
+
+    return preset->valid != 0;
+}
+
+/*
+ * records the preset headers while the soundfont is parsed, used when the index will be built
+ */
+void SF2Index_PresetIndication(const union preset_hdr_s *preset, uint32_t idx)
+{
+    if (indexPending && sf2Index_Reserve(idx + 1))
+    {
+        memcpy(indexPresets[idx].name, preset->presetName, sizeof(indexPresets[idx].name));
+        indexPresets[idx].preset = preset->preset;
+        indexPresets[idx].bank = preset->bank;
+    }
+}
+
+/*
+ * serial command: "sf2 /file.sf2" lists the presets of a soundfont on the SD card
+ */
+void SF2Index_Cmd(const char *args)
+{
+    if (args[0] == 0)
+    {
+        Serial.printf("usage: sf2 /file.sf2\n");
+        return;
+    }
+
+    if (LoadJob_IsBusy())
+    {
+        /* the loads in steps keep their file open between the blocks */
+        Serial.printf("sf2: not available while loading\n");
+        return;
+    }
+
+    /* builds the index if required */
+    if (!SF2ToSmpl_ScanPresets(FS_ID_SD_MMC, args) || !SF2Index_Open(FS_ID_SD_MMC, args))
+    {
+        Serial.printf("no index of %s available\n", args);
+        SF2Index_Close();
+        return;
+    }
+
+    for (uint32_t i = 0; i < indexHdr.presetCnt; i++)
+    {
+        char name[21] = {0};
+        memcpy(name, indexPresets[i].name, 20);
+        Serial.printf("  [%" PRIu32 "] %03u:%03u %s, %u zones\n", i, indexPresets[i].bank, indexPresets[i].preset, name, indexPresets[i].zoneCnt);
+    }
+    SF2Index_Close();
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file sf2_index.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Index of the presets of a soundfont stored next to the soundfont
+ * @n       See sf2_index.cpp
+ */
+
+
+#ifndef SF2_INDEX_H_
+#define SF2_INDEX_H_
+
+
+/*
+ * includes
+ */
+#include "fs/fs_access.h"
+
+#include <ml_soundfont.h>
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#define SF2_INDEX_MAGIC     0x49534C4D /*!< "MLSI" */
+#define SF2_INDEX_VERSION   1
+
+
+/*
+ * data types
+ */
+struct sf2_index_hdr_s
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t zoneSize; /*!< sizeof(struct instrLoadInfo_s) used by the writer */
+    uint32_t fileSize; /*!< size of the soundfont */
+    uint32_t fileTime; /*!< last write of the soundfont */
+    uint16_t infoSize; /*!< sizeof(struct sf2_soundfont_info_s) used by the writer */
+    uint16_t presetCnt;
+    uint32_t zoneCnt;
+};
+
+struct sf2_index_preset_s
+{
+    char name[20];
+    uint16_t preset;
+    uint16_t bank;
+    uint32_t firstZone;
+    uint16_t zoneCnt;
+    uint16_t valid; /*!< result of ML_SF2_LoadPresetMultiBag */
+};
+
+
+/*
+ * declarations
+ */
+bool SF2Index_Open(fs_id_t fs_id, const char *filename);
+bool SF2Index_Build(void);
+void SF2Index_Close(void);
+bool SF2Index_IsValid(void);
+struct sf2_soundfont_info_s *SF2Index_GetSoundFontInfo(void);
+uint32_t SF2Index_GetPresetCnt(void);
+const struct sf2_index_preset_s *SF2Index_GetPreset(uint32_t idx);
+bool SF2Index_LoadPresetMultiBag(uint32_t idx, void (*cb)(struct instrLoadInfo_s *info));
+void SF2Index_PresetIndication(const union preset_hdr_s *preset, uint32_t idx);
+void SF2Index_Cmd(const char *args);
+
+
+#endif /* SF2_INDEX_H_ */
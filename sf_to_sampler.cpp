@@ -49,6 +49,13 @@
 
 #include "config.h"
 #include "sf_to_sampler.h"
+#include "voice_alloc.h"
+#include "sample_transfer.h"
+#include "stream_voice.h"
+#include "smpl_bank.h"
+#include "smpl_snapshot.h"
+#include "load_step.h"
+#include "sf2_index.h"
 #include "fs/fs_access.h"
 
 #include <ml_types.h>
@@ -57,24 +64,62 @@
 #include <ml_sampler.h>
 
 
-#define SF2_INFO_MESSAGES
+#define SF2_INFO_MESSAGES /*!< suppressed while a load step parses the soundfont, see LoadStep_InStep */
+
+#define SF2_COMPACT_GUARD       8 /*!< samples kept behind the end of a sample for the interpolation */
+#define SF2_COMPACT_MERGE_GAP   256 /*!< ranges closer than this will be merged to avoid seeking */
+
 
 /*
  * data types
  */
-union wavSampleS16
+struct sf2_range_s
 {
-    uint8_t data[256];
-    Q1_14 samples[128];
+    uint32_t start; /*!< first sample in the smpl chunk */
+    uint32_t end; /*!< sample behind the range in the smpl chunk */
+    uint32_t dst; /*!< position in the compact image */
 };
 
+typedef bool (*sf2_walk_fn_t)(uint32_t idx, void (*cb)(struct instrLoadInfo_s *info));
 
 /*
  * static function declarations
  */
 static void TransferSampleData(uint32_t start, uint32_t end);
-static void LoadAllSamples(void);
+static bool LoadAllSamples(void);
 static void LoadSampleFromInfo(struct instrLoadInfo_s *info);
+static void sf2Compact_Collect(struct instrLoadInfo_s *info);
+static uint32_t sf2Compact_Coalesce(void);
+static uint32_t sf2Compact_Relocate(uint32_t pos);
+static void sf2Compact_LoadSample(struct instrLoadInfo_s *info);
+static uint32_t sf2Compact_Plan(sf2_walk_fn_t walk, const uint32_t *list, uint32_t listCnt, uint32_t allCnt);
+static uint32_t sf2Compact_Fit(sf2_walk_fn_t walk, const uint32_t *list, uint32_t cnt, uint32_t budgetCnt, uint32_t *fitList, uint32_t *fitCnt);
+static void sf2Compact_Free(void);
+static void sf2Plan_Report(const char *result, uint32_t selCnt, uint32_t cnt, uint32_t imageCnt, uint32_t budgetCnt);
+static bool sf2Plan_ChunkFits(struct sf2_soundfont_info_s *offset, uint32_t cnt);
+static bool sf2_InstrumentWalk(uint32_t idx, void (*cb)(struct instrLoadInfo_s *info));
+static bool sf2_SampleWalk(uint32_t idx, void (*cb)(struct instrLoadInfo_s *info));
+static bool sf2Compact_Load(sf2_walk_fn_t walk, const uint32_t *list, uint32_t listCnt, uint32_t allCnt);
+static void sf2_MapProgram(uint16_t bank, uint16_t preset, uint32_t idx);
+static bool sf2_OpenFile(fs_id_t fs_id, const char *filename);
+static bool sf2_OpenIndex(fs_id_t fs_id, const char *filename);
+static void sf2_CloseFile(void);
+static struct sf2_soundfont_info_s *sf2_Info(void);
+static sf2_walk_fn_t sf2_PresetWalk(void);
+#ifdef STREAM_VOICE_ACTIVE
+static void sf2Stream_AddSample(struct instrLoadInfo_s *info);
+#endif
+
+
+/*
+ * static variables
+ */
+static struct sf2_range_s *compactRanges = NULL;
+static uint32_t compactRangeCnt = 0;
+static uint32_t compactRangeCap = 0;
+static uint32_t compactSmplCnt = 0; /*!< samples in the smpl chunk */
+
+static uint16_t programPreset[128]; /*!< preset header index + 1 of the programs of bank 0, 0 if not available */
 
 
 /*
@@ -82,41 +127,21 @@ static void LoadSampleFromInfo(struct instrLoadInfo_s *info);
  */
 static void TransferSampleData(uint32_t start, uint32_t end)
 {
-    Sampler_StartTransfer();
-    uint32_t data_to_read = (end - start) * 2;
+    SampleTransfer_Start();
     fileSeekTo((start) * 2 /* + sampleDataFileOffset */);
-
-    wavSampleS16 sampleData;
-    uint32_t bytesRead;
-
-    while (data_to_read > 0)
-    {
-        if (data_to_read >= 256)
-        {
-            bytesRead = readBytes(sampleData.data, 256);
-        }
-        else
-        {
-            bytesRead = readBytes(sampleData.data, data_to_read);
-        }
-        if (Sampler_AddSamples(sampleData.samples, bytesRead / 2))
-        {
-            //Serial.printf("added %d samples, %u left\n", bytesRead, data_to_read);
-        }
-        else
-        {
-            Serial.printf("Failed to add %" PRIu32 " samples, %" PRIu32 " left\n", bytesRead, data_to_read);
-            break;
-        }
-        data_to_read -= bytesRead;
-    }
-    Sampler_EndTransfer();
+    SampleTransfer_Read((end - start) * 2);
+    SampleTransfer_End();
 }
 
-static void LoadAllSamples(void)
+static bool LoadAllSamples(void)
 {
     struct sf2_soundfont_info_s *offset = ML_SF2_GetSoundFontInfo();
 
+    if (!sf2Plan_ChunkFits(offset, offset->shdr_cnt - 1))
+    {
+        return sf2Compact_Load(sf2_SampleWalk, NULL, 0, offset->shdr_cnt - 1);
+    }
+
     TransferSampleData(offset->smpl / 2, offset->smpl / 2 + offset->smpl_cnt / 2);
 
     for (uint32_t i = 0; i < offset->shdr_cnt - 1; i++)
@@ -125,9 +150,10 @@ static void LoadAllSamples(void)
         if (ML_SF2_LoadSamplesFromInfo(i, &info))
         {
             LoadSampleFromInfo(&info);
-            Sampler_InstrumentDone();
+            SmplBank_InstrumentDone();
         }
     }
+    return true;
 }
 
 static void SF2ToSmpl_LoadAllInstrumentsMultiCB(struct instrLoadInfo_s *infoPtr)
@@ -148,84 +174,460 @@ static void LoadSampleFromInfo(struct instrLoadInfo_s *info)
         return;
     }
 
-    if (Sampler_NewSample())
+    struct smpl_region_s region;
+    SF2ToSmpl_RegionFromInfo(info, &region);
+    SmplBank_ApplyRegion(&region);
+}
+
+
+/*
+ * first pass: records the range used by a sample including its loop
+ */
+static void sf2Compact_Collect(struct instrLoadInfo_s *info)
+{
+    if ((info->start == 0) && (info->end == 0))
+    {
+        return;
+    }
+
+    if (compactRangeCnt >= compactRangeCap)
+    {
+        uint32_t cap = (compactRangeCap > 0) ? (compactRangeCap * 2) : 64;
+        struct sf2_range_s *ranges = (struct sf2_range_s *)realloc(compactRanges, cap * sizeof(struct sf2_range_s));
+        if (ranges == NULL)
+        {
+            Serial.printf("Not enough memory to collect the sample ranges!\n");
+            return;
+        }
+        compactRanges = ranges;
+        compactRangeCap = cap;
+    }
+
+    struct sf2_range_s *range = &compactRanges[compactRangeCnt++];
+    range->start = info->start;
+    range->end = info->end + SF2_COMPACT_GUARD;
+    if ((info->sampleModus == 1) || (info->sampleModus == 3))
+    {
+        /* the loop points of unlooped zones are not used */
+        range->start = (info->startLoop < range->start) ? info->startLoop : range->start;
+        range->end = (info->endLoop + SF2_COMPACT_GUARD > range->end) ? (info->endLoop + SF2_COMPACT_GUARD) : range->end;
+    }
+    if (range->end > compactSmplCnt)
+    {
+        range->end = compactSmplCnt;
+    }
+}
+
+static int sf2Compact_Compare(const void *a, const void *b)
+{
+    const struct sf2_range_s *ra = (const struct sf2_range_s *)a;
+    const struct sf2_range_s *rb = (const struct sf2_range_s *)b;
+    return (ra->start > rb->start) - (ra->start < rb->start);
+}
+
+/*
+ * sorts and merges the collected ranges, returns the sample count of the compact image
+ */
+static uint32_t sf2Compact_Coalesce(void)
+{
+    if (compactRangeCnt == 0)
     {
+        return 0;
+    }
 
-        Sampler_NewSampleSetRange(info->start, info->end);
+    qsort(compactRanges, compactRangeCnt, sizeof(struct sf2_range_s), sf2Compact_Compare);
 
-        if ((info->sampleModus == 1) || (info->sampleModus == 3))
+    uint32_t cnt = 1;
+    for (uint32_t i = 1; i < compactRangeCnt; i++)
+    {
+        struct sf2_range_s *last = &compactRanges[cnt - 1];
+        if (compactRanges[i].start <= last->end + SF2_COMPACT_MERGE_GAP)
         {
-            if ((info->startLoop != info->start) || (info->endLoop != info->end))
+            if (compactRanges[i].end > last->end)
             {
-                info->start += 1;
-                printf("loop: %" PRIu32 " - %" PRIu32 "\n", info->startLoop - info->start, info->endLoop - info->start);
-                Sampler_NewSampleSetLoop(info->startLoop, info->endLoop);
+                last->end = compactRanges[i].end;
             }
-            Sampler_SetLoopMode(info->sampleModus);
         }
+        else
+        {
+            compactRanges[cnt++] = compactRanges[i];
+        }
+    }
+    compactRangeCnt = cnt;
 
-        Sampler_SetExclusiveClass(info->exClass);
-        Sampler_SetPitch(info->rootKey, info->sampleRate, info->tune);
-#ifdef MULTIPLE_SAMPLE_PER_INSTRUMENT
-        Sampler_SetKeyRange(info->keyRange.lowest, info->keyRange.highest);
-        Sampler_SetVelRange(info->velRange.lowest, info->velRange.highest);
-#endif
+    uint32_t dst = 0;
+    for (uint32_t i = 0; i < compactRangeCnt; i++)
+    {
+        compactRanges[i].dst = dst;
+        dst += compactRanges[i].end - compactRanges[i].start;
+    }
+    return dst;
+}
 
+/*
+ * converts a position of the smpl chunk to the position in the compact image
+ */
+static uint32_t sf2Compact_Relocate(uint32_t pos)
+{
+    uint32_t low = 0;
+    uint32_t high = compactRangeCnt;
+
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (pos < compactRanges[mid].start)
+        {
+            high = mid;
+        }
+        else if (pos > compactRanges[mid].end)
         {
-            float holdVolEnv_f = info->decayVolEnv;
-            holdVolEnv_f /= 1200;
-            holdVolEnv_f = pow(2, holdVolEnv_f);
+            low = mid + 1;
+        }
+        else
+        {
+            return compactRanges[mid].dst + pos - compactRanges[mid].start;
+        }
+    }
+
+    /* not collected in the first pass */
+    return 0;
+}
+
+/*
+ * second pass: adds the sample using the relocated positions
+ */
+static void sf2Compact_LoadSample(struct instrLoadInfo_s *info)
+{
+    if ((info->start == 0) && (info->end == 0))
+    {
+        return;
+    }
 
-            /* time normalized by sample rate */
-            holdVolEnv_f *= ((float)SAMPLE_RATE);
+    info->start = sf2Compact_Relocate(info->start);
+    info->end = sf2Compact_Relocate(info->end);
+    info->startLoop = sf2Compact_Relocate(info->startLoop);
+    info->endLoop = sf2Compact_Relocate(info->endLoop);
+    LoadSampleFromInfo(info);
+}
+
+/*
+ * collects the ranges used by the listed presets/instruments (all if list is NULL)
+ * returns the sample count of the compact image
+ */
+static uint32_t sf2Compact_Plan(sf2_walk_fn_t walk, const uint32_t *list, uint32_t listCnt, uint32_t allCnt)
+{
+    uint32_t cnt = (list != NULL) ? listCnt : allCnt;
+
+    compactSmplCnt = sf2_Info()->smpl_cnt / 2;
+    compactRangeCnt = 0;
+
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        walk((list != NULL) ? list[i] : i, sf2Compact_Collect);
+    }
+
+    return sf2Compact_Coalesce();
+}
 
-            /* multiplication count to min 16 bit value */
-            holdVolEnv_f = pow(1.0f / 32736.0f, 1.0 / holdVolEnv_f);
+/*
+ * collects the listed presets/instruments in order as long as the compact image fits into budgetCnt samples
+ * the ones which do not fit are skipped, their indices will not be written to fitList
+ * returns the sample count of the compact image
+ */
+static uint32_t sf2Compact_Fit(sf2_walk_fn_t walk, const uint32_t *list, uint32_t cnt, uint32_t budgetCnt, uint32_t *fitList, uint32_t *fitCnt)
+{
+    struct sf2_range_s *keep = NULL;
+    uint32_t imageCnt = 0;
 
-            //pow(1.0/32736.0, 1/(holdVolEnv_f*SAMPLE_RATE));
+    compactSmplCnt = sf2_Info()->smpl_cnt / 2;
+    compactRangeCnt = 0;
+    *fitCnt = 0;
 
-            /* normalize */
-            holdVolEnv_f *= 2147483648.0f;
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        uint32_t idx = (list != NULL) ? list[i] : i;
+        uint32_t keepCnt = compactRangeCnt;
 
-            Sampler_SetHold((uint32_t)holdVolEnv_f);
+        /* the ranges are merged in place, the copy is required to remove the ranges of idx again */
+        if (keepCnt > 0)
+        {
+            struct sf2_range_s *ranges = (struct sf2_range_s *)realloc(keep, keepCnt * sizeof(struct sf2_range_s));
+            if (ranges == NULL)
+            {
+                Serial.printf("Not enough memory to plan the load!\n");
+                break;
+            }
+            keep = ranges;
+            memcpy(keep, compactRanges, keepCnt * sizeof(struct sf2_range_s));
         }
 
+        walk(idx, sf2Compact_Collect);
+        uint32_t newCnt = sf2Compact_Coalesce();
+        if (newCnt <= budgetCnt)
         {
-            float releaseVolEnv_f = info->releaseVolEnv;
-            releaseVolEnv_f /= 1200;
-            releaseVolEnv_f = pow(2, releaseVolEnv_f);
+            fitList[(*fitCnt)++] = idx;
+            imageCnt = newCnt;
+        }
+        else
+        {
+            if (keepCnt > 0)
+            {
+                memcpy(compactRanges, keep, keepCnt * sizeof(struct sf2_range_s));
+            }
+            compactRangeCnt = keepCnt;
+        }
+    }
 
-            /* time normalized by sample rate */
-            releaseVolEnv_f *= ((float)SAMPLE_RATE);
+    free(keep);
+    return imageCnt;
+}
 
-            /* multiplication count to min 16 bit value */
-            releaseVolEnv_f = pow(1.0f / 32736.0f, 1.0 / releaseVolEnv_f);
+static void sf2Compact_Free(void)
+{
+    free(compactRanges);
+    compactRanges = NULL;
+    compactRangeCap = 0;
+    compactRangeCnt = 0;
+}
 
-            //pow(1.0/32736.0, 1/(releaseVolEnv_f*SAMPLE_RATE));
+static void sf2Plan_Report(const char *result, uint32_t selCnt, uint32_t cnt, uint32_t imageCnt, uint32_t budgetCnt)
+{
+    char str[64];
 
-            /* normalize */
-            releaseVolEnv_f *= 2147483648.0f;
+    snprintf(str, sizeof(str), "%" PRIu32 " of %" PRIu32 ", %" PRIu32 " of %" PRIu32 " kB free",
+             selCnt, cnt, (imageCnt * 2) / 1024, (budgetCnt * 2) / 1024);
+    Serial.printf("memory plan: %s, %s\n", result, str);
+    Status_ValueChangedStr("Memory plan", result, str);
+}
 
-            Sampler_SetRelease((uint32_t)releaseVolEnv_f);
-        }
+/*
+ * returns true when the complete smpl chunk fits into the free sample memory
+ */
+static bool sf2Plan_ChunkFits(struct sf2_soundfont_info_s *offset, uint32_t cnt)
+{
+    uint32_t budgetCnt = SampleTransfer_GetFreeBytes() / sizeof(Q1_14);
+    uint32_t chunkCnt = offset->smpl_cnt / 2;
+
+    if (chunkCnt <= budgetCnt)
+    {
+        sf2Plan_Report("Fits", cnt, cnt, chunkCnt, budgetCnt);
+        return true;
+    }
+
+    Serial.printf("smpl chunk of %" PRIu32 " kB does not fit, only the used samples will be loaded\n", offset->smpl_cnt / 1024);
+    return false;
+}
 
+/*
+ * loads the samples used by the listed presets/instruments only (all if list is NULL)
+ * the size is planned before any data will be copied, when the free sample memory is not sufficient
+ * only the presets/instruments which fit will be loaded, returns false when none of them fits
+ */
+static bool sf2Compact_Load(sf2_walk_fn_t walk, const uint32_t *list, uint32_t listCnt, uint32_t allCnt)
+{
+    struct sf2_soundfont_info_s *offset = sf2_Info();
+    uint32_t cnt = (list != NULL) ? listCnt : allCnt;
+    uint32_t budgetCnt = SampleTransfer_GetFreeBytes() / sizeof(Q1_14);
+    uint32_t *fitList = NULL;
 
-        Sampler_FinishSample();
+    uint32_t imageCnt = sf2Compact_Plan(walk, list, listCnt, allCnt);
+    if (imageCnt <= budgetCnt)
+    {
+        sf2Plan_Report("Fits", cnt, cnt, imageCnt, budgetCnt);
     }
     else
     {
-        Serial.printf("Could not add sample (LoadSampleFromInfo3)!\n");
+        uint32_t needCnt = imageCnt;
+        uint32_t fitCnt = 0;
+
+        fitList = (uint32_t *)malloc(cnt * sizeof(uint32_t));
+        if (fitList != NULL)
+        {
+            imageCnt = sf2Compact_Fit(walk, list, cnt, budgetCnt, fitList, &fitCnt);
+        }
+        if (fitCnt == 0)
+        {
+            sf2Plan_Report("Does not fit", 0, cnt, needCnt, budgetCnt);
+            free(fitList);
+            sf2Compact_Free();
+            return false;
+        }
+        sf2Plan_Report("Subset", fitCnt, cnt, imageCnt, budgetCnt);
+        list = fitList;
+        cnt = fitCnt;
+    }
+
+    Serial.printf("compact image: %" PRIu32 " ranges, %" PRIu32 " of %" PRIu32 " kB\n",
+                  compactRangeCnt, (imageCnt * 2) / 1024, offset->smpl_cnt / 1024);
+
+    SampleTransfer_Start();
+    for (uint32_t i = 0; i < compactRangeCnt; i++)
+    {
+        fileSeekTo(offset->smpl + compactRanges[i].start * 2);
+        if (!SampleTransfer_Read((compactRanges[i].end - compactRanges[i].start) * 2))
+        {
+            break;
+        }
+    }
+    SampleTransfer_End();
+
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        if (walk((list != NULL) ? list[i] : i, sf2Compact_LoadSample))
+        {
+            SmplBank_InstrumentDone();
+        }
+        else
+        {
+            Serial.printf("compact load of %" PRIu32 " failed!\n", (list != NULL) ? list[i] : i);
+        }
+    }
+
+    free(fitList);
+    sf2Compact_Free();
+    return true;
+}
+
+/*
+ * the first preset of a program in bank 0 will be used
+ */
+static void sf2_MapProgram(uint16_t bank, uint16_t preset, uint32_t idx)
+{
+    if ((bank == 0) && (preset < 128) && (programPreset[preset] == 0))
+    {
+        programPreset[preset] = idx + 1;
+    }
+}
+
+/*
+ * opens the soundfont, the program map will be filled by sf2_preset_indication while parsing
+ * the index of the soundfont will be built if not available (see sf2_index.cpp)
+ */
+static bool sf2_OpenFile(fs_id_t fs_id, const char *filename)
+{
+    memset(programPreset, 0, sizeof(programPreset));
+
+    bool indexed = SF2Index_Open(fs_id, filename);
+    if (!FS_OpenFile(fs_id, filename))
+    {
+        SF2Index_Close();
+        return false;
+    }
+    if (!indexed)
+    {
+        SF2Index_Build();
+    }
+    return true;
+}
+
+/*
+ * opens the index of the soundfont only, to be used when no sample data will be loaded
+ * the soundfont will be parsed only if the index is not available
+ */
+static bool sf2_OpenIndex(fs_id_t fs_id, const char *filename)
+{
+    if (!SF2Index_Open(fs_id, filename))
+    {
+        return sf2_OpenFile(fs_id, filename);
+    }
+
+    memset(programPreset, 0, sizeof(programPreset));
+    for (uint32_t i = 0; i < SF2Index_GetPresetCnt(); i++)
+    {
+        const struct sf2_index_preset_s *preset = SF2Index_GetPreset(i);
+        sf2_MapProgram(preset->bank, preset->preset, i);
+    }
+    return true;
+}
+
+static void sf2_CloseFile(void)
+{
+    FS_CloseFile();
+    SF2Index_Close();
+}
+
+/*
+ * offsets of the opened soundfont, from the index if available
+ */
+static struct sf2_soundfont_info_s *sf2_Info(void)
+{
+    return SF2Index_IsValid() ? SF2Index_GetSoundFontInfo() : ML_SF2_GetSoundFontInfo();
+}
+
+static sf2_walk_fn_t sf2_PresetWalk(void)
+{
+    return SF2Index_IsValid() ? SF2Index_LoadPresetMultiBag : ML_SF2_LoadPresetMultiBag;
+}
+
+/*
+ * first zone of an instrument like SF2ToSmpl_LoadAllInstruments
+ */
+static bool sf2_InstrumentWalk(uint32_t idx, void (*cb)(struct instrLoadInfo_s *info))
+{
+    struct instrLoadInfo_s info;
+    if (!ML_SF2_GetInstrumentInfo(idx, &info))
+    {
+        return false;
+    }
+    cb(&info);
+    return true;
+}
+
+/*
+ * single sample like LoadAllSamples
+ */
+static bool sf2_SampleWalk(uint32_t idx, void (*cb)(struct instrLoadInfo_s *info))
+{
+    struct instrLoadInfo_s info;
+    if (!ML_SF2_LoadSamplesFromInfo(idx, &info))
+    {
+        return false;
+    }
+    cb(&info);
+    return true;
+}
+
+
+#ifdef STREAM_VOICE_ACTIVE
+/*
+ * registers a zone of a preset as streamed sample
+ */
+static void sf2Stream_AddSample(struct instrLoadInfo_s *info)
+{
+    if ((info->start == 0) && (info->end == 0))
+    {
+        return;
+    }
+
+    uint32_t loopStart = 0;
+    uint32_t loopEnd = 0;
+    if (((info->sampleModus == 1) || (info->sampleModus == 3)) && (info->endLoop > info->startLoop))
+    {
+        loopStart = info->startLoop - info->start;
+        loopEnd = info->endLoop - info->start;
+    }
+
+    if (!StreamVoice_AddSample(sf2_Info()->smpl + info->start * 2, info->end - info->start, loopStart, loopEnd,
+                               info->rootKey, info->sampleRate, info->tune, info->keyRange.lowest, info->keyRange.highest))
+    {
+        Serial.printf("Could not add streamed sample %s\n", info->name);
     }
 }
+#endif
 
 
 /*
  * extern function definitions
  */
-void SF2ToSmpl_LoadAllInstrumentsMulti(void)
+bool SF2ToSmpl_LoadAllInstrumentsMulti(void)
 {
     struct sf2_soundfont_info_s *offset = ML_SF2_GetSoundFontInfo();
 
+    if (!sf2Plan_ChunkFits(offset, offset->inst_cnt - 1))
+    {
+        return sf2Compact_Load(ML_SF2_GetInstrumentInfoMultiBag, NULL, 0, offset->inst_cnt - 1);
+    }
+
     TransferSampleData(offset->smpl / 2, offset->smpl / 2 + offset->smpl_cnt / 2);
 
     for (uint32_t i = 0; i < offset->inst_cnt - 1; i++)
@@ -233,19 +635,25 @@ void SF2ToSmpl_LoadAllInstrumentsMulti(void)
 
         if (ML_SF2_GetInstrumentInfoMultiBag(i, SF2ToSmpl_LoadAllInstrumentsMultiCB))
         {
-            Sampler_InstrumentDone();
+            SmplBank_InstrumentDone();
         }
         else
         {
             Serial.printf("loadInstr failed!\n");
         }
     }
+    return true;
 }
 
-void SF2ToSmpl_LoadAllInstruments(void)
+bool SF2ToSmpl_LoadAllInstruments(void)
 {
     struct sf2_soundfont_info_s *offset = ML_SF2_GetSoundFontInfo();
 
+    if (!sf2Plan_ChunkFits(offset, offset->inst_cnt - 1))
+    {
+        return sf2Compact_Load(sf2_InstrumentWalk, NULL, 0, offset->inst_cnt - 1);
+    }
+
     TransferSampleData(offset->smpl / 2, offset->smpl / 2 + offset->smpl_cnt / 2);
 
     for (uint32_t i = 0; i < offset->inst_cnt - 1; i++)
@@ -254,42 +662,52 @@ void SF2ToSmpl_LoadAllInstruments(void)
         if (ML_SF2_GetInstrumentInfo(i, &info))
         {
             LoadSampleFromInfo(&info);
-            Sampler_InstrumentDone();
+            SmplBank_InstrumentDone();
         }
         else
         {
             Serial.printf("loadInstr failed!\n");
         }
     }
+    return true;
 }
 
-void SF2ToSmpl_LoadCompleteSoundFont(void)
+bool SF2ToSmpl_LoadCompleteSoundFont(void)
 {
-    struct sf2_soundfont_info_s *offset = ML_SF2_GetSoundFontInfo();
+    struct sf2_soundfont_info_s *offset = sf2_Info();
+    sf2_walk_fn_t walk = sf2_PresetWalk();
+
+    if (!sf2Plan_ChunkFits(offset, offset->phdr_cnt - 1))
+    {
+        return sf2Compact_Load(walk, NULL, 0, offset->phdr_cnt - 1);
+    }
 
     TransferSampleData(offset->smpl / 2, offset->smpl / 2 + offset->smpl_cnt / 2);
 
     for (uint32_t i = 0; i < offset->phdr_cnt - 1; i++)
     {
-        if (ML_SF2_LoadPresetMultiBag(i, LoadSampleFromInfo))
+        if (walk(i, LoadSampleFromInfo))
         {
-            Sampler_InstrumentDone();
+            SmplBank_InstrumentDone();
         }
         else
         {
             Serial.printf("loadPresetMultiBag failed!\n");
         }
     }
+    return true;
 }
 
 void SF2ToSmpl_LoadAllInstrumentsFromSF(fs_id_t fs_id, const char *filename)
 {
     if (FS_OpenFile(fs_id, filename))
     {
-        SF2ToSmpl_LoadAllInstruments();
+        LoadStep_FileBegin(fs_id, filename);
+        bool loaded = SF2ToSmpl_LoadAllInstruments();
+        LoadStep_FileEnd();
         FS_CloseFile();
 
-        Status_ValueChangedStr("Instruments from Soundfont", "Loaded", filename);
+        Status_ValueChangedStr("Instruments from Soundfont", loaded ? "Loaded" : "Not enough memory!", filename);
     }
     else
     {
@@ -301,10 +719,12 @@ void SF2ToSmpl_LoadAllInstrumentsMultiFromSF(fs_id_t fs_id, const char *filename
 {
     if (FS_OpenFile(fs_id, filename))
     {
-        SF2ToSmpl_LoadAllInstrumentsMulti();
+        LoadStep_FileBegin(fs_id, filename);
+        bool loaded = SF2ToSmpl_LoadAllInstrumentsMulti();
+        LoadStep_FileEnd();
         FS_CloseFile();
 
-        Status_ValueChangedStr("Instruments from Soundfont", "Loaded", filename);
+        Status_ValueChangedStr("Instruments from Soundfont", loaded ? "Loaded" : "Not enough memory!", filename);
     }
     else
     {
@@ -314,12 +734,14 @@ void SF2ToSmpl_LoadAllInstrumentsMultiFromSF(fs_id_t fs_id, const char *filename
 
 void SF2ToSmpl_LoadCompleteSoundFont(fs_id_t fs_id, const char *filename)
 {
-    if (FS_OpenFile(fs_id, filename))
+    if (sf2_OpenFile(fs_id, filename))
     {
-        SF2ToSmpl_LoadCompleteSoundFont();
-        FS_CloseFile();
+        LoadStep_FileBegin(fs_id, filename);
+        bool loaded = SF2ToSmpl_LoadCompleteSoundFont();
+        LoadStep_FileEnd();
+        sf2_CloseFile();
 
-        Status_ValueChangedStr("Complete Soundfont", "Loaded", filename);
+        Status_ValueChangedStr("Complete Soundfont", loaded ? "Loaded" : "Not enough memory!", filename);
     }
     else
     {
@@ -327,14 +749,187 @@ void SF2ToSmpl_LoadCompleteSoundFont(fs_id_t fs_id, const char *filename)
     }
 }
 
+/*
+ * converts the zone of a soundfont into a region, the envelope is precomputed for SAMPLE_RATE
+ */
+void SF2ToSmpl_RegionFromInfo(const struct instrLoadInfo_s *info, struct smpl_region_s *region)
+{
+    memset(region, 0, sizeof(*region));
+
+    region->start = info->start;
+    region->end = info->end;
+    region->loopStart = info->startLoop;
+    region->loopEnd = info->endLoop;
+    if ((info->sampleModus == 1) || (info->sampleModus == 3))
+    {
+        region->loopMode = info->sampleModus;
+    }
+    region->exClass = info->exClass;
+    region->rootKey = info->rootKey;
+    region->sampleRate = info->sampleRate;
+    region->tune = info->tune;
+    region->keyLow = info->keyRange.lowest;
+    region->keyHigh = info->keyRange.highest;
+    region->velLow = info->velRange.lowest;
+    region->velHigh = info->velRange.highest;
+
+    {
+        float holdVolEnv_f = info->decayVolEnv;
+        holdVolEnv_f /= 1200;
+        holdVolEnv_f = pow(2, holdVolEnv_f);
+
+        /* time normalized by sample rate */
+        holdVolEnv_f *= ((float)SAMPLE_RATE);
+
+        /* multiplication count to min 16 bit value */
+        holdVolEnv_f = pow(1.0f / 32736.0f, 1.0 / holdVolEnv_f);
+
+        //pow(1.0/32736.0, 1/(holdVolEnv_f*SAMPLE_RATE));
+
+        /* normalize */
+        holdVolEnv_f *= 2147483648.0f;
+
+        region->hold = (uint32_t)holdVolEnv_f;
+    }
+
+    {
+        float releaseVolEnv_f = info->releaseVolEnv;
+        releaseVolEnv_f /= 1200;
+        releaseVolEnv_f = pow(2, releaseVolEnv_f);
+
+        /* time normalized by sample rate */
+        releaseVolEnv_f *= ((float)SAMPLE_RATE);
+
+        /* multiplication count to min 16 bit value */
+        releaseVolEnv_f = pow(1.0f / 32736.0f, 1.0 / releaseVolEnv_f);
+
+        //pow(1.0/32736.0, 1/(releaseVolEnv_f*SAMPLE_RATE));
+
+        /* normalize */
+        releaseVolEnv_f *= 2147483648.0f;
+
+        region->release = (uint32_t)releaseVolEnv_f;
+    }
+}
+
+/*
+ * loads the listed presets (index of the preset header, all presets if presets is NULL)
+ * only the sample data used by them will be copied into the sampler memory
+ */
+void SF2ToSmpl_LoadPresetsCompact(fs_id_t fs_id, const char *filename, const uint32_t *presets, uint32_t presetCnt)
+{
+    if (sf2_OpenFile(fs_id, filename))
+    {
+        LoadStep_FileBegin(fs_id, filename);
+        bool loaded = sf2Compact_Load(sf2_PresetWalk(), presets, presetCnt, sf2_Info()->phdr_cnt - 1);
+        LoadStep_FileEnd();
+        sf2_CloseFile();
+
+        Status_ValueChangedStr("Presets from Soundfont", loaded ? "Loaded" : "Not enough memory!", filename);
+    }
+    else
+    {
+        Status_ValueChangedStr("Presets from Soundfont", "Loading failed!", filename);
+    }
+}
+
+/*
+ * loads the listed instruments (all instruments if instruments is NULL)
+ * only the sample data used by them will be copied into the sampler memory
+ */
+void SF2ToSmpl_LoadInstrumentsCompact(fs_id_t fs_id, const char *filename, const uint32_t *instruments, uint32_t instrumentCnt)
+{
+    if (sf2_OpenFile(fs_id, filename))
+    {
+        LoadStep_FileBegin(fs_id, filename);
+        bool loaded = sf2Compact_Load(ML_SF2_GetInstrumentInfoMultiBag, instruments, instrumentCnt, sf2_Info()->inst_cnt - 1);
+        LoadStep_FileEnd();
+        sf2_CloseFile();
+
+        Status_ValueChangedStr("Instruments from Soundfont", loaded ? "Loaded" : "Not enough memory!", filename);
+    }
+    else
+    {
+        Status_ValueChangedStr("Instruments from Soundfont", "Loading failed!", filename);
+    }
+}
+
+/*
+ * returns the bytes of sampler memory required by SF2ToSmpl_LoadPresetsCompact, 0 on error
+ */
+uint32_t SF2ToSmpl_PresetsCompactSize(fs_id_t fs_id, const char *filename, const uint32_t *presets, uint32_t presetCnt)
+{
+    uint32_t imageCnt = 0;
+
+    if (sf2_OpenIndex(fs_id, filename))
+    {
+        imageCnt = sf2Compact_Plan(sf2_PresetWalk(), presets, presetCnt, sf2_Info()->phdr_cnt - 1);
+        sf2Compact_Free();
+        sf2_CloseFile();
+    }
+
+    return imageCnt * 2;
+}
+
+/*
+ * gets the presets of bank 0 without loading any data, from the index if available
+ */
+bool SF2ToSmpl_ScanPresets(fs_id_t fs_id, const char *filename)
+{
+    if (sf2_OpenIndex(fs_id, filename))
+    {
+        sf2_CloseFile();
+        return true;
+    }
+    return false;
+}
+
+/*
+ * returns the preset header index of a program of bank 0 of the last opened soundfont, -1 if not available
+ */
+int32_t SF2ToSmpl_ProgramToPreset(uint8_t program)
+{
+    return (int32_t)programPreset[program & 0x7F] - 1;
+}
+
+#ifdef STREAM_VOICE_ACTIVE
+/*
+ * the samples of the listed presets will be played by the stream voices
+ * only their attack and short loops will be kept in memory
+ */
+void SF2ToSmpl_StreamPresets(fs_id_t fs_id, const char *filename, const uint32_t *presets, uint32_t presetCnt)
+{
+    if (sf2_OpenIndex(fs_id, filename) && StreamVoice_Open(fs_id, filename))
+    {
+        sf2_walk_fn_t walk = sf2_PresetWalk();
+
+        SmplSnapshot_Invalidate("streamed presets");
+        for (uint32_t i = 0; i < presetCnt; i++)
+        {
+            walk(presets[i], sf2Stream_AddSample);
+        }
+        sf2_CloseFile();
+
+        Status_ValueChangedStr("Streamed presets", "Loaded", filename);
+    }
+    else
+    {
+        sf2_CloseFile();
+        Status_ValueChangedStr("Streamed presets", "Loading failed!", filename);
+    }
+}
+#endif
+
 void SF2ToSmpl_LoadAllSamplesFromSF(fs_id_t fs_id, const char *filename)
 {
     if (FS_OpenFile(fs_id, filename))
     {
-        LoadAllSamples();
+        LoadStep_FileBegin(fs_id, filename);
+        bool loaded = LoadAllSamples();
+        LoadStep_FileEnd();
         FS_CloseFile();
 
-        Status_ValueChangedStr("Samples from Soundfont", "Loaded", filename);
+        Status_ValueChangedStr("Samples from Soundfont", loaded ? "Loaded" : "Not enough memory!", filename);
     }
     else
     {
@@ -348,17 +943,22 @@ void SF2ToSmpl_LoadAllSamplesFromSF(fs_id_t fs_id, const char *filename)
 void sf2_preset_indication(union preset_hdr_s *preset, uint32_t idx)
 {
 #ifdef SF2_INFO_MESSAGES
-    Serial.printf("presetName[%" PRIu32 "]: %s\n", idx, preset->presetName);
-    Serial.printf("  preset: %d\n", preset->preset);
-    Serial.printf("  bank: %d\n", preset->bank);
-    Serial.printf("  presetBagIndex: %d\n", preset->presetBagIndex);
-    Serial.printf("  library: %" PRIu32 "\n", preset->library);
-    Serial.printf("  genre: %" PRIu32 "\n", preset->genre);
-    Serial.printf("  morphology: %" PRIu32 "\n", preset->morphology);
-#else
-    (void)preset;
-    (void)idx;
+    if (!LoadStep_InStep())
+    {
+        Serial.printf("presetName[%" PRIu32 "]: %s\n", idx, preset->presetName);
+        Serial.printf("  preset: %d\n", preset->preset);
+        Serial.printf("  bank: %d\n", preset->bank);
+        Serial.printf("  presetBagIndex: %d\n", preset->presetBagIndex);
+        Serial.printf("  library: %" PRIu32 "\n", preset->library);
+        Serial.printf("  genre: %" PRIu32 "\n", preset->genre);
+        Serial.printf("  morphology: %" PRIu32 "\n", preset->morphology);
+    }
 #endif
+
+    sf2_MapProgram(preset->bank, preset->preset, idx);
+    SF2Index_PresetIndication(preset, idx);
+
+    LoadStep_Yield();
 }
 
 /**
@@ -367,22 +967,27 @@ void sf2_preset_indication(union preset_hdr_s *preset, uint32_t idx)
 void sf2_sample_indication(union sf2_sample_hdr_s *sample, uint32_t idx)
 {
 #ifdef SF2_INFO_MESSAGES
-    char sampleName[21] = {0};
-    memcpy(sampleName, sample->sampleName, 20);
-    Serial.printf("sampleName[%" PRIu32 "]: %s\n", idx, sampleName);
-    Serial.printf("  start: %" PRIu32 "\n", sample->start);
-    Serial.printf("  end: %" PRIu32 "\n", sample->end);
-    Serial.printf("  startLoop: %" PRIu32 "\n", sample->startLoop);
-    Serial.printf("  endLoop: %" PRIu32 "\n", sample->endLoop);
-    Serial.printf("  sampleRate: %" PRIu32 "\n", sample->sampleRate);
-    Serial.printf("  originalPitch: %d\n", sample->originalPitch);
-    Serial.printf("  pitchCorrection: %d\n", sample->pitchCorrection);
-    Serial.printf("  sampleLink: %d\n", sample->sampleLink);
-    Serial.printf("  sampleType: %d\n", sample->sampleType);
+    if (!LoadStep_InStep())
+    {
+        char sampleName[21] = {0};
+        memcpy(sampleName, sample->sampleName, 20);
+        Serial.printf("sampleName[%" PRIu32 "]: %s\n", idx, sampleName);
+        Serial.printf("  start: %" PRIu32 "\n", sample->start);
+        Serial.printf("  end: %" PRIu32 "\n", sample->end);
+        Serial.printf("  startLoop: %" PRIu32 "\n", sample->startLoop);
+        Serial.printf("  endLoop: %" PRIu32 "\n", sample->endLoop);
+        Serial.printf("  sampleRate: %" PRIu32 "\n", sample->sampleRate);
+        Serial.printf("  originalPitch: %d\n", sample->originalPitch);
+        Serial.printf("  pitchCorrection: %d\n", sample->pitchCorrection);
+        Serial.printf("  sampleLink: %d\n", sample->sampleLink);
+        Serial.printf("  sampleType: %d\n", sample->sampleType);
+    }
 #else
     (void)sample;
     (void)idx;
 #endif
+
+    LoadStep_Yield();
 }
 
 /**
@@ -394,15 +999,20 @@ void sf2_sample_indication(union sf2_sample_hdr_s *sample, uint32_t idx)
 void sf2_instrument_indication(union SF2Instrument_u *inst, uint32_t idx)
 {
 #ifdef SF2_INFO_MESSAGES
-    char instName[21] = {0};
-    strncpy(instName, inst->name, 20);
-    Serial.printf("instrument[%" PRIu32 "]:\n", idx);
-    Serial.printf("  instName: %s\n", instName);
-    Serial.printf("  bagIndex: %u\n", inst->bagIndex);
+    if (!LoadStep_InStep())
+    {
+        char instName[21] = {0};
+        strncpy(instName, inst->name, 20);
+        Serial.printf("instrument[%" PRIu32 "]:\n", idx);
+        Serial.printf("  instName: %s\n", instName);
+        Serial.printf("  bagIndex: %u\n", inst->bagIndex);
+    }
 #else
     (void)inst;
     (void)idx;
 #endif
+
+    LoadStep_Yield();
 }
 
 /**
@@ -411,71 +1021,101 @@ void sf2_instrument_indication(union SF2Instrument_u *inst, uint32_t idx)
 void sf2_sdta_smpl_indication(uint32_t len)
 {
 #ifdef SF2_INFO_MESSAGES
-    Serial.printf("Sample in file at %" PRIu32 "\n", getStaticPos());
-    Serial.printf("    len %" PRIu32 "\n", len);
+    if (!LoadStep_InStep())
+    {
+        Serial.printf("Sample in file at %" PRIu32 "\n", getStaticPos());
+        Serial.printf("    len %" PRIu32 "\n", len);
+    }
 #else
     (void)len;
 #endif
+
+    LoadStep_Yield();
 }
 
 void sf2_preset_bag_indication(union SF2PresetBag_u *pbag)
 {
 #ifdef SF2_INFO_MESSAGES
-    Serial.printf("preset bag:\n");
-    Serial.printf("  generatorIndex: %u\n", pbag->generatorIndex);
-    Serial.printf("  modulatorIndex: %u\n", pbag->modulatorIndex);
+    if (!LoadStep_InStep())
+    {
+        Serial.printf("preset bag:\n");
+        Serial.printf("  generatorIndex: %u\n", pbag->generatorIndex);
+        Serial.printf("  modulatorIndex: %u\n", pbag->modulatorIndex);
+    }
 #else
     (void)pbag;
 #endif
+
+    LoadStep_Yield();
 }
 
 void sf2_preset_modulator_indication(union SF2PresetModulator_u *pmod)
 {
 #ifdef SF2_INFO_MESSAGES
-    Serial.printf("preset modulator:\n");
-    Serial.printf("  sourceOperator: %u\n", pmod->sourceOperator);
-    Serial.printf("  destinationOperator: %u\n", pmod->destinationOperator);
-    Serial.printf("  amount: %d\n", pmod->amount);
-    Serial.printf("  amountSourceOperator: %u\n", pmod->amountSourceOperator);
-    Serial.printf("  transportOperator: %u\n", pmod->transportOperator);
+    if (!LoadStep_InStep())
+    {
+        Serial.printf("preset modulator:\n");
+        Serial.printf("  sourceOperator: %u\n", pmod->sourceOperator);
+        Serial.printf("  destinationOperator: %u\n", pmod->destinationOperator);
+        Serial.printf("  amount: %d\n", pmod->amount);
+        Serial.printf("  amountSourceOperator: %u\n", pmod->amountSourceOperator);
+        Serial.printf("  transportOperator: %u\n", pmod->transportOperator);
+    }
 #else
     (void)pmod;
 #endif
+
+    LoadStep_Yield();
 }
 
 void sf2_preset_generator_indication(union SF2PresetGenerator_u *pgen, uint32_t idx)
 {
 #ifdef SF2_INFO_MESSAGES
-    Serial.printf("preset generator[%" PRIu32 "]:\n", idx);
-    Serial.printf("  generatorIndex: %u\n", pgen->generatorIndex);
-    Serial.printf("  amount: %d\n", pgen->amount);
+    if (!LoadStep_InStep())
+    {
+        Serial.printf("preset generator[%" PRIu32 "]:\n", idx);
+        Serial.printf("  generatorIndex: %u\n", pgen->generatorIndex);
+        Serial.printf("  amount: %d\n", pgen->amount);
+    }
 #else
     (void)pgen;
     (void)idx;
 #endif
+
+    LoadStep_Yield();
 }
 
 void sf2_instrument_bag_indication(union SF2InstrumentBag_u *ibag, uint32_t idx)
 {
 #ifdef SF2_INFO_MESSAGES
-    Serial.printf("instrument bag[%" PRIu32 "]:\n", idx);
-    Serial.printf("  generatorIndex: %u\n", ibag->generatorIndex);
-    Serial.printf("  modulatorIndex: %u\n", ibag->modulatorIndex);
+    if (!LoadStep_InStep())
+    {
+        Serial.printf("instrument bag[%" PRIu32 "]:\n", idx);
+        Serial.printf("  generatorIndex: %u\n", ibag->generatorIndex);
+        Serial.printf("  modulatorIndex: %u\n", ibag->modulatorIndex);
+    }
 #else
     (void)ibag;
     (void)idx;
 #endif
+
+    LoadStep_Yield();
 }
 
 void sf2_instrument_generator_indication(union SF2InstrumentGenerator_u *igen, uint32_t idx)
 {
 #ifdef SF2_INFO_MESSAGES
-    Serial.printf("instrument generator[%" PRIu32 "]:\n", idx);
-    Serial.printf("  ioperator: %u\n", igen->ioperator);
-    Serial.printf("  amount: %u\n", igen->amount);
+    if (!LoadStep_InStep())
+    {
+        Serial.printf("instrument generator[%" PRIu32 "]:\n", idx);
+        Serial.printf("  ioperator: %u\n", igen->ioperator);
+        Serial.printf("  amount: %u\n", igen->amount);
+    }
 #else
     (void)igen;
     (void)idx;
 #endif
+
+    LoadStep_Yield();
 }
 
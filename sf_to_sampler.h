@@ -45,6 +45,8 @@
  * includes
  */
 #include "fs/fs_access.h"
+#include "stream_voice.h"
+#include "smpl_bank.h"
 
 
 /*
@@ -52,12 +54,21 @@
  */
 void SF2ToSmpl_LoadCompleteSoundFont(fs_id_t fs_id, const char *filename);
 void SF2ToSmpl_LoadAllSamplesFromSF(fs_id_t fs_id, const char *filename);
-void SF2ToSmpl_LoadCompleteSoundFont(void);
-void SF2ToSmpl_LoadAllInstruments(void);
-void SF2ToSmpl_LoadAllInstrumentsMulti(void);
+bool SF2ToSmpl_LoadCompleteSoundFont(void);
+bool SF2ToSmpl_LoadAllInstruments(void);
+bool SF2ToSmpl_LoadAllInstrumentsMulti(void);
 void SF2ToSmpl_LoadAllInstrumentsFromSF(fs_id_t fs_id, const char *filename);
 void SF2ToSmpl_LoadAllInstrumentsMultiFromSF(fs_id_t fs_id, const char *filename);
 void SF2ToSmpl_LoadCompleteSoundFont(fs_id_t fs_id, const char *filename);
+void SF2ToSmpl_LoadPresetsCompact(fs_id_t fs_id, const char *filename, const uint32_t *presets, uint32_t presetCnt);
+void SF2ToSmpl_LoadInstrumentsCompact(fs_id_t fs_id, const char *filename, const uint32_t *instruments, uint32_t instrumentCnt);
+uint32_t SF2ToSmpl_PresetsCompactSize(fs_id_t fs_id, const char *filename, const uint32_t *presets, uint32_t presetCnt);
+bool SF2ToSmpl_ScanPresets(fs_id_t fs_id, const char *filename);
+int32_t SF2ToSmpl_ProgramToPreset(uint8_t program);
+void SF2ToSmpl_RegionFromInfo(const struct instrLoadInfo_s *info, struct smpl_region_s *region);
+#ifdef STREAM_VOICE_ACTIVE
+void SF2ToSmpl_StreamPresets(fs_id_t fs_id, const char *filename, const uint32_t *presets, uint32_t presetCnt);
+#endif
 
 
 #endif /* SF_TO_SAMPLER_H_ */
@@ -0,0 +1,1004 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file smpl_arena.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Sample memory arena, loaded instruments can be removed without reloading the others
+ * @n       After a clear (SoundFontSamplerCtrl(0)) the sample data is appended to the sample memory
+ * @n       by the arena. The data of each load and its instruments form an entry, identified by
+ * @n       a handle (the index of the entry). A new entry is opened by the first transfer of a load
+ * @n       and by the first transfer after an instrument has been completed.
+ * @n       The programs are numbered over all entries in the order of their handles. A new entry takes
+ * @n       the lowest free handle, an instrument can be replaced by unloading its entry and loading
+ * @n       the new one.
+ * @n       The sampler can only remove all samples at once. The memory of an unloaded entry is freed
+ * @n       by the compaction when no voice is active: the entries are moved down by SMPL_ARENA_MOVE_BYTES
+ * @n       per audio block (less when the last block took more than half of its budget) and added to
+ * @n       the sampler again by SMPL_ARENA_ADD_CNT samples per block (they are muted until then).
+ * @n       "arena" prints the entries and the fragmentation of the sample memory.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "smpl_arena.h"
+#include "load_job.h"
+#include "voice_alloc.h"
+#include "app.h"
+#include "perf_mon.h"
+
+#include <ml_sampler.h>
+#include <ml_status.h>
+
+
+/*
+ * defines
+ */
+#define SMPL_ARENA_ENTRY_CNT    32 /*!< must not exceed the bits of the unload request */
+#define SMPL_ARENA_MOVE_BYTES       (4 * 1024) /*!< moved by the compaction per audio block */
+#define SMPL_ARENA_MOVE_MIN_BYTES   1024 /*!< moved per audio block when the rendering takes more than half of the budget */
+#define SMPL_ARENA_ADD_CNT          32 /*!< samples added to the sampler per audio block, like the commit of the load job */
+#define SMPL_ARENA_CH_CNT       16
+
+
+/*
+ * data types
+ */
+enum smpl_arena_state_e
+{
+    SMPL_ARENA_IDLE,
+    SMPL_ARENA_LOADING, /*!< the load job writes into the arena */
+    SMPL_ARENA_COMPACT, /*!< the audio core moves the entries */
+};
+
+enum smpl_arena_entry_state_e
+{
+    SMPL_ARENA_FREE,
+    SMPL_ARENA_LOADED,
+    SMPL_ARENA_UNLOADED, /*!< still in the sampler until the next compaction */
+    SMPL_ARENA_MOVING, /*!< removed from the sampler, waits to be moved and added again */
+};
+
+struct smpl_arena_op_s
+{
+    bool instrumentDone; /*!< Sampler_InstrumentDone instead of adding the region */
+    struct smpl_region_s region; /*!< positions within the sample memory */
+};
+
+struct smpl_arena_entry_s
+{
+    uint32_t state;
+    uint32_t seq; /*!< order of the entries with the same start */
+    uint32_t start; /*!< first sample within the sample memory */
+    uint32_t cnt; /*!< samples loaded */
+    bool sealed; /*!< an instrument has been completed, the next transfer opens a new entry */
+    struct smpl_arena_op_s *ops; /*!< kept to add the entry again after the compaction */
+    uint32_t opCnt;
+    uint32_t opCap;
+    uint32_t instrBase; /*!< sampler index of the first instrument */
+    uint32_t instrCnt;
+};
+
+
+/*
+ * static variables
+ */
+#ifdef SMPL_ARENA_ACTIVE
+static struct smpl_arena_entry_s arenaEntries[SMPL_ARENA_ENTRY_CNT];
+static uint32_t arenaState = SMPL_ARENA_IDLE;
+static bool arenaReady = false; /*!< the sampler uses the complete memory and contains only the entries */
+static uint32_t arenaSize = 0; /*!< samples of the sample memory */
+static uint32_t arenaTop = 0; /*!< end of the last entry */
+static uint32_t arenaSeq = 0;
+static uint32_t arenaTableInstrCnt = 0; /*!< instruments in the sampler */
+static uint32_t arenaUnloadReq = 0; /*!< handles to be unloaded by the audio core */
+static bool arenaCompactPending = false;
+static uint8_t arenaProgram[SMPL_ARENA_CH_CNT];
+
+/* written by the loader */
+static int32_t arenaLoad = -1; /*!< entry receiving the data and the regions */
+static bool arenaTransfer = false;
+static uint32_t arenaTransferBase = 0;
+static bool arenaFull = false;
+
+/* used by the audio core only */
+static int32_t arenaMoveEntry = -1;
+static uint32_t arenaMoveDst = 0;
+static uint32_t arenaMovePos = 0;
+static uint32_t arenaAddPos = 0; /*!< ops of the moved entry added to the sampler */
+static uint32_t arenaMoveStartMs = 0;
+static uint32_t arenaMovedCnt = 0;
+static uint32_t arenaCompactCnt = 0;
+#endif
+
+
+/*
+ * static function definitions
+ */
+#ifdef SMPL_ARENA_ACTIVE
+static uint32_t smplArena_GetState(void)
+{
+    return __atomic_load_n(&arenaState, __ATOMIC_ACQUIRE);
+}
+
+static void smplArena_SetState(uint32_t state)
+{
+    __atomic_store_n(&arenaState, state, __ATOMIC_RELEASE);
+}
+
+static bool smplArena_TakeState(uint32_t state)
+{
+    uint32_t idle = SMPL_ARENA_IDLE;
+    return __atomic_compare_exchange_n(&arenaState, &idle, state, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static bool smplArena_IsReady(void)
+{
+    return __atomic_load_n(&arenaReady, __ATOMIC_ACQUIRE);
+}
+
+static Q1_14 *smplArena_Mem(void)
+{
+    return (Q1_14 *)App_GetSampleMem();
+}
+
+static void smplArena_FreeOps(struct smpl_arena_entry_s *entry)
+{
+    free(entry->ops);
+    entry->ops = NULL;
+    entry->opCnt = 0;
+    entry->opCap = 0;
+}
+
+static struct smpl_arena_op_s *smplArena_AddOp(struct smpl_arena_entry_s *entry)
+{
+    if (entry->opCnt == entry->opCap)
+    {
+        uint32_t cap = (entry->opCap > 0) ? (entry->opCap * 2) : 16;
+        struct smpl_arena_op_s *ops = (struct smpl_arena_op_s *)realloc(entry->ops, cap * sizeof(struct smpl_arena_op_s));
+        if (ops == NULL)
+        {
+            Serial.printf("arena: not enough memory, entry %" PRId32 " is incomplete\n", (int32_t)(entry - arenaEntries));
+            return NULL;
+        }
+        entry->ops = ops;
+        entry->opCap = cap;
+    }
+    return &entry->ops[entry->opCnt++];
+}
+
+/*
+ * returns the entries in the order of the sample memory
+ */
+static uint32_t smplArena_Sort(uint8_t *order)
+{
+    uint32_t cnt = 0;
+
+    for (uint32_t i = 0; i < SMPL_ARENA_ENTRY_CNT; i++)
+    {
+        struct smpl_arena_entry_s *entry = &arenaEntries[i];
+        if (entry->state == SMPL_ARENA_FREE)
+        {
+            continue;
+        }
+
+        uint32_t k = cnt++;
+        while (k > 0)
+        {
+            struct smpl_arena_entry_s *prev = &arenaEntries[order[k - 1]];
+            if ((prev->start < entry->start) || ((prev->start == entry->start) && (prev->seq < entry->seq)))
+            {
+                break;
+            }
+            order[k] = order[k - 1];
+            k--;
+        }
+        order[k] = i;
+    }
+    return cnt;
+}
+
+/*
+ * finds the sampler index of a program, the programs are counted over the entries in the order of their handles
+ */
+static bool smplArena_ProgramToInstr(uint32_t program, uint32_t *instr)
+{
+    for (uint32_t i = 0; i < SMPL_ARENA_ENTRY_CNT; i++)
+    {
+        struct smpl_arena_entry_s *entry = &arenaEntries[i];
+        if ((entry->state != SMPL_ARENA_LOADED) && (entry->state != SMPL_ARENA_MOVING))
+        {
+            continue;
+        }
+        if (program < entry->instrCnt)
+        {
+            *instr = entry->instrBase + program;
+            return (entry->state == SMPL_ARENA_LOADED) && (*instr <= 0xFF);
+        }
+        program -= entry->instrCnt;
+    }
+    return false;
+}
+
+static void smplArena_SelectPrograms(void)
+{
+    for (uint8_t ch = 0; ch < SMPL_ARENA_CH_CNT; ch++)
+    {
+        uint32_t instr;
+        if (smplArena_ProgramToInstr(arenaProgram[ch], &instr))
+        {
+            Sampler_ProgramChange(ch, instr);
+        }
+    }
+}
+
+/*
+ * adds up to maxCnt recorded samples of an entry behind the instruments of the sampler
+ * returns true when the entry has been added completely
+ */
+static bool smplArena_AddToSampler(struct smpl_arena_entry_s *entry, uint32_t maxCnt)
+{
+    if (arenaAddPos == 0)
+    {
+        if ((entry->opCnt > 0) && !entry->ops[entry->opCnt - 1].instrumentDone)
+        {
+            /* the open instrument would be merged with the following one */
+            struct smpl_arena_op_s *op = smplArena_AddOp(entry);
+            if (op != NULL)
+            {
+                op->instrumentDone = true;
+                entry->instrCnt++;
+            }
+        }
+        entry->instrBase = arenaTableInstrCnt;
+    }
+
+    for (uint32_t i = 0; (i < maxCnt) && (arenaAddPos < entry->opCnt); i++)
+    {
+        struct smpl_arena_op_s *op = &entry->ops[arenaAddPos++];
+        if (op->instrumentDone)
+        {
+            Sampler_InstrumentDone();
+            arenaTableInstrCnt++;
+        }
+        else
+        {
+            SmplBank_AddSample(&op->region);
+        }
+    }
+
+    if (arenaAddPos < entry->opCnt)
+    {
+        return false;
+    }
+    arenaAddPos = 0;
+    entry->state = SMPL_ARENA_LOADED;
+    return true;
+}
+
+/*
+ * bytes moved in this block, reduced when the last block used more than half of its budget
+ */
+static uint32_t smplArena_MoveBudget(void)
+{
+    uint32_t budget = PerfMon_GetBudget();
+
+    if ((budget > 0) && (PerfMon_GetLastRender() > budget / 2))
+    {
+        return SMPL_ARENA_MOVE_MIN_BYTES;
+    }
+    return SMPL_ARENA_MOVE_BYTES;
+}
+
+static int32_t smplArena_NextMoving(void)
+{
+    uint8_t order[SMPL_ARENA_ENTRY_CNT];
+    uint32_t cnt = smplArena_Sort(order);
+
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        if (arenaEntries[order[i]].state == SMPL_ARENA_MOVING)
+        {
+            return order[i];
+        }
+    }
+    return -1;
+}
+
+static void smplArena_CompactDone(void)
+{
+    arenaTop = arenaMoveDst;
+    arenaCompactCnt++;
+    Serial.printf("arena: compacted, %" PRIu32 " kB moved in %" PRIu32 " ms, %" PRIu32 " kB free\n",
+                  (arenaMovedCnt * 2) / 1024, millis() - arenaMoveStartMs, ((arenaSize - arenaTop) * 2) / 1024);
+    smplArena_SetState(SMPL_ARENA_IDLE);
+}
+
+/*
+ * the sampler will be empty, the entries will be moved and added again by the following blocks
+ * no voice may be active
+ */
+static void smplArena_CompactStart(void)
+{
+    uint8_t order[SMPL_ARENA_ENTRY_CNT];
+    uint32_t cnt = smplArena_Sort(order);
+
+    arenaCompactPending = false;
+    arenaMoveStartMs = millis();
+    arenaMovedCnt = 0;
+
+    Sampler_ClearAllSamples();
+    VoiceAlloc_ClearExclusiveClasses();
+    Sampler_UseStaticBuffer(smplArena_Mem(), arenaSize);
+    Sampler_StartTransfer();
+    Sampler_EndTransfer();
+    arenaTableInstrCnt = 0;
+
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        struct smpl_arena_entry_s *entry = &arenaEntries[order[i]];
+        if (entry->state == SMPL_ARENA_UNLOADED)
+        {
+            smplArena_FreeOps(entry);
+            entry->state = SMPL_ARENA_FREE;
+        }
+        else
+        {
+            /* the entries in front of the first gap will be added without moving */
+            entry->state = SMPL_ARENA_MOVING;
+        }
+    }
+
+    arenaMoveDst = 0;
+    arenaMovePos = 0;
+    arenaAddPos = 0;
+    arenaMoveEntry = smplArena_NextMoving();
+    smplArena_SelectPrograms();
+
+    if (arenaMoveEntry < 0)
+    {
+        smplArena_CompactDone();
+    }
+}
+
+/*
+ * moves up to maxCnt samples of the entry or adds up to maxOps of its samples to the sampler
+ * the entry is added when it has been moved completely
+ */
+static void smplArena_MoveStep(uint32_t maxCnt, uint32_t maxOps)
+{
+    struct smpl_arena_entry_s *entry = &arenaEntries[arenaMoveEntry];
+
+    if (entry->start > arenaMoveDst)
+    {
+        if (arenaMovePos < entry->cnt)
+        {
+            uint32_t cnt = entry->cnt - arenaMovePos;
+            if (cnt > maxCnt)
+            {
+                cnt = maxCnt;
+            }
+            /* the destination is always in front of the source */
+            memmove(&smplArena_Mem()[arenaMoveDst + arenaMovePos], &smplArena_Mem()[entry->start + arenaMovePos], cnt * sizeof(Q1_14));
+            arenaMovePos += cnt;
+            arenaMovedCnt += cnt;
+            return;
+        }
+
+        uint32_t shift = entry->start - arenaMoveDst;
+        for (uint32_t i = 0; i < entry->opCnt; i++)
+        {
+            struct smpl_region_s *region = &entry->ops[i].region;
+            region->start -= shift;
+            region->end -= shift;
+            region->loopStart -= shift;
+            region->loopEnd -= shift;
+        }
+        entry->start = arenaMoveDst;
+    }
+
+    if (!smplArena_AddToSampler(entry, maxOps))
+    {
+        return;
+    }
+    smplArena_SelectPrograms();
+
+    arenaMoveDst = entry->start + entry->cnt;
+    arenaMovePos = 0;
+    arenaMoveEntry = smplArena_NextMoving();
+    if (arenaMoveEntry < 0)
+    {
+        smplArena_CompactDone();
+    }
+}
+
+/*
+ * the loader gets the arena, the load job waits for the compaction, the audio core completes it
+ */
+static void smplArena_Lock(void)
+{
+    if (LoadJob_InJob())
+    {
+        while ((smplArena_GetState() != SMPL_ARENA_LOADING) && !smplArena_TakeState(SMPL_ARENA_LOADING))
+        {
+            LoadJob_Yield();
+        }
+        return;
+    }
+
+    while (smplArena_GetState() == SMPL_ARENA_COMPACT)
+    {
+        smplArena_MoveStep(UINT32_MAX, UINT32_MAX);
+    }
+}
+
+/*
+ * continues the entry of the load or opens a new one at the end of the used memory
+ */
+static void smplArena_Open(void)
+{
+    if ((arenaLoad >= 0) && !arenaEntries[arenaLoad].sealed)
+    {
+        return;
+    }
+
+    arenaLoad = -1;
+    for (int32_t i = 0; i < SMPL_ARENA_ENTRY_CNT; i++)
+    {
+        struct smpl_arena_entry_s *entry = &arenaEntries[i];
+        if (entry->state == SMPL_ARENA_FREE)
+        {
+            entry->seq = arenaSeq++;
+            entry->start = arenaTop;
+            entry->cnt = 0;
+            entry->sealed = false;
+            entry->instrBase = arenaTableInstrCnt;
+            entry->instrCnt = 0;
+            smplArena_FreeOps(entry);
+            entry->state = SMPL_ARENA_LOADED;
+            arenaLoad = i;
+            arenaFull = false;
+            return;
+        }
+    }
+    Serial.printf("arena: all %d handles are used\n", SMPL_ARENA_ENTRY_CNT);
+}
+
+/*
+ * returns the memory for the next samples of the entry or NULL when the arena is full
+ */
+static Q1_14 *smplArena_Reserve(uint32_t cnt)
+{
+    if (arenaLoad < 0)
+    {
+        return NULL;
+    }
+
+    if (arenaTop + cnt > arenaSize)
+    {
+        if (!arenaFull)
+        {
+            Serial.printf("arena: full, %" PRIu32 " kB free\n", ((arenaSize - arenaTop) * 2) / 1024);
+            arenaFull = true;
+        }
+        return NULL;
+    }
+
+    Q1_14 *dst = &smplArena_Mem()[arenaTop];
+    arenaEntries[arenaLoad].cnt += cnt;
+    arenaTop += cnt;
+    return dst;
+}
+
+static void smplArena_HandleUnloadReq(void)
+{
+    uint32_t req = __atomic_exchange_n(&arenaUnloadReq, 0, __ATOMIC_ACQ_REL);
+    if (req == 0)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < SMPL_ARENA_ENTRY_CNT; i++)
+    {
+        struct smpl_arena_entry_s *entry = &arenaEntries[i];
+        if (((req & (1UL << i)) != 0) && (entry->state == SMPL_ARENA_LOADED))
+        {
+            entry->state = SMPL_ARENA_UNLOADED;
+            arenaCompactPending = true;
+            Serial.printf("arena: entry %" PRIu32 " unloaded, %" PRIu32 " kB will be freed\n", i, (entry->cnt * 2) / 1024);
+        }
+    }
+    /* the programs of the following entries have been moved down */
+    smplArena_SelectPrograms();
+}
+
+static void smplArena_PrintReport(void)
+{
+    uint8_t order[SMPL_ARENA_ENTRY_CNT];
+    uint32_t cnt = smplArena_Sort(order);
+    uint32_t pos = 0;
+    uint32_t liveCnt = 0;
+    uint32_t gapCnt = 0;
+    uint32_t largest = 0;
+
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        struct smpl_arena_entry_s *entry = &arenaEntries[order[i]];
+        if (entry->state == SMPL_ARENA_UNLOADED)
+        {
+            continue;
+        }
+        if (entry->start > pos)
+        {
+            gapCnt += entry->start - pos;
+            if (entry->start - pos > largest)
+            {
+                largest = entry->start - pos;
+            }
+        }
+        liveCnt += entry->cnt;
+        pos = entry->start + entry->cnt;
+    }
+    if (arenaSize - pos > largest)
+    {
+        largest = arenaSize - pos;
+    }
+
+    uint32_t freeCnt = arenaSize - liveCnt;
+    uint32_t frag = (freeCnt > 0) ? (100 - (uint32_t)(((uint64_t)largest * 100) / freeCnt)) : 0;
+
+    Serial.printf("arena: %" PRIu32 " of %" PRIu32 " kB used, %" PRIu32 " kB in gaps, largest free block %" PRIu32 " kB\n",
+                  (liveCnt * 2) / 1024, (arenaSize * 2) / 1024, (gapCnt * 2) / 1024, (largest * 2) / 1024);
+    Serial.printf("  fragmentation %" PRIu32 "%%, %" PRIu32 " compactions%s\n", frag, arenaCompactCnt,
+                  (smplArena_GetState() == SMPL_ARENA_COMPACT) ? ", compacting" : (arenaCompactPending ? ", compaction pending" : ""));
+
+    static const char *stateNames[] = { "free", "loaded", "unloaded", "moving" };
+    uint32_t program = 0;
+    for (uint32_t i = 0; i < SMPL_ARENA_ENTRY_CNT; i++)
+    {
+        struct smpl_arena_entry_s *entry = &arenaEntries[i];
+        if (entry->state == SMPL_ARENA_FREE)
+        {
+            continue;
+        }
+        Serial.printf("  entry %" PRIu32 ": %" PRIu32 " kB at %" PRIu32 " kB, %" PRIu32 " instruments", i,
+                      (entry->cnt * 2) / 1024, (entry->start * 2) / 1024, entry->instrCnt);
+        if ((entry->state != SMPL_ARENA_UNLOADED) && (entry->instrCnt > 0))
+        {
+            Serial.printf(" (programs %" PRIu32 "-%" PRIu32 ")", program, program + entry->instrCnt - 1);
+            program += entry->instrCnt;
+        }
+        Serial.printf(", %s\n", stateNames[entry->state]);
+    }
+}
+#endif
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * to be called by the audio core after the sample memory has been cleared
+ * the sampler will use the complete memory managed by the arena
+ */
+void SmplArena_Reset(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    for (uint32_t i = 0; i < SMPL_ARENA_ENTRY_CNT; i++)
+    {
+        smplArena_FreeOps(&arenaEntries[i]);
+        arenaEntries[i].state = SMPL_ARENA_FREE;
+    }
+    arenaSize = App_GetSampleMemSize() / sizeof(Q1_14);
+    arenaTop = 0;
+    arenaLoad = -1;
+    arenaTransfer = false;
+    arenaCompactPending = false;
+    arenaMoveEntry = -1;
+    __atomic_store_n(&arenaUnloadReq, 0, __ATOMIC_RELEASE);
+
+    Sampler_UseStaticBuffer(smplArena_Mem(), arenaSize);
+    Sampler_StartTransfer();
+    Sampler_EndTransfer();
+    arenaTableInstrCnt = 0;
+
+    smplArena_SetState(SMPL_ARENA_IDLE);
+    __atomic_store_n(&arenaReady, true, __ATOMIC_RELEASE);
+#endif
+}
+
+/*
+ * to be called by the audio core when the sample memory will be used without the arena
+ */
+void SmplArena_Invalidate(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    __atomic_store_n(&arenaReady, false, __ATOMIC_RELEASE);
+#endif
+}
+
+/*
+ * to be called when a requested load has been finished, the next load opens a new entry
+ */
+void SmplArena_LoadDone(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    arenaLoad = -1;
+    if (smplArena_GetState() == SMPL_ARENA_LOADING)
+    {
+        smplArena_SetState(SMPL_ARENA_IDLE);
+    }
+#endif
+}
+
+/*
+ * to be called by the audio core at the start of each block before the MIDI processing
+ */
+void SmplArena_Process(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (!smplArena_IsReady())
+    {
+        return;
+    }
+
+    if (smplArena_GetState() == SMPL_ARENA_COMPACT)
+    {
+        smplArena_MoveStep(smplArena_MoveBudget() / sizeof(Q1_14), SMPL_ARENA_ADD_CNT);
+        return;
+    }
+
+    smplArena_HandleUnloadReq();
+
+    if (arenaCompactPending && (VoiceAlloc_GetActiveCnt() == 0) && !LoadJob_IsBusy() && smplArena_TakeState(SMPL_ARENA_COMPACT))
+    {
+        /* nothing is audible, the unloaded entries can be removed from the sampler */
+        smplArena_CompactStart();
+    }
+#endif
+}
+
+/*
+ * selects the instrument of the arena, returns false when the arena is not used
+ */
+bool SmplArena_ProgramChange(uint8_t ch, uint8_t program)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (!smplArena_IsReady())
+    {
+        return false;
+    }
+
+    arenaProgram[ch % SMPL_ARENA_CH_CNT] = program;
+
+    uint32_t instr;
+    if (smplArena_ProgramToInstr(program, &instr))
+    {
+        Sampler_ProgramChange(ch, instr);
+    }
+    return true;
+#else
+    (void)ch;
+    (void)program;
+    return false;
+#endif
+}
+
+/*
+ * returns the handle of the entry of the last load, -1 if not available
+ */
+int32_t SmplArena_LastHandle(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    int32_t last = -1;
+    for (int32_t i = 0; i < SMPL_ARENA_ENTRY_CNT; i++)
+    {
+        if ((arenaEntries[i].state == SMPL_ARENA_LOADED) && ((last < 0) || (arenaEntries[i].seq > arenaEntries[last].seq)))
+        {
+            last = i;
+        }
+    }
+    return last;
+#else
+    return -1;
+#endif
+}
+
+/*
+ * returns the program of the first instrument of the entry, -1 when the entry is not loaded
+ * the programs of the following entries change when an entry in front of them is unloaded
+ */
+int32_t SmplArena_HandleToProgram(int32_t handle)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (!smplArena_IsReady() || (handle < 0) || (handle >= SMPL_ARENA_ENTRY_CNT)
+        || ((arenaEntries[handle].state != SMPL_ARENA_LOADED) && (arenaEntries[handle].state != SMPL_ARENA_MOVING)))
+    {
+        return -1;
+    }
+
+    int32_t program = 0;
+    for (int32_t i = 0; i < handle; i++)
+    {
+        if ((arenaEntries[i].state == SMPL_ARENA_LOADED) || (arenaEntries[i].state == SMPL_ARENA_MOVING))
+        {
+            program += arenaEntries[i].instrCnt;
+        }
+    }
+    return program;
+#else
+    (void)handle;
+    return -1;
+#endif
+}
+
+/*
+ * removes the instruments of the entry, the memory will be freed by the next compaction
+ * can be called from any core, the entry is removed by the audio core
+ */
+bool SmplArena_Unload(int32_t handle)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (!smplArena_IsReady() || (handle < 0) || (handle >= SMPL_ARENA_ENTRY_CNT) || (arenaEntries[handle].state != SMPL_ARENA_LOADED))
+    {
+        Serial.printf("arena: entry %" PRId32 " not loaded\n", handle);
+        return false;
+    }
+    __atomic_fetch_or(&arenaUnloadReq, 1UL << handle, __ATOMIC_ACQ_REL);
+    return true;
+#else
+    (void)handle;
+    return false;
+#endif
+}
+
+/*
+ * serial command: "arena" prints the entries, "arena free <n>" unloads the entry n
+ */
+void SmplArena_Cmd(const char *args)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (strncmp(args, "free ", 5) == 0)
+    {
+        SmplArena_Unload(atoi(&args[5]));
+        return;
+    }
+
+    if (!smplArena_IsReady())
+    {
+        Serial.printf("arena: not used (the next clear will prepare the arena)\n");
+        return;
+    }
+    smplArena_PrintReport();
+#else
+    (void)args;
+    Serial.printf("arena not available (SMPL_ARENA_ENABLED without the hot swap is required)\n");
+#endif
+}
+
+/*
+ * the samples will be appended to the entry of the load, returns true when the transfer belongs to the arena
+ */
+bool SmplArena_TransferStart(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (!smplArena_IsReady())
+    {
+        return false;
+    }
+    smplArena_Lock();
+    smplArena_Open();
+    arenaTransferBase = arenaTop;
+    arenaTransfer = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SmplArena_TransferEnd(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    bool ret = arenaTransfer;
+    arenaTransfer = false;
+    return ret;
+#else
+    return false;
+#endif
+}
+
+bool SmplArena_IsLoading(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    return arenaTransfer;
+#else
+    return false;
+#endif
+}
+
+/*
+ * gets the samples behind the last entry, the gaps of unloaded entries count after the next compaction
+ * returns false when the arena is not used
+ */
+bool SmplArena_GetFree(uint32_t *cnt)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (!smplArena_IsReady())
+    {
+        return false;
+    }
+    *cnt = arenaSize - arenaTop;
+    return true;
+#else
+    (void)cnt;
+    return false;
+#endif
+}
+
+/*
+ * returns the memory for the next samples of the entry, to be filled by the caller (no copy)
+ * returns NULL when the arena is full or not used
+ */
+Q1_14 *SmplArena_ReserveSamples(uint32_t cnt)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    return smplArena_Reserve(cnt);
+#else
+    (void)cnt;
+    return NULL;
+#endif
+}
+
+bool SmplArena_AddSamples(const Q1_14 *samples, uint32_t cnt)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    Q1_14 *dst = smplArena_Reserve(cnt);
+    if (dst == NULL)
+    {
+        return false;
+    }
+    memcpy(dst, samples, cnt * sizeof(Q1_14));
+    return true;
+#else
+    (void)samples;
+    (void)cnt;
+    return false;
+#endif
+}
+
+/*
+ * converts unsigned 8 bit samples to the full scale of the 16 bit samples
+ */
+bool SmplArena_AddSamplesU8(const uint8_t *samples, uint32_t cnt)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    Q1_14 *dst = smplArena_Reserve(cnt);
+    if (dst == NULL)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        dst[i].s16 = (int16_t)(((int32_t)samples[i] - 128) * 256);
+    }
+    return true;
+#else
+    (void)samples;
+    (void)cnt;
+    return false;
+#endif
+}
+
+/*
+ * records the region in the entry of the load and adds it to the sampler (deferred when called by the job)
+ * returns false when the arena is not used
+ */
+bool SmplArena_AddRegion(const struct smpl_region_s *region)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (!smplArena_IsReady())
+    {
+        return false;
+    }
+    if (arenaLoad < 0)
+    {
+        /* the sample data is not part of the arena */
+        return true;
+    }
+    smplArena_Lock();
+
+    struct smpl_region_s absRegion = *region;
+    absRegion.start += arenaTransferBase;
+    absRegion.end += arenaTransferBase;
+    absRegion.loopStart += arenaTransferBase;
+    absRegion.loopEnd += arenaTransferBase;
+
+    struct smpl_arena_op_s *op = smplArena_AddOp(&arenaEntries[arenaLoad]);
+    if (op != NULL)
+    {
+        op->instrumentDone = false;
+        op->region = absRegion;
+    }
+
+    /* the job has not started a transfer of its own, its positions are not moved */
+    if (!LoadJob_DeferRegion(&absRegion))
+    {
+        SmplBank_AddSample(&absRegion);
+    }
+    return true;
+#else
+    (void)region;
+    return false;
+#endif
+}
+
+bool SmplArena_InstrumentDone(void)
+{
+#ifdef SMPL_ARENA_ACTIVE
+    if (!smplArena_IsReady())
+    {
+        return false;
+    }
+    if (arenaLoad < 0)
+    {
+        return true;
+    }
+    smplArena_Lock();
+
+    struct smpl_arena_entry_s *entry = &arenaEntries[arenaLoad];
+    struct smpl_arena_op_s *op = smplArena_AddOp(entry);
+    if (op != NULL)
+    {
+        op->instrumentDone = true;
+    }
+    entry->instrCnt++;
+    entry->sealed = true;
+    arenaTableInstrCnt++;
+
+    if (!LoadJob_DeferInstrumentDone())
+    {
+        Sampler_InstrumentDone();
+    }
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file smpl_arena.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Sample memory arena, loaded instruments can be removed without reloading the others
+ * @n       See smpl_arena.cpp
+ */
+
+
+#ifndef SMPL_ARENA_H_
+#define SMPL_ARENA_H_
+
+
+/*
+ * includes
+ */
+#include "config.h"
+#include "hot_swap.h"
+#include "smpl_bank.h"
+
+#include <ml_types.h>
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#if (defined SMPL_ARENA_ENABLED) && !(defined HOT_SWAP_ACTIVE)
+#define SMPL_ARENA_ACTIVE /*!< the loaded data is tracked per entry and can be removed */
+#endif
+
+
+/*
+ * declarations
+ */
+void SmplArena_Reset(void);
+void SmplArena_Invalidate(void);
+void SmplArena_LoadDone(void);
+void SmplArena_Process(void);
+bool SmplArena_ProgramChange(uint8_t ch, uint8_t program);
+int32_t SmplArena_LastHandle(void);
+int32_t SmplArena_HandleToProgram(int32_t handle);
+bool SmplArena_Unload(int32_t handle);
+void SmplArena_Cmd(const char *args);
+
+/* called by the sample transfer and the sample bank */
+bool SmplArena_TransferStart(void);
+bool SmplArena_TransferEnd(void);
+bool SmplArena_IsLoading(void);
+bool SmplArena_GetFree(uint32_t *cnt);
+Q1_14 *SmplArena_ReserveSamples(uint32_t cnt);
+bool SmplArena_AddSamples(const Q1_14 *samples, uint32_t cnt);
+bool SmplArena_AddSamplesU8(const uint8_t *samples, uint32_t cnt);
+bool SmplArena_AddRegion(const struct smpl_region_s *region);
+bool SmplArena_InstrumentDone(void);
+
+
+#endif /* SMPL_ARENA_H_ */
@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file smpl_bank.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Loader of the prebuilt sample bank image
+ * @n       The image is read with one sequential pass: header, region table and the sample data
+ * @n       which is passed to the sampler without conversion. No soundfont parsing is required.
+ * @n       An image located in memory mapped flash (XIP on RP2040/RP2350, partition mmap on ESP32)
+ * @n       will be used directly as sample memory of the sampler, nothing is copied into RAM.
+ * @n       The sampler only supports one sample memory, so a mapped bank replaces all loaded
+ * @n       samples until SmplBank_Unmap selects the RAM buffer again.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "smpl_bank.h"
+#include "sample_transfer.h"
+#include "voice_alloc.h"
+#include "smpl_snapshot.h"
+#include "load_job.h"
+#include "load_step.h"
+#include "hot_swap.h"
+#include "smpl_arena.h"
+#include "app.h"
+
+#include <ml_sampler.h>
+#include <ml_status.h>
+
+#ifdef ESP32
+#include <esp_idf_version.h>
+#include <esp_partition.h>
+#if ESP_IDF_VERSION_MAJOR < 5
+#define ESP_PARTITION_MMAP_DATA SPI_FLASH_MMAP_DATA
+#define esp_partition_munmap spi_flash_munmap
+typedef spi_flash_mmap_handle_t esp_partition_mmap_handle_t;
+#endif
+#endif
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/regs/addressmap.h>
+#endif
+#ifdef ML_HOST_BUILD
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+/*
+ * defines
+ */
+#define SMPL_BANK_REGION_CNT_MAX    (64 * 1024) /*!< far more than the sample memory can hold, larger counts are corrupt */
+
+
+/*
+ * static function declarations
+ */
+static void smplBank_ApplyRegions(const struct smpl_region_s *regions, uint32_t regionCnt);
+static bool smplBank_FileHolds(uint64_t size);
+static void smplBank_Release(void);
+
+
+/*
+ * static variables
+ */
+static bool bankMapped = false;
+#ifdef ESP32
+static esp_partition_mmap_handle_t bankMapHandle;
+static bool bankMapHandleValid = false;
+#endif
+#ifdef ML_HOST_BUILD
+static void *bankMapAddr = NULL;
+static size_t bankMapSize = 0;
+#endif
+
+
+/*
+ * static function definitions
+ */
+static void smplBank_ApplyRegions(const struct smpl_region_s *regions, uint32_t regionCnt)
+{
+    for (uint32_t i = 0; i < regionCnt; i++)
+    {
+        SmplBank_ApplyRegion(&regions[i]);
+        if ((i + 1 == regionCnt) || (regions[i + 1].instrument != regions[i].instrument))
+        {
+            SmplBank_InstrumentDone();
+        }
+    }
+}
+
+/*
+ * true when the opened file is at least size bytes long, the read position is kept
+ */
+static bool smplBank_FileHolds(uint64_t size)
+{
+    if ((size == 0) || (size > UINT32_MAX))
+    {
+        return false;
+    }
+
+    uint32_t pos = getCurrentOffset();
+    uint8_t last;
+    fileSeekTo((uint32_t)(size - 1));
+    bool ret = (readBytes(&last, 1) == 1);
+    fileSeekTo(pos);
+    return ret;
+}
+
+/*
+ * releases the mapping of the platform
+ */
+static void smplBank_Release(void)
+{
+#ifdef ESP32
+    if (bankMapHandleValid)
+    {
+        esp_partition_munmap(bankMapHandle);
+        bankMapHandleValid = false;
+    }
+#endif
+#ifdef ML_HOST_BUILD
+    if (bankMapAddr != NULL)
+    {
+        munmap(bankMapAddr, bankMapSize);
+        bankMapAddr = NULL;
+    }
+#endif
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * adds a sample described by the region, the sample data must have been transferred before
+ * the sample will be added by the audio core after the load job when called by the job
+ * or recorded for the bank of the hot swap, the plan of a stepped load or the entry of the arena
+ */
+void SmplBank_ApplyRegion(const struct smpl_region_s *region)
+{
+    if (HotSwap_AddRegion(region) || LoadStep_DeferRegion(region) || SmplArena_AddRegion(region) || LoadJob_DeferRegion(region)
+        || SmplBank_AddSample(region))
+    {
+        SmplSnapshot_Region(region);
+    }
+}
+
+/*
+ * adds the sample to the sampler immediately
+ */
+bool SmplBank_AddSample(const struct smpl_region_s *region)
+{
+    if (!Sampler_NewSample())
+    {
+        Serial.printf("Could not add sample (SmplBank_AddSample)!\n");
+        return false;
+    }
+
+    Sampler_NewSampleSetRange(region->start, region->end);
+
+    if ((region->loopMode == 1) || (region->loopMode == 3))
+    {
+        if ((region->loopStart != region->start) || (region->loopEnd != region->end))
+        {
+            Sampler_NewSampleSetLoop(region->loopStart, region->loopEnd);
+        }
+        Sampler_SetLoopMode(region->loopMode);
+    }
+
+    Sampler_SetExclusiveClass(region->exClass);
+    Sampler_SetPitch(region->rootKey, region->sampleRate, region->tune);
+#ifdef MULTIPLE_SAMPLE_PER_INSTRUMENT
+    Sampler_SetKeyRange(region->keyLow, region->keyHigh);
+    Sampler_SetVelRange(region->velLow, region->velHigh);
+    VoiceAlloc_SetExclusiveClass(region->keyLow, region->keyHigh, region->exClass);
+#else
+    if (region->flags & SMPL_REGION_FLAG_KEY_RANGE)
+    {
+        Sampler_SetKeyRange(region->keyLow, region->keyHigh);
+    }
+    VoiceAlloc_SetExclusiveClass(0, 127, region->exClass);
+#endif
+
+    if (region->hold != 0)
+    {
+        Sampler_SetHold(region->hold);
+    }
+    if (region->release != 0)
+    {
+        Sampler_SetRelease(region->release);
+    }
+
+    Sampler_FinishSample();
+    return true;
+}
+
+/*
+ * finishes the instrument, to be used instead of Sampler_InstrumentDone to keep a snapshot complete
+ */
+void SmplBank_InstrumentDone(void)
+{
+    if (!HotSwap_InstrumentDone() && !LoadStep_DeferInstrumentDone() && !SmplArena_InstrumentDone() && !LoadJob_DeferInstrumentDone())
+    {
+        Sampler_InstrumentDone();
+    }
+    SmplSnapshot_InstrumentDone();
+}
+
+/*
+ * loads a bank image, the instruments are appended to the already loaded ones
+ */
+bool SmplBank_Load(fs_id_t fs_id, const char *filename)
+{
+    struct smpl_bank_hdr_s hdr;
+    struct smpl_region_s *regions = NULL;
+    bool ret = false;
+
+    if (!FS_OpenFile(fs_id, filename))
+    {
+        Status_ValueChangedStr("Sample bank", "Loading failed!", filename);
+        return false;
+    }
+    LoadStep_FileBegin(fs_id, filename);
+
+    if ((readBytes((uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr)) || (hdr.magic != SMPL_BANK_MAGIC))
+    {
+        Serial.printf("%s is not a sample bank\n", filename);
+    }
+    else if ((hdr.version != SMPL_BANK_VERSION) || (hdr.regionSize != sizeof(struct smpl_region_s)))
+    {
+        Serial.printf("sample bank version %u not supported, please convert it again\n", hdr.version);
+    }
+    else if (hdr.regionCnt > SMPL_BANK_REGION_CNT_MAX)
+    {
+        Serial.printf("sample bank with %" PRIu32 " regions not supported\n", hdr.regionCnt);
+    }
+    else if (!smplBank_FileHolds(sizeof(hdr) + (uint64_t)hdr.regionCnt * sizeof(struct smpl_region_s) + (uint64_t)hdr.pcmCnt * 2))
+    {
+        Serial.printf("sample bank truncated\n");
+    }
+    else if ((hdr.regionCnt > 0) && ((regions = (struct smpl_region_s *)malloc(hdr.regionCnt * sizeof(struct smpl_region_s))) == NULL))
+    {
+        Serial.printf("Not enough memory for %" PRIu32 " regions\n", hdr.regionCnt);
+    }
+    else
+    {
+        /* snapshots store the regions behind the sample data (see smpl_snapshot.cpp) */
+        bool regionsLast = (hdr.flags & SMPL_BANK_FLAG_REGIONS_LAST) != 0;
+        uint32_t regionBytes = hdr.regionCnt * sizeof(struct smpl_region_s);
+
+        ret = regionsLast || (regionBytes == 0) || (readBytes((uint8_t *)regions, regionBytes) == regionBytes);
+        if (ret)
+        {
+            SampleTransfer_Start();
+            ret = SampleTransfer_Read(hdr.pcmCnt * 2);
+            SampleTransfer_End();
+        }
+        if (ret && regionsLast && (regionBytes > 0))
+        {
+            ret = (readBytes((uint8_t *)regions, regionBytes) == regionBytes);
+        }
+
+        if (ret)
+        {
+            smplBank_ApplyRegions(regions, hdr.regionCnt);
+            Serial.printf("sample bank: %" PRIu32 " instruments, %" PRIu32 " regions, %" PRIu32 " kB\n",
+                          hdr.instrumentCnt, hdr.regionCnt, (hdr.pcmCnt * 2) / 1024);
+        }
+        else
+        {
+            Serial.printf("sample bank truncated\n");
+        }
+    }
+
+    free(regions);
+    LoadStep_FileEnd();
+    FS_CloseFile();
+
+    Status_ValueChangedStr("Sample bank", ret ? "Loaded" : "Loading failed!", filename);
+    return ret;
+}
+
+/*
+ * plays the bank image from memory mapped flash, the image must stay mapped while in use
+ */
+bool SmplBank_Map(const void *image, uint32_t size)
+{
+    const struct smpl_bank_hdr_s *hdr = (const struct smpl_bank_hdr_s *)image;
+
+    if ((image == NULL) || (size < sizeof(*hdr)) || (hdr->magic != SMPL_BANK_MAGIC))
+    {
+        Serial.printf("no sample bank found in flash\n");
+        return false;
+    }
+    if ((hdr->version != SMPL_BANK_VERSION) || (hdr->regionSize != sizeof(struct smpl_region_s)))
+    {
+        Serial.printf("sample bank version %u not supported, please convert it again\n", hdr->version);
+        return false;
+    }
+
+    uint64_t pcmOffset = sizeof(*hdr) + (uint64_t)hdr->regionCnt * sizeof(struct smpl_region_s);
+    if (((uintptr_t)image & 1) || (pcmOffset + (uint64_t)hdr->pcmCnt * 2 > size))
+    {
+        Serial.printf("sample bank truncated or not aligned\n");
+        return false;
+    }
+
+    const struct smpl_region_s *regions = (const struct smpl_region_s *)&hdr[1];
+    Q1_14 *pcm = (Q1_14 *)((uintptr_t)image + pcmOffset);
+    if (hdr->flags & SMPL_BANK_FLAG_REGIONS_LAST)
+    {
+        pcm = (Q1_14 *)&hdr[1];
+        regions = (const struct smpl_region_s *)((uintptr_t)pcm + hdr->pcmCnt * 2);
+        if ((uintptr_t)regions & 3)
+        {
+            Serial.printf("sample bank regions not aligned\n");
+            return false;
+        }
+    }
+
+    /* mapped data does not pass the sample transfer */
+    SmplSnapshot_Invalidate("mapped sample bank");
+    HotSwap_Invalidate();
+    SmplArena_Invalidate();
+
+    VoiceAlloc_AllNotesOff();
+    Sampler_AllNotesOff();
+    if (!bankMapped)
+    {
+        /* the samples in RAM can be cleared as long as the RAM is the sample memory */
+        Sampler_ClearAllSamples();
+    }
+    VoiceAlloc_ClearExclusiveClasses();
+
+    /* the sample data is already in place, the sampler will never write into it */
+    Sampler_UseStaticBuffer(pcm, hdr->pcmCnt);
+    Sampler_StartTransfer();
+    Sampler_EndTransfer();
+    /* nothing can be loaded next to the mapped image */
+    SampleTransfer_SetMemUsed(UINT32_MAX);
+    smplBank_ApplyRegions(regions, hdr->regionCnt);
+    bankMapped = true;
+
+    Serial.printf("mapped sample bank: %" PRIu32 " instruments, %" PRIu32 " regions, %" PRIu32 " kB\n",
+                  hdr->instrumentCnt, hdr->regionCnt, (hdr->pcmCnt * 2) / 1024);
+    Status_ValueChangedStr("Sample bank", "Mapped", "flash");
+    return true;
+}
+
+/*
+ * selects the sample memory in RAM again, all samples will be removed
+ */
+void SmplBank_Unmap(void)
+{
+    if (!bankMapped)
+    {
+        return;
+    }
+
+    VoiceAlloc_AllNotesOff();
+    Sampler_AllNotesOff();
+    App_RestoreSampleMem();
+    Sampler_ClearAllSamples();
+    SampleTransfer_SetMemUsed(0);
+    VoiceAlloc_ClearExclusiveClasses();
+    smplBank_Release();
+    bankMapped = false;
+}
+
+#ifdef ARDUINO_ARCH_RP2040
+/*
+ * the image has been written to the flash at flashOffset (outside of the sketch and the file system)
+ */
+bool SmplBank_MapXip(uint32_t flashOffset, uint32_t size)
+{
+    return SmplBank_Map((const void *)(XIP_BASE + flashOffset), size);
+}
+#endif
+
+#ifdef ESP32
+/*
+ * the image has been written into a data partition, e.g. using: parttool.py write_partition --partition-name samples
+ */
+bool SmplBank_MapPartition(const char *label)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (part == NULL)
+    {
+        Serial.printf("partition %s not found\n", label);
+        return false;
+    }
+
+    const void *image = NULL;
+    esp_partition_mmap_handle_t handle;
+    if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &image, &handle) != ESP_OK)
+    {
+        Serial.printf("partition %s could not be mapped\n", label);
+        return false;
+    }
+
+    if (!SmplBank_Map(image, part->size))
+    {
+        esp_partition_munmap(handle);
+        return false;
+    }
+
+    smplBank_Release();
+    bankMapHandle = handle;
+    bankMapHandleValid = true;
+    return true;
+}
+#endif
+
+#ifdef ML_HOST_BUILD
+/*
+ * maps a bank image file, this is used to test the flash playback on the host
+ */
+bool SmplBank_MapFile(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        Serial.printf("Failed to open %s\n", path);
+        return false;
+    }
+
+    struct stat st;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0)
+    {
+        addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (addr == MAP_FAILED)
+    {
+        Serial.printf("Failed to map %s\n", path);
+        return false;
+    }
+
+    if (!SmplBank_Map(addr, st.st_size))
+    {
+        munmap(addr, st.st_size);
+        return false;
+    }
+
+    smplBank_Release();
+    bankMapAddr = addr;
+    bankMapSize = st.st_size;
+    return true;
+}
+#endif
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file smpl_bank.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the prebuilt sample bank image
+ * @n       The image is written by the host converter (host/host_bank_convert.cpp) and contains:
+ * @n       struct smpl_bank_hdr_s
+ * @n       struct smpl_region_s regions[regionCnt], sorted by instrument
+ * @n       int16_t pcm[pcmCnt], mono 16 bit in the layout of Q1_14
+ * @n       All values are stored little endian.
+ * @n       An image in memory mapped flash can be played without copying (SmplBank_Map).
+ */
+
+
+#ifndef SMPL_BANK_H_
+#define SMPL_BANK_H_
+
+
+/*
+ * includes
+ */
+#include "fs/fs_access.h"
+
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#define SMPL_BANK_MAGIC     0x42534C4D /*!< "MLSB" */
+#define SMPL_BANK_VERSION   1
+
+#define SMPL_BANK_FLAG_REGIONS_LAST (1 << 0) /*!< the region table follows the sample data */
+
+#define SMPL_REGION_FLAG_KEY_RANGE  (1 << 0) /*!< the key range is always applied (one sample per key) */
+
+
+/*
+ * data types
+ */
+struct smpl_bank_hdr_s
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t regionSize; /*!< sizeof(struct smpl_region_s) used by the writer */
+    uint32_t regionCnt;
+    uint32_t instrumentCnt;
+    uint32_t pcmCnt; /*!< samples following the region table */
+    uint32_t flags;
+};
+
+/*
+ * one sample with its key range and precomputed envelope
+ * start, end and the loop are positions within the pcm data of the bank
+ */
+struct smpl_region_s
+{
+    uint32_t start;
+    uint32_t end;
+    uint32_t loopStart;
+    uint32_t loopEnd;
+    uint32_t sampleRate;
+    uint32_t hold; /*!< value for Sampler_SetHold, 0 keeps the default */
+    uint32_t release; /*!< value for Sampler_SetRelease, 0 keeps the default */
+    int16_t tune;
+    uint8_t loopMode; /*!< 0: no loop, otherwise the sample modus of the soundfont */
+    uint8_t exClass;
+    uint8_t rootKey;
+    uint8_t keyLow;
+    uint8_t keyHigh;
+    uint8_t velLow;
+    uint8_t velHigh;
+    uint8_t instrument; /*!< index of the instrument, the regions are sorted by it */
+    uint8_t flags;
+    uint8_t reserved;
+};
+
+
+/*
+ * declarations
+ */
+void SmplBank_ApplyRegion(const struct smpl_region_s *region);
+bool SmplBank_AddSample(const struct smpl_region_s *region);
+void SmplBank_InstrumentDone(void);
+bool SmplBank_Load(fs_id_t fs_id, const char *filename);
+bool SmplBank_Map(const void *image, uint32_t size);
+void SmplBank_Unmap(void);
+#ifdef ARDUINO_ARCH_RP2040
+bool SmplBank_MapXip(uint32_t flashOffset, uint32_t size);
+#endif
+#ifdef ESP32
+bool SmplBank_MapPartition(const char *label);
+#endif
+#ifdef ML_HOST_BUILD
+bool SmplBank_MapFile(const char *path);
+#endif
+
+
+#endif /* SMPL_BANK_H_ */
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file smpl_codec.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Compressed storage of streamed sample data, 8 bit mu-law and 4 bit IMA-ADPCM
+ * @n       mu-law halves the memory and can be decoded per sample by a table lookup.
+ * @n       IMA-ADPCM uses 36 bytes per 64 samples (factor 3.6) but can only be decoded per block.
+ * @n       Each block starts with the exact first sample and the step index, so a block can be decoded
+ * @n       without its predecessors and the first sample of the following block is known without decoding.
+ * @n       The codecs are used by the stream voices for the data kept in memory (see stream_voice.cpp),
+ * @n       the cost of decoding is measured by the benchmark (see bench.cpp).
+ * @n       The sampler of the library plays 16 bit data from its own memory only, samples loaded
+ * @n       into the sample memory are not compressed.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "smpl_codec.h"
+
+
+/*
+ * defines
+ */
+#define SMPL_ULAW_BIAS  0x84
+#define SMPL_ULAW_CLIP  32635
+
+
+/*
+ * static function declarations
+ */
+static uint8_t smplCodec_EncodeULaw(int32_t sample);
+static void smplCodec_EncodeAdpcmBlock(const int16_t *src, uint32_t cnt, uint8_t *dst, uint8_t *index);
+static inline int32_t smplCodec_AdpcmStep(uint8_t nibble, int32_t *predictor, int32_t *index);
+
+
+/*
+ * static variables
+ */
+static const int8_t adpcmIndexTable[16] =
+{
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+static const int16_t adpcmStepTable[89] =
+{
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+
+/*
+ * extern variables
+ */
+const int16_t smplCodecULaw[256] =
+{
+    -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956,
+    -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764,
+    -15996, -15484, -14972, -14460, -13948, -13436, -12924, -12412,
+    -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316,
+    -7932, -7676, -7420, -7164, -6908, -6652, -6396, -6140,
+    -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092,
+    -3900, -3772, -3644, -3516, -3388, -3260, -3132, -3004,
+    -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980,
+    -1884, -1820, -1756, -1692, -1628, -1564, -1500, -1436,
+    -1372, -1308, -1244, -1180, -1116, -1052, -988, -924,
+    -876, -844, -812, -780, -748, -716, -684, -652,
+    -620, -588, -556, -524, -492, -460, -428, -396,
+    -372, -356, -340, -324, -308, -292, -276, -260,
+    -244, -228, -212, -196, -180, -164, -148, -132,
+    -120, -112, -104, -96, -88, -80, -72, -64,
+    -56, -48, -40, -32, -24, -16, -8, 0,
+    32124, 31100, 30076, 29052, 28028, 27004, 25980, 24956,
+    23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764,
+    15996, 15484, 14972, 14460, 13948, 13436, 12924, 12412,
+    11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316,
+    7932, 7676, 7420, 7164, 6908, 6652, 6396, 6140,
+    5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092,
+    3900, 3772, 3644, 3516, 3388, 3260, 3132, 3004,
+    2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980,
+    1884, 1820, 1756, 1692, 1628, 1564, 1500, 1436,
+    1372, 1308, 1244, 1180, 1116, 1052, 988, 924,
+    876, 844, 812, 780, 748, 716, 684, 652,
+    620, 588, 556, 524, 492, 460, 428, 396,
+    372, 356, 340, 324, 308, 292, 276, 260,
+    244, 228, 212, 196, 180, 164, 148, 132,
+    120, 112, 104, 96, 88, 80, 72, 64,
+    56, 48, 40, 32, 24, 16, 8, 0,
+};
+
+
+/*
+ * static function definitions
+ */
+static uint8_t smplCodec_EncodeULaw(int32_t sample)
+{
+    uint8_t sign = 0;
+    if (sample < 0)
+    {
+        sign = 0x80;
+        sample = -sample;
+    }
+    if (sample > SMPL_ULAW_CLIP)
+    {
+        sample = SMPL_ULAW_CLIP;
+    }
+    sample += SMPL_ULAW_BIAS;
+
+    uint8_t exponent = 7;
+    for (int32_t mask = 0x4000; ((sample & mask) == 0) && (exponent > 0); mask >>= 1)
+    {
+        exponent--;
+    }
+    uint8_t mantissa = (sample >> (exponent + 3)) & 0x0F;
+
+    return ~(sign | (exponent << 4) | mantissa);
+}
+
+/*
+ * updates the predictor by one nibble, the same code is used by the encoder and the decoder
+ */
+static inline int32_t smplCodec_AdpcmStep(uint8_t nibble, int32_t *predictor, int32_t *index)
+{
+    int32_t step = adpcmStepTable[*index];
+    int32_t diff = step >> 3;
+
+    if (nibble & 4)
+    {
+        diff += step;
+    }
+    if (nibble & 2)
+    {
+        diff += step >> 1;
+    }
+    if (nibble & 1)
+    {
+        diff += step >> 2;
+    }
+
+    int32_t value = (nibble & 8) ? (*predictor - diff) : (*predictor + diff);
+    value = (value > INT16_MAX) ? INT16_MAX : ((value < INT16_MIN) ? INT16_MIN : value);
+    *predictor = value;
+
+    int32_t newIndex = *index + adpcmIndexTable[nibble];
+    *index = (newIndex < 0) ? 0 : ((newIndex > 88) ? 88 : newIndex);
+
+    return value;
+}
+
+/*
+ * encodes up to SMPL_ADPCM_BLOCK_SAMPLES samples into one block, a shorter block repeats its last sample
+ * the step index continues from the previous block
+ */
+static void smplCodec_EncodeAdpcmBlock(const int16_t *src, uint32_t cnt, uint8_t *dst, uint8_t *index)
+{
+    int32_t predictor = src[0];
+    int32_t idx = *index;
+
+    memset(dst, 0, SMPL_ADPCM_BLOCK_BYTES);
+    dst[0] = predictor & 0xFF;
+    dst[1] = (predictor >> 8) & 0xFF;
+    dst[2] = idx;
+
+    for (uint32_t i = 1; i < SMPL_ADPCM_BLOCK_SAMPLES; i++)
+    {
+        int32_t diff = src[(i < cnt) ? i : (cnt - 1)] - predictor;
+        int32_t step = adpcmStepTable[idx];
+        uint8_t nibble = 0;
+
+        if (diff < 0)
+        {
+            nibble = 8;
+            diff = -diff;
+        }
+        if (diff >= step)
+        {
+            nibble |= 4;
+            diff -= step;
+        }
+        if (diff >= (step >> 1))
+        {
+            nibble |= 2;
+            diff -= step >> 1;
+        }
+        if (diff >= (step >> 2))
+        {
+            nibble |= 1;
+        }
+
+        smplCodec_AdpcmStep(nibble, &predictor, &idx);
+        dst[4 + (i - 1) / 2] |= ((i - 1) & 1) ? (nibble << 4) : nibble;
+    }
+
+    *index = idx;
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * returns the bytes required to store cnt samples
+ */
+uint32_t SmplCodec_Size(enum smpl_codec_e codec, uint32_t cnt)
+{
+    switch (codec)
+    {
+    case SMPL_CODEC_ULAW:
+        return cnt;
+    case SMPL_CODEC_ADPCM:
+        return ((cnt + SMPL_ADPCM_BLOCK_SAMPLES - 1) / SMPL_ADPCM_BLOCK_SAMPLES) * SMPL_ADPCM_BLOCK_BYTES;
+    default:
+        return cnt * sizeof(int16_t);
+    }
+}
+
+const char *SmplCodec_Name(enum smpl_codec_e codec)
+{
+    switch (codec)
+    {
+    case SMPL_CODEC_ULAW:
+        return "ulaw";
+    case SMPL_CODEC_ADPCM:
+        return "adpcm";
+    default:
+        return "pcm";
+    }
+}
+
+bool SmplCodec_FromName(const char *name, enum smpl_codec_e *codec)
+{
+    static const enum smpl_codec_e codecs[] = { SMPL_CODEC_PCM, SMPL_CODEC_ULAW, SMPL_CODEC_ADPCM };
+
+    for (uint32_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++)
+    {
+        if (strcmp(name, SmplCodec_Name(codecs[i])) == 0)
+        {
+            *codec = codecs[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * encodes cnt samples, a sample can be encoded in parts of multiples of SMPL_ADPCM_BLOCK_SAMPLES
+ * adpcmIndex keeps the step index between the parts, it must be 0 for the first part
+ */
+void SmplCodec_Encode(enum smpl_codec_e codec, const int16_t *src, uint32_t cnt, uint8_t *dst, uint8_t *adpcmIndex)
+{
+    switch (codec)
+    {
+    case SMPL_CODEC_ULAW:
+        for (uint32_t i = 0; i < cnt; i++)
+        {
+            dst[i] = smplCodec_EncodeULaw(src[i]);
+        }
+        break;
+
+    case SMPL_CODEC_ADPCM:
+        for (uint32_t i = 0; i < cnt; i += SMPL_ADPCM_BLOCK_SAMPLES)
+        {
+            uint32_t blockCnt = (cnt - i > SMPL_ADPCM_BLOCK_SAMPLES) ? SMPL_ADPCM_BLOCK_SAMPLES : (cnt - i);
+            smplCodec_EncodeAdpcmBlock(&src[i], blockCnt, dst, adpcmIndex);
+            dst += SMPL_ADPCM_BLOCK_BYTES;
+        }
+        break;
+
+    default:
+        memcpy(dst, src, cnt * sizeof(int16_t));
+        break;
+    }
+}
+
+void SmplCodec_DecodeULaw(const uint8_t *src, int16_t *dst, uint32_t cnt)
+{
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        dst[i] = smplCodecULaw[src[i]];
+    }
+}
+
+/*
+ * decodes cnt samples starting at the beginning of the block src
+ */
+void SmplCodec_DecodeAdpcm(const uint8_t *src, int16_t *dst, uint32_t cnt)
+{
+    while (cnt > 0)
+    {
+        int32_t predictor = SmplCodec_AdpcmFirst(src);
+        int32_t index = (src[2] > 88) ? 88 : src[2];
+        uint32_t blockCnt = (cnt > SMPL_ADPCM_BLOCK_SAMPLES) ? SMPL_ADPCM_BLOCK_SAMPLES : cnt;
+
+        dst[0] = predictor;
+        for (uint32_t i = 1; i < blockCnt; i++)
+        {
+            uint8_t data = src[4 + (i - 1) / 2];
+            dst[i] = smplCodec_AdpcmStep(((i - 1) & 1) ? (data >> 4) : (data & 0x0F), &predictor, &index);
+        }
+
+        src += SMPL_ADPCM_BLOCK_BYTES;
+        dst += blockCnt;
+        cnt -= blockCnt;
+    }
+}
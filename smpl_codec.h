@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file smpl_codec.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Compressed storage of streamed sample data, 8 bit mu-law and 4 bit IMA-ADPCM
+ * @n       Only the attack and loop data of the stream voices is compressed, the sample memory
+ * @n       of the sampler stays 16 bit. See smpl_codec.cpp
+ */
+
+
+#ifndef SMPL_CODEC_H_
+#define SMPL_CODEC_H_
+
+
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#define SMPL_ADPCM_BLOCK_SAMPLES    64 /*!< samples per block, the first one is stored in the header */
+#define SMPL_ADPCM_BLOCK_BYTES      36 /*!< 4 byte header and 63 nibbles */
+
+
+/*
+ * data types
+ */
+enum smpl_codec_e
+{
+    SMPL_CODEC_PCM, /*!< 16 bit, 2 bytes per sample */
+    SMPL_CODEC_ULAW, /*!< 8 bit mu-law, 1 byte per sample */
+    SMPL_CODEC_ADPCM, /*!< 4 bit IMA-ADPCM in blocks, 0.56 bytes per sample */
+};
+
+
+/*
+ * declarations
+ */
+extern const int16_t smplCodecULaw[256];
+
+uint32_t SmplCodec_Size(enum smpl_codec_e codec, uint32_t cnt);
+const char *SmplCodec_Name(enum smpl_codec_e codec);
+bool SmplCodec_FromName(const char *name, enum smpl_codec_e *codec);
+void SmplCodec_Encode(enum smpl_codec_e codec, const int16_t *src, uint32_t cnt, uint8_t *dst, uint8_t *adpcmIndex);
+void SmplCodec_DecodeULaw(const uint8_t *src, int16_t *dst, uint32_t cnt);
+void SmplCodec_DecodeAdpcm(const uint8_t *src, int16_t *dst, uint32_t cnt);
+
+
+/*
+ * inline functions
+ */
+static inline int16_t SmplCodec_ULaw(uint8_t value)
+{
+    return smplCodecULaw[value];
+}
+
+/*
+ * first sample of an ADPCM block, available without decoding the block
+ */
+static inline int16_t SmplCodec_AdpcmFirst(const uint8_t *block)
+{
+    return (int16_t)(block[0] | (block[1] << 8));
+}
+
+
+#endif /* SMPL_CODEC_H_ */
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file smpl_snapshot.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Snapshot of the loaded samples written as sample bank image
+ * @n       The library does not give access to its sample memory and sample table. All sample data
+ * @n       passes the sample transfer and all samples are added by SmplBank_ApplyRegion, so both are
+ * @n       recorded while the loaders are running and written into a sample bank image.
+ * @n       On the next boot the image is restored by SmplBank_Load in a single pass or mapped.
+ * @n       The sample data is written while it is loaded, the region table follows it
+ * @n       (SMPL_BANK_FLAG_REGIONS_LAST) and the header is written last. An interrupted or invalid
+ * @n       snapshot keeps an empty header and will be rejected by SmplBank_Load.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "smpl_snapshot.h"
+#include "smpl_bank.h"
+
+#include <ml_status.h>
+
+#ifdef ML_HOST_BUILD
+#include <stdio.h>
+#elif defined ESP32
+#include <FS.h>
+#include <SD_MMC.h>
+#include <LittleFS.h>
+#define SMPL_SNAPSHOT_FILE
+#elif defined ARDUINO_ARCH_RP2040
+#include <LittleFS.h>
+#define SMPL_SNAPSHOT_FILE
+#endif
+
+
+/*
+ * defines
+ */
+#define SNAPSHOT_REGION_BLOCK   64
+
+
+/*
+ * static variables
+ */
+#ifdef ML_HOST_BUILD
+static FILE *snapFile = NULL;
+#elif defined SMPL_SNAPSHOT_FILE
+static File snapFile;
+#endif
+
+static bool snapActive = false;
+static bool snapValid = false;
+static uint32_t snapPcmCnt = 0;
+static uint32_t snapTransferBase = 0; /*!< position of the current transfer within the snapshot */
+static uint32_t snapInstrument = 0;
+
+static struct smpl_region_s *snapRegions = NULL;
+static uint32_t snapRegionCnt = 0;
+static uint32_t snapRegionCap = 0;
+
+
+/*
+ * static function definitions
+ */
+static bool smplSnapshot_FileOpen(fs_id_t fs_id, const char *filename)
+{
+#ifdef ML_HOST_BUILD
+    snapFile = HostFs_OpenStream(fs_id, filename, "wb");
+    return snapFile != NULL;
+#elif defined ESP32
+    snapFile = (fs_id == FS_ID_SD_MMC) ? SD_MMC.open(filename, FILE_WRITE) : LittleFS.open(filename, FILE_WRITE);
+    return (bool)snapFile;
+#elif defined ARDUINO_ARCH_RP2040
+    (void)fs_id;
+    snapFile = LittleFS.open(filename, "w");
+    return (bool)snapFile;
+#else
+    (void)fs_id;
+    (void)filename;
+    Serial.printf("snapshot not supported on this platform\n");
+    return false;
+#endif
+}
+
+static bool smplSnapshot_FileWrite(const void *data, uint32_t len)
+{
+#ifdef ML_HOST_BUILD
+    return fwrite(data, 1, len, snapFile) == len;
+#elif defined SMPL_SNAPSHOT_FILE
+    return snapFile.write((const uint8_t *)data, len) == len;
+#else
+    (void)data;
+    (void)len;
+    return false;
+#endif
+}
+
+/*
+ * writes the header to the beginning of the file and closes it
+ */
+static bool smplSnapshot_FileClose(const struct smpl_bank_hdr_s *hdr)
+{
+    bool ret = false;
+#ifdef ML_HOST_BUILD
+    ret = (fseek(snapFile, 0, SEEK_SET) == 0) && smplSnapshot_FileWrite(hdr, sizeof(*hdr));
+    ret = (fclose(snapFile) == 0) && ret;
+    snapFile = NULL;
+#elif defined SMPL_SNAPSHOT_FILE
+    ret = snapFile.seek(0) && smplSnapshot_FileWrite(hdr, sizeof(*hdr));
+    snapFile.close();
+#else
+    (void)hdr;
+#endif
+    return ret;
+}
+
+static void smplSnapshot_Free(void)
+{
+    free(snapRegions);
+    snapRegions = NULL;
+    snapRegionCnt = 0;
+    snapRegionCap = 0;
+    snapActive = false;
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * starts recording the samples loaded until SmplSnapshot_Commit
+ * the sample memory should be empty, samples loaded before will not be part of the snapshot
+ */
+bool SmplSnapshot_Begin(fs_id_t fs_id, const char *filename)
+{
+    if (snapActive)
+    {
+        SmplSnapshot_Abort();
+    }
+
+    if (!smplSnapshot_FileOpen(fs_id, filename))
+    {
+        Serial.printf("Failed to create snapshot %s\n", filename);
+        return false;
+    }
+
+    /* placeholder, the header is written by SmplSnapshot_Commit */
+    struct smpl_bank_hdr_s hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    snapActive = true;
+    snapValid = smplSnapshot_FileWrite(&hdr, sizeof(hdr));
+    snapPcmCnt = 0;
+    snapTransferBase = 0;
+    snapInstrument = 0;
+
+    return snapValid;
+}
+
+/*
+ * writes the region table and the header, returns true if the snapshot can be restored
+ */
+bool SmplSnapshot_Commit(void)
+{
+    if (!snapActive)
+    {
+        return false;
+    }
+
+    struct smpl_bank_hdr_s hdr;
+    memset(&hdr, 0, sizeof(hdr));
+
+    if (snapValid && (snapPcmCnt & 1))
+    {
+        /* keeps the region table aligned to 4 bytes for mapping */
+        int16_t pad = 0;
+        snapValid = smplSnapshot_FileWrite(&pad, sizeof(pad));
+        snapPcmCnt++;
+    }
+    if (snapValid)
+    {
+        snapValid = smplSnapshot_FileWrite(snapRegions, snapRegionCnt * sizeof(struct smpl_region_s));
+    }
+    if (snapValid)
+    {
+        hdr.magic = SMPL_BANK_MAGIC;
+        hdr.version = SMPL_BANK_VERSION;
+        hdr.regionSize = sizeof(struct smpl_region_s);
+        hdr.regionCnt = snapRegionCnt;
+        hdr.instrumentCnt = snapInstrument;
+        hdr.pcmCnt = snapPcmCnt;
+        hdr.flags = SMPL_BANK_FLAG_REGIONS_LAST;
+    }
+
+    bool ret = smplSnapshot_FileClose(&hdr) && snapValid;
+    if (ret)
+    {
+        Serial.printf("snapshot: %" PRIu32 " instruments, %" PRIu32 " regions, %" PRIu32 " kB\n",
+                      snapInstrument, snapRegionCnt, (snapPcmCnt * 2) / 1024);
+    }
+    smplSnapshot_Free();
+
+    return ret;
+}
+
+/*
+ * stops recording, the file keeps the empty header
+ */
+void SmplSnapshot_Abort(void)
+{
+    if (snapActive)
+    {
+        struct smpl_bank_hdr_s hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        smplSnapshot_FileClose(&hdr);
+        smplSnapshot_Free();
+    }
+}
+
+bool SmplSnapshot_IsActive(void)
+{
+    return snapActive;
+}
+
+/*
+ * restores the snapshot if available, otherwise the loader will be called and its result stored
+ */
+bool SmplSnapshot_LoadOrCreate(fs_id_t fs_id, const char *filename, void (*loader)(void))
+{
+    if (SmplBank_Load(fs_id, filename))
+    {
+        return true;
+    }
+
+    Serial.printf("creating snapshot %s\n", filename);
+    bool recording = SmplSnapshot_Begin(fs_id, filename);
+    loader();
+    if (recording && SmplSnapshot_Commit())
+    {
+        Status_ValueChangedStr("Snapshot", "Stored", filename);
+    }
+    else
+    {
+        Status_ValueChangedStr("Snapshot", "Not stored", filename);
+    }
+
+    return false;
+}
+
+void SmplSnapshot_TransferStart(void)
+{
+    snapTransferBase = snapPcmCnt;
+}
+
+void SmplSnapshot_Samples(const Q1_14 *samples, uint32_t cnt)
+{
+    if (snapActive && snapValid)
+    {
+        snapValid = smplSnapshot_FileWrite(samples, cnt * sizeof(Q1_14));
+        if (!snapValid)
+        {
+            Serial.printf("snapshot: write failed\n");
+        }
+    }
+    snapPcmCnt += cnt;
+}
+
+/*
+ * records a sample, its positions are relative to the start of the last transfer
+ */
+void SmplSnapshot_Region(const struct smpl_region_s *region)
+{
+    if (!snapActive || !snapValid)
+    {
+        return;
+    }
+
+    if (snapInstrument > 0xFF)
+    {
+        SmplSnapshot_Invalidate("too many instruments");
+        return;
+    }
+
+    if (snapRegionCnt == snapRegionCap)
+    {
+        uint32_t cap = snapRegionCap + SNAPSHOT_REGION_BLOCK;
+        struct smpl_region_s *regions = (struct smpl_region_s *)realloc(snapRegions, cap * sizeof(struct smpl_region_s));
+        if (regions == NULL)
+        {
+            SmplSnapshot_Invalidate("out of memory");
+            return;
+        }
+        snapRegions = regions;
+        snapRegionCap = cap;
+    }
+
+    struct smpl_region_s *entry = &snapRegions[snapRegionCnt++];
+    *entry = *region;
+    entry->start += snapTransferBase;
+    entry->end += snapTransferBase;
+    entry->loopStart += snapTransferBase;
+    entry->loopEnd += snapTransferBase;
+    entry->instrument = snapInstrument;
+}
+
+void SmplSnapshot_InstrumentDone(void)
+{
+    snapInstrument++;
+}
+
+/*
+ * called when samples are added which cannot be recorded
+ */
+void SmplSnapshot_Invalidate(const char *reason)
+{
+    if (snapActive && snapValid)
+    {
+        Serial.printf("snapshot not possible: %s\n", reason);
+        snapValid = false;
+    }
+}
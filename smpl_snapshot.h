@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file smpl_snapshot.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Snapshot of the loaded samples written as sample bank image
+ * @n       See smpl_snapshot.cpp
+ */
+
+
+#ifndef SMPL_SNAPSHOT_H_
+#define SMPL_SNAPSHOT_H_
+
+
+/*
+ * includes
+ */
+#include "fs/fs_access.h"
+#include "smpl_bank.h"
+
+#include <ml_types.h>
+#include <stdint.h>
+
+
+/*
+ * declarations
+ */
+bool SmplSnapshot_Begin(fs_id_t fs_id, const char *filename);
+bool SmplSnapshot_Commit(void);
+void SmplSnapshot_Abort(void);
+bool SmplSnapshot_IsActive(void);
+bool SmplSnapshot_LoadOrCreate(fs_id_t fs_id, const char *filename, void (*loader)(void));
+
+/* called by the sample transfer and the sample bank */
+void SmplSnapshot_TransferStart(void);
+void SmplSnapshot_Samples(const Q1_14 *samples, uint32_t cnt);
+void SmplSnapshot_Region(const struct smpl_region_s *region);
+void SmplSnapshot_InstrumentDone(void);
+void SmplSnapshot_Invalidate(const char *reason);
+
+
+#endif /* SMPL_SNAPSHOT_H_ */
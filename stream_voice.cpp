@@ -0,0 +1,749 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file stream_voice.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Voices streaming long samples from the file system
+ * @n       Only the attack and a short loop region of each sample are kept in memory, the remaining
+ * @n       data is read into a ring buffer per voice by StreamVoice_Refill running on the second core.
+ * @n       The sampler of the library can only play from its own memory, so notes of streamed samples
+ * @n       are played by the simple voices of this module (linear interpolation, release fade).
+ * @n       The attack gives the refill STREAM_ATTACK_MS time to fill the ring of a new voice.
+ * @n       Samples are read from their own file handle, the loaders can be used at the same time.
+ * @n       The attack and the loop can be kept compressed (mu-law or IMA-ADPCM, see smpl_codec.cpp),
+ * @n       the codec is selected per sample when it is added ("stream codec <pcm|ulaw|adpcm>").
+ * @n       ADPCM is decoded per voice into a buffer holding one block.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "stream_voice.h"
+#include "smpl_codec.h"
+#include "load_job.h"
+
+
+#ifdef STREAM_VOICE_ACTIVE
+
+
+#ifdef ML_HOST_BUILD
+#include <stdio.h>
+#else
+#include <FS.h>
+#include <SD_MMC.h>
+#include <LittleFS.h>
+#endif
+
+
+/*
+ * defines
+ */
+#define STREAM_VOICE_CNT        8
+#define STREAM_SAMPLE_CNT       64
+#define STREAM_RING_SIZE        8192 /*!< samples per voice, must be a power of 2 */
+#define STREAM_RING_MASK        (STREAM_RING_SIZE - 1)
+#define STREAM_ATTACK_MS        250 /*!< beginning of each sample kept in memory */
+#define STREAM_LOOP_MAX         (1024 * 32) /*!< loops up to this length are kept in memory */
+#define STREAM_REFILL_MAX       2048 /*!< samples read per voice and call of StreamVoice_Refill */
+#define STREAM_RELEASE_SAMPLES  (SAMPLE_RATE / 5)
+#define STREAM_FILL_RESIDENT    0xFFFFFFFF /*!< all remaining data of the voice is in memory */
+#define STREAM_ENCODE_CNT       1024 /*!< samples read per step while encoding, must be a multiple of SMPL_ADPCM_BLOCK_SAMPLES */
+
+
+/*
+ * data types
+ */
+struct stream_sample_s
+{
+    uint32_t fileOffset; /*!< position of the first sample in the file */
+    uint32_t len;
+    uint32_t loopStart;
+    uint32_t loopEnd; /*!< 0 if the sample is not looped */
+    uint8_t *attack;
+    uint32_t attackLen;
+    uint8_t *loop; /*!< loop region, NULL if streamed */
+    float pitch; /*!< playback speed at the root key */
+    uint8_t codec; /*!< storage of attack and loop, see enum smpl_codec_e */
+    uint8_t rootKey;
+    uint8_t keyLow;
+    uint8_t keyHigh;
+};
+
+enum stream_voice_state_e
+{
+    STREAM_VOICE_FREE,
+    STREAM_VOICE_PLAYING,
+    STREAM_VOICE_RELEASED,
+};
+
+struct stream_voice_s
+{
+    uint8_t state;
+    uint8_t ch;
+    uint8_t note;
+    const struct stream_sample_s *smpl;
+    uint32_t pos; /*!< position in the played sample data, the loop is unrolled */
+    uint32_t frac; /*!< 16 bit fraction of pos */
+    uint32_t step; /*!< 16.16 increment of pos per output sample */
+    int32_t gain; /*!< velocity, 1.15 */
+    int32_t env; /*!< release envelope, 1.15 */
+    uint32_t startCnt; /*!< note on counter for stealing the oldest voice */
+    int16_t *ring;
+    uint32_t fillPos; /*!< first position not yet read into the ring, written by the refill */
+    uint32_t gen; /*!< incremented by each note on to drop refills of the previous note */
+    const uint8_t *block; /*!< ADPCM block decoded into blockPcm, used by the audio core only */
+    int16_t blockPcm[SMPL_ADPCM_BLOCK_SAMPLES];
+};
+
+
+/*
+ * static function declarations
+ */
+static void *streamVoice_Alloc(uint32_t size);
+static bool streamVoice_FileOpen(fs_id_t fs_id, const char *filename);
+static void streamVoice_FileClose(void);
+static uint32_t streamVoice_FileRead(uint32_t pos, int16_t *dst, uint32_t cnt);
+static inline uint32_t streamVoice_Index(const struct stream_sample_s *smpl, uint32_t pos);
+static inline bool streamVoice_Resident(const struct stream_sample_s *smpl, uint32_t idx);
+static uint8_t *streamVoice_LoadResident(uint32_t pos, uint32_t cnt, enum smpl_codec_e codec);
+static inline int32_t streamVoice_Decode(struct stream_voice_s *voice, const uint8_t *data, uint32_t idx);
+static inline bool streamVoice_Get(struct stream_voice_s *voice, uint32_t pos, uint32_t fill, int32_t *value);
+static void streamVoice_RefillVoice(struct stream_voice_s *voice);
+static void streamVoice_StopRefill(void);
+static void streamVoice_StopVoices(void);
+static void streamVoice_StartRefill(void);
+
+
+/*
+ * static variables
+ */
+static struct stream_sample_s streamSamples[STREAM_SAMPLE_CNT];
+static uint32_t streamSampleCnt = 0;
+static struct stream_voice_s streamVoices[STREAM_VOICE_CNT];
+static uint32_t streamStartCnt = 0;
+static bool streamOpen = false; /*!< the refill may use the file and the samples */
+static bool streamRefillBusy = false; /*!< set by the refill while it uses the file and the samples */
+
+static uint32_t streamResidentBytes = 0;
+static uint32_t streamResidentPcmBytes = 0; /*!< size of the resident data without compression */
+static enum smpl_codec_e streamCodec = SMPL_CODEC_PCM; /*!< used for the samples added next */
+static uint32_t streamBlockDecodeCnt = 0;
+static volatile uint32_t streamUnderrunCnt = 0;
+static volatile uint32_t streamReadBytes = 0;
+static volatile uint32_t streamReadErrCnt = 0;
+
+#ifdef ML_HOST_BUILD
+static FILE *streamFile = NULL;
+#else
+static File streamFile;
+#endif
+
+
+/*
+ * static function definitions
+ */
+static void *streamVoice_Alloc(uint32_t size)
+{
+#ifdef BOARD_HAS_PSRAM
+    return ps_malloc(size);
+#else
+    return malloc(size);
+#endif
+}
+
+static bool streamVoice_FileOpen(fs_id_t fs_id, const char *filename)
+{
+#ifdef ML_HOST_BUILD
+    streamFile = HostFs_OpenStream(fs_id, filename, "rb");
+    return streamFile != NULL;
+#else
+    streamFile = (fs_id == FS_ID_SD_MMC) ? SD_MMC.open(filename) : LittleFS.open(filename);
+    return (bool)streamFile;
+#endif
+}
+
+static void streamVoice_FileClose(void)
+{
+#ifdef ML_HOST_BUILD
+    if (streamFile != NULL)
+    {
+        fclose(streamFile);
+        streamFile = NULL;
+    }
+#else
+    streamFile.close();
+#endif
+}
+
+/*
+ * reads cnt 16 bit samples starting at the byte position pos, returns the samples read
+ */
+static uint32_t streamVoice_FileRead(uint32_t pos, int16_t *dst, uint32_t cnt)
+{
+#ifdef ML_HOST_BUILD
+    fseek(streamFile, pos, SEEK_SET);
+    uint32_t read = fread(dst, 1, cnt * 2, streamFile);
+#else
+    streamFile.seek(pos);
+    uint32_t read = streamFile.read((uint8_t *)dst, cnt * 2);
+#endif
+    streamReadBytes += read;
+    return read / 2;
+}
+
+/*
+ * reads cnt samples starting at the byte position pos into memory, stored using the codec
+ */
+static uint8_t *streamVoice_LoadResident(uint32_t pos, uint32_t cnt, enum smpl_codec_e codec)
+{
+    uint8_t *data = (uint8_t *)streamVoice_Alloc(SmplCodec_Size(codec, cnt + 1));
+    if ((data == NULL) || (codec == SMPL_CODEC_PCM))
+    {
+        if (data != NULL)
+        {
+            streamVoice_FileRead(pos, (int16_t *)data, cnt);
+        }
+        return data;
+    }
+
+    int16_t *buffer = (int16_t *)malloc(STREAM_ENCODE_CNT * sizeof(int16_t));
+    if (buffer == NULL)
+    {
+        free(data);
+        return NULL;
+    }
+
+    uint8_t adpcmIndex = 0;
+    for (uint32_t i = 0; i < cnt; i += STREAM_ENCODE_CNT)
+    {
+        uint32_t partCnt = (cnt - i > STREAM_ENCODE_CNT) ? STREAM_ENCODE_CNT : (cnt - i);
+        uint32_t read = streamVoice_FileRead(pos + i * 2, buffer, partCnt);
+        if (read < partCnt)
+        {
+            /* will be played as silence */
+            memset(&buffer[read], 0, (partCnt - read) * sizeof(int16_t));
+        }
+        SmplCodec_Encode(codec, buffer, partCnt, &data[SmplCodec_Size(codec, i)], &adpcmIndex);
+    }
+
+    free(buffer);
+    return data;
+}
+
+/*
+ * converts the position of a voice to the index within the sample
+ */
+static inline uint32_t streamVoice_Index(const struct stream_sample_s *smpl, uint32_t pos)
+{
+    if ((smpl->loopEnd > 0) && (pos >= smpl->loopEnd))
+    {
+        return smpl->loopStart + (pos - smpl->loopEnd) % (smpl->loopEnd - smpl->loopStart);
+    }
+    return pos;
+}
+
+static inline bool streamVoice_Resident(const struct stream_sample_s *smpl, uint32_t idx)
+{
+    return (idx < smpl->attackLen) || ((smpl->loop != NULL) && (idx >= smpl->loopStart));
+}
+
+/*
+ * returns a sample of the attack or the loop
+ * the first sample of an ADPCM block is read from its header, so the interpolation at the end of a block
+ * does not replace the decoded block
+ */
+static inline int32_t streamVoice_Decode(struct stream_voice_s *voice, const uint8_t *data, uint32_t idx)
+{
+    switch (voice->smpl->codec)
+    {
+    case SMPL_CODEC_ULAW:
+        return SmplCodec_ULaw(data[idx]);
+
+    case SMPL_CODEC_ADPCM:
+    {
+        const uint8_t *block = &data[(idx / SMPL_ADPCM_BLOCK_SAMPLES) * SMPL_ADPCM_BLOCK_BYTES];
+        uint32_t blockIdx = idx % SMPL_ADPCM_BLOCK_SAMPLES;
+        if (blockIdx == 0)
+        {
+            return SmplCodec_AdpcmFirst(block);
+        }
+        if (voice->block != block)
+        {
+            SmplCodec_DecodeAdpcm(block, voice->blockPcm, SMPL_ADPCM_BLOCK_SAMPLES);
+            voice->block = block;
+            streamBlockDecodeCnt++;
+        }
+        return voice->blockPcm[blockIdx];
+    }
+
+    default:
+        return ((const int16_t *)data)[idx];
+    }
+}
+
+static inline bool streamVoice_Get(struct stream_voice_s *voice, uint32_t pos, uint32_t fill, int32_t *value)
+{
+    const struct stream_sample_s *smpl = voice->smpl;
+    uint32_t idx = streamVoice_Index(smpl, pos);
+
+    if (idx < smpl->attackLen)
+    {
+        *value = streamVoice_Decode(voice, smpl->attack, idx);
+    }
+    else if ((smpl->loop != NULL) && (idx >= smpl->loopStart))
+    {
+        *value = streamVoice_Decode(voice, smpl->loop, idx - smpl->loopStart);
+    }
+    else if (pos < fill)
+    {
+        *value = voice->ring[pos & STREAM_RING_MASK];
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/*
+ * reads the data following the fill position into the ring until it is full
+ */
+static void streamVoice_RefillVoice(struct stream_voice_s *voice)
+{
+    uint32_t gen = __atomic_load_n(&voice->gen, __ATOMIC_ACQUIRE);
+
+    if (__atomic_load_n(&voice->state, __ATOMIC_ACQUIRE) == STREAM_VOICE_FREE)
+    {
+        return;
+    }
+
+    const struct stream_sample_s *smpl = voice->smpl;
+    uint32_t fill = voice->fillPos;
+    uint32_t limit = __atomic_load_n(&voice->pos, __ATOMIC_RELAXED) + STREAM_RING_SIZE;
+    uint32_t budget = STREAM_REFILL_MAX;
+
+    while ((fill < limit) && (budget > 0))
+    {
+        uint32_t idx = streamVoice_Index(smpl, fill);
+
+        if ((smpl->loopEnd == 0) && (idx >= smpl->len))
+        {
+            break;
+        }
+        if ((smpl->loop != NULL) && (idx >= smpl->loopStart))
+        {
+            /* the voice will only play from memory now */
+            fill = STREAM_FILL_RESIDENT;
+            break;
+        }
+
+        uint32_t end = (smpl->loopEnd > 0) ? smpl->loopEnd : smpl->len;
+        uint32_t run = end - idx;
+        run = (run < limit - fill) ? run : (limit - fill);
+        run = (run < budget) ? run : budget;
+        run = (run < STREAM_RING_SIZE - (fill & STREAM_RING_MASK)) ? run : (STREAM_RING_SIZE - (fill & STREAM_RING_MASK));
+
+        uint32_t read = streamVoice_FileRead(smpl->fileOffset + idx * 2, &voice->ring[fill & STREAM_RING_MASK], run);
+        fill += read;
+        budget -= read;
+        if (read < run)
+        {
+            streamReadErrCnt++;
+            break;
+        }
+    }
+
+    /* the voice may have been retriggered in the meantime */
+    if (__atomic_load_n(&voice->gen, __ATOMIC_ACQUIRE) == gen)
+    {
+        __atomic_store_n(&voice->fillPos, fill, __ATOMIC_RELEASE);
+    }
+}
+
+/*
+ * the refill will not use the file and the samples anymore when this returns
+ * the refill sets its busy flag before checking streamOpen, so one of both sees the other
+ */
+static void streamVoice_StopRefill(void)
+{
+    __atomic_store_n(&streamOpen, false, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&streamRefillBusy, __ATOMIC_SEQ_CST))
+    {
+        /* the refill of the other core completes its current call */
+    }
+}
+
+static void streamVoice_StartRefill(void)
+{
+    __atomic_store_n(&streamOpen, true, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * executed by the audio core between two blocks (see LoadJob_Sync), no render uses the samples afterwards
+ * new notes will not find a streamed sample anymore
+ */
+static void streamVoice_StopVoices(void)
+{
+    for (uint32_t i = 0; i < STREAM_VOICE_CNT; i++)
+    {
+        __atomic_store_n(&streamVoices[i].state, STREAM_VOICE_FREE, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&streamSampleCnt, 0, __ATOMIC_RELEASE);
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * selects the file containing the streamed samples and removes all previously added samples
+ */
+bool StreamVoice_Open(fs_id_t fs_id, const char *filename)
+{
+    StreamVoice_Close();
+
+    if (!streamVoice_FileOpen(fs_id, filename))
+    {
+        Serial.printf("stream: failed to open %s\n", filename);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < STREAM_VOICE_CNT; i++)
+    {
+        if (streamVoices[i].ring == NULL)
+        {
+            streamVoices[i].ring = (int16_t *)streamVoice_Alloc(STREAM_RING_SIZE * sizeof(int16_t));
+            if (streamVoices[i].ring == NULL)
+            {
+                Serial.printf("stream: not enough memory for the voices\n");
+                streamVoice_FileClose();
+                return false;
+            }
+        }
+    }
+
+    streamVoice_StartRefill();
+    return true;
+}
+
+/*
+ * removes all streamed samples, the playing streamed notes are stopped
+ */
+void StreamVoice_Close(void)
+{
+    uint32_t sampleCnt = streamSampleCnt;
+
+    /* a render in progress may still read the samples, the audio core stops the voices itself */
+    LoadJob_Sync(streamVoice_StopVoices);
+    streamVoice_StopRefill();
+
+    for (uint32_t i = 0; i < sampleCnt; i++)
+    {
+        free(streamSamples[i].attack);
+        free(streamSamples[i].loop);
+    }
+    streamResidentBytes = 0;
+    streamResidentPcmBytes = 0;
+
+    streamVoice_FileClose();
+}
+
+/*
+ * adds a mono 16 bit sample of the opened file, positions are given in samples relative to fileOffset
+ * loopEnd of 0 disables the loop
+ */
+bool StreamVoice_AddSample(uint32_t fileOffset, uint32_t len, uint32_t loopStart, uint32_t loopEnd, uint8_t rootKey, uint32_t sampleRate, int16_t tune, uint8_t keyLow, uint8_t keyHigh)
+{
+    if (!streamOpen || (streamSampleCnt >= STREAM_SAMPLE_CNT) || (len < 2))
+    {
+        return false;
+    }
+
+    struct stream_sample_s *smpl = &streamSamples[streamSampleCnt];
+    memset(smpl, 0, sizeof(*smpl));
+
+    smpl->fileOffset = fileOffset;
+    smpl->len = len;
+    if ((loopEnd > loopStart) && (loopEnd <= len))
+    {
+        smpl->loopStart = loopStart;
+        smpl->loopEnd = loopEnd;
+    }
+    smpl->rootKey = rootKey;
+    smpl->keyLow = keyLow;
+    smpl->keyHigh = keyHigh;
+    smpl->pitch = ((float)sampleRate / (float)SAMPLE_RATE) * powf(2.0f, tune / 1200.0f);
+
+    smpl->attackLen = (sampleRate * STREAM_ATTACK_MS) / 1000;
+    if (smpl->attackLen > len)
+    {
+        smpl->attackLen = len;
+    }
+    if ((smpl->loopEnd > 0) && (smpl->attackLen > smpl->loopStart))
+    {
+        /* the loop starts within the attack, so the complete loop must be kept in memory */
+        smpl->attackLen = smpl->loopStart;
+    }
+
+    /* the refill of the running voices shares the file */
+    streamVoice_StopRefill();
+
+    smpl->codec = streamCodec;
+    smpl->attack = streamVoice_LoadResident(fileOffset, smpl->attackLen, streamCodec);
+    if (smpl->attack == NULL)
+    {
+        streamVoice_StartRefill();
+        Serial.printf("stream: not enough memory for the attack\n");
+        return false;
+    }
+    streamResidentBytes += SmplCodec_Size(streamCodec, smpl->attackLen);
+    streamResidentPcmBytes += smpl->attackLen * sizeof(int16_t);
+
+    uint32_t loopLen = smpl->loopEnd - smpl->loopStart;
+    if ((smpl->loopEnd > 0) && ((loopLen <= STREAM_LOOP_MAX) || (smpl->loopStart <= smpl->attackLen)))
+    {
+        smpl->loop = streamVoice_LoadResident(fileOffset + smpl->loopStart * 2, loopLen, streamCodec);
+        if (smpl->loop == NULL)
+        {
+            streamVoice_StartRefill();
+            Serial.printf("stream: not enough memory for the loop\n");
+            free(smpl->attack);
+            return false;
+        }
+        streamResidentBytes += SmplCodec_Size(streamCodec, loopLen);
+        streamResidentPcmBytes += loopLen * sizeof(int16_t);
+    }
+
+    /* the note on of the audio core sees the sample only when it is complete */
+    __atomic_store_n(&streamSampleCnt, streamSampleCnt + 1, __ATOMIC_RELEASE);
+    streamVoice_StartRefill();
+    return true;
+}
+
+/*
+ * starts a voice if a streamed sample is assigned to the note, otherwise false will be returned
+ */
+bool StreamVoice_NoteOn(uint8_t ch, uint8_t note, uint8_t vel)
+{
+    const struct stream_sample_s *smpl = NULL;
+    uint32_t sampleCnt = __atomic_load_n(&streamSampleCnt, __ATOMIC_ACQUIRE);
+
+    for (uint32_t i = 0; i < sampleCnt; i++)
+    {
+        if ((note >= streamSamples[i].keyLow) && (note <= streamSamples[i].keyHigh))
+        {
+            smpl = &streamSamples[i];
+            break;
+        }
+    }
+
+    if (smpl == NULL)
+    {
+        return false;
+    }
+
+    /* a free voice, otherwise the quietest released or the oldest playing voice */
+    struct stream_voice_s *voice = NULL;
+    for (uint32_t i = 0; i < STREAM_VOICE_CNT; i++)
+    {
+        struct stream_voice_s *v = &streamVoices[i];
+        if (v->state == STREAM_VOICE_FREE)
+        {
+            voice = v;
+            break;
+        }
+        if ((voice == NULL)
+            || ((v->state == STREAM_VOICE_RELEASED) && ((voice->state != STREAM_VOICE_RELEASED) || (v->env < voice->env)))
+            || ((v->state == voice->state) && (v->state == STREAM_VOICE_PLAYING) && (v->startCnt < voice->startCnt)))
+        {
+            voice = v;
+        }
+    }
+
+    voice->smpl = smpl;
+    voice->ch = ch;
+    voice->note = note;
+    voice->pos = 0;
+    voice->frac = 0;
+    voice->step = (uint32_t)(smpl->pitch * powf(2.0f, ((int32_t)note - smpl->rootKey) / 12.0f) * 65536.0f);
+    voice->gain = vel * 258;
+    voice->env = 32767;
+    voice->startCnt = streamStartCnt++;
+    voice->block = NULL;
+    __atomic_store_n(&voice->fillPos, smpl->attackLen, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&voice->gen, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&voice->state, STREAM_VOICE_PLAYING, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+void StreamVoice_NoteOff(uint8_t ch, uint8_t note)
+{
+    for (uint32_t i = 0; i < STREAM_VOICE_CNT; i++)
+    {
+        struct stream_voice_s *voice = &streamVoices[i];
+        if ((voice->state == STREAM_VOICE_PLAYING) && (voice->ch == ch) && (voice->note == note))
+        {
+            voice->state = STREAM_VOICE_RELEASED;
+        }
+    }
+}
+
+/*
+ * adds the output of the stream voices to the buffers
+ */
+void StreamVoice_Process(Q1_14 *left, Q1_14 *right, uint32_t len)
+{
+    for (uint32_t i = 0; i < STREAM_VOICE_CNT; i++)
+    {
+        struct stream_voice_s *voice = &streamVoices[i];
+
+        if (voice->state == STREAM_VOICE_FREE)
+        {
+            continue;
+        }
+
+        const struct stream_sample_s *smpl = voice->smpl;
+        uint32_t fill = __atomic_load_n(&voice->fillPos, __ATOMIC_ACQUIRE);
+
+        for (uint32_t n = 0; n < len; n++)
+        {
+            if ((smpl->loopEnd == 0) && (voice->pos + 1 >= smpl->len))
+            {
+                voice->state = STREAM_VOICE_FREE;
+                break;
+            }
+
+            int32_t a, b;
+            if (!streamVoice_Get(voice, voice->pos, fill, &a) || !streamVoice_Get(voice, voice->pos + 1, fill, &b))
+            {
+                /* the voice continues when the data has arrived */
+                streamUnderrunCnt++;
+                break;
+            }
+
+            int32_t value = a + (((b - a) * (int32_t)voice->frac) >> 16);
+            value = (value * voice->gain) >> 15;
+            value = (value * voice->env) >> 15;
+
+            int32_t l = left[n].s16 + value;
+            int32_t r = right[n].s16 + value;
+            left[n].s16 = (l > INT16_MAX) ? INT16_MAX : ((l < INT16_MIN) ? INT16_MIN : l);
+            right[n].s16 = (r > INT16_MAX) ? INT16_MAX : ((r < INT16_MIN) ? INT16_MIN : r);
+
+            voice->frac += voice->step;
+            __atomic_store_n(&voice->pos, voice->pos + (voice->frac >> 16), __ATOMIC_RELAXED);
+            voice->frac &= 0xFFFF;
+
+            if (voice->state == STREAM_VOICE_RELEASED)
+            {
+                voice->env -= 32767 / STREAM_RELEASE_SAMPLES + 1;
+                if (voice->env <= 0)
+                {
+                    voice->state = STREAM_VOICE_FREE;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * to be called from the second core, reads the data of the playing voices
+ */
+void StreamVoice_Refill(void)
+{
+    __atomic_store_n(&streamRefillBusy, true, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&streamOpen, __ATOMIC_SEQ_CST))
+    {
+        for (uint32_t i = 0; i < STREAM_VOICE_CNT; i++)
+        {
+            streamVoice_RefillVoice(&streamVoices[i]);
+        }
+    }
+
+    __atomic_store_n(&streamRefillBusy, false, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * serial command: "stream" prints the state of the stream voices, "stream reset" clears the counters
+ * "stream codec <pcm|ulaw|adpcm>" selects the storage of the samples added next
+ */
+void StreamVoice_Cmd(const char *args)
+{
+    if (strcmp(args, "reset") == 0)
+    {
+        streamUnderrunCnt = 0;
+        streamReadBytes = 0;
+        streamReadErrCnt = 0;
+        streamBlockDecodeCnt = 0;
+    }
+    else if (strncmp(args, "codec ", 6) == 0)
+    {
+        if (!SmplCodec_FromName(&args[6], &streamCodec))
+        {
+            Serial.printf("unknown codec: %s\n", &args[6]);
+        }
+    }
+
+    Serial.printf("stream: %" PRIu32 " samples, attack and loop %" PRIu32 " kB in memory (%" PRIu32 " kB as pcm), ring %" PRIu32 " kB per voice\n",
+                  streamSampleCnt, streamResidentBytes / 1024, streamResidentPcmBytes / 1024, (uint32_t)(STREAM_RING_SIZE * sizeof(int16_t) / 1024));
+    Serial.printf("codec of new streamed samples: %s (the sample memory stays pcm), ADPCM blocks decoded: %" PRIu32 "\n",
+                  SmplCodec_Name(streamCodec), streamBlockDecodeCnt);
+    Serial.printf("read: %" PRIu32 " kB, underruns: %" PRIu32 ", read errors: %" PRIu32 "\n",
+                  streamReadBytes / 1024, streamUnderrunCnt, streamReadErrCnt);
+
+    for (uint32_t i = 0; i < STREAM_VOICE_CNT; i++)
+    {
+        struct stream_voice_s *voice = &streamVoices[i];
+        if (voice->state != STREAM_VOICE_FREE)
+        {
+            uint32_t fill = voice->fillPos;
+            Serial.printf("  voice %" PRIu32 ": note %u, pos %" PRIu32 ", buffered %" PRIu32 "\n", i, voice->note, voice->pos,
+                          (fill == STREAM_FILL_RESIDENT) ? 0 : ((fill > voice->pos) ? (fill - voice->pos) : 0));
+        }
+    }
+}
+
+
+#endif /* STREAM_VOICE_ACTIVE */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file stream_voice.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the voices streaming long samples from the file system
+ */
+
+
+#ifndef STREAM_VOICE_H_
+#define STREAM_VOICE_H_
+
+
+/*
+ * includes
+ */
+#include "config.h"
+#include "fs/fs_access.h"
+
+#include <ml_types.h>
+#include <stdint.h>
+
+
+/*
+ * defines
+ */
+#if (defined SAMPLE_STREAMING_ENABLED) && ((defined ESP32) || (defined ML_HOST_BUILD))
+#define STREAM_VOICE_ACTIVE /*!< notes of streamed samples will be played by the stream voices */
+#endif
+
+
+/*
+ * declarations
+ */
+#ifdef STREAM_VOICE_ACTIVE
+bool StreamVoice_Open(fs_id_t fs_id, const char *filename);
+void StreamVoice_Close(void);
+bool StreamVoice_AddSample(uint32_t fileOffset, uint32_t len, uint32_t loopStart, uint32_t loopEnd, uint8_t rootKey, uint32_t sampleRate, int16_t tune, uint8_t keyLow, uint8_t keyHigh);
+bool StreamVoice_NoteOn(uint8_t ch, uint8_t note, uint8_t vel);
+void StreamVoice_NoteOff(uint8_t ch, uint8_t note);
+void StreamVoice_Process(Q1_14 *left, Q1_14 *right, uint32_t len);
+void StreamVoice_Refill(void);
+void StreamVoice_Cmd(const char *args);
+#endif
+
+
+#endif /* STREAM_VOICE_H_ */
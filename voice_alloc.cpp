@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file voice_alloc.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   CPU budget driven voice stealing
+ * @n       All notes sent to the sampler are tracked, the render cost per voice is learned from the
+ * @n       measured sampler time. When another voice would exceed the budget a voice will be stolen.
+ * @n       The sampler only allows to release a voice, so released voices are counted until their
+ * @n       release tail has passed (VOICE_ALLOC_RELEASE_MS) and only held voices can be stolen.
+ * @n       Stealing is best effort: the victim keeps sounding during its release and stays counted,
+ * @n       the prediction follows the voices which are actually rendered. A steal does not make room
+ * @n       for the new note, it only stops the victim from being held and ends it after the release.
+ * @n       The sampler does not report the envelope, the quietest voice is the one with the lowest
+ * @n       note-on velocity.
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "voice_alloc.h"
+#include "perf_mon.h"
+
+#include <ml_sampler.h>
+
+
+/*
+ * defines
+ */
+#define VOICE_ALLOC_CNT             32 /*!< voices which can be tracked */
+#define VOICE_ALLOC_RELEASE_MS      500 /*!< expected duration of the release */
+#define VOICE_ALLOC_LIMIT_PERCENT   90 /*!< render time in percent of the budget available for all voices */
+#define VOICE_ALLOC_RELEASE_SAMPLES (VOICE_ALLOC_RELEASE_MS * (SAMPLE_RATE / 1000))
+#define VOICE_ALLOC_EMA_SHIFT       4 /*!< learning rate of the cost estimation (1/16) */
+#define VOICE_ALLOC_EX_MIXED        0xFF /*!< the key has different exclusive classes in the loaded instruments */
+
+
+/*
+ * data types
+ */
+enum voice_state_e
+{
+    VOICE_STATE_FREE,
+    VOICE_STATE_HELD,
+    VOICE_STATE_RELEASED,
+};
+
+struct voice_s
+{
+    enum voice_state_e state;
+    uint8_t ch;
+    uint8_t note;
+    uint8_t vel;
+    uint8_t exClass;
+    uint32_t startTime;
+    uint32_t releaseTime;
+};
+
+
+/*
+ * static function declarations
+ */
+static struct voice_s *voiceAlloc_FindHeld(uint8_t ch, uint8_t note);
+static struct voice_s *voiceAlloc_FindVictim(void);
+static struct voice_s *voiceAlloc_GetFree(void);
+static void voiceAlloc_Release(struct voice_s *voice);
+static uint32_t voiceAlloc_Predict(uint32_t voiceCnt);
+
+
+/*
+ * static variables
+ */
+static struct voice_s voices[VOICE_ALLOC_CNT];
+static uint8_t voiceExClass[128]; /*!< exclusive class per key of the loaded samples */
+static bool voiceExUsed[128]; /*!< the key has been set by a loaded sample */
+static enum voice_alloc_policy_e voicePolicy = VOICE_ALLOC_POLICY_OLDEST;
+static uint32_t voiceTime = 0; /*!< samples rendered since startup */
+static uint32_t voiceActiveCnt = 0;
+static uint32_t voiceBudget = 0;
+
+/* learned costs in cycles, scaled by 1 << VOICE_ALLOC_EMA_SHIFT */
+static uint32_t voiceCostBase = 0;
+static uint32_t voiceCostPerVoice = 0;
+static uint32_t voiceCostOther = 0;
+
+static uint32_t voiceStealCnt = 0;
+static uint32_t voiceChokeCnt = 0;
+
+
+/*
+ * static function definitions
+ */
+static struct voice_s *voiceAlloc_FindHeld(uint8_t ch, uint8_t note)
+{
+    for (int i = 0; i < VOICE_ALLOC_CNT; i++)
+    {
+        if ((voices[i].state == VOICE_STATE_HELD) && (voices[i].ch == ch) && (voices[i].note == note))
+        {
+            return &voices[i];
+        }
+    }
+    return NULL;
+}
+
+static struct voice_s *voiceAlloc_FindVictim(void)
+{
+    struct voice_s *victim = NULL;
+
+    for (int i = 0; i < VOICE_ALLOC_CNT; i++)
+    {
+        struct voice_s *voice = &voices[i];
+        if (voice->state != VOICE_STATE_HELD)
+        {
+            continue;
+        }
+        if (victim == NULL)
+        {
+            victim = voice;
+        }
+        else if (voicePolicy == VOICE_ALLOC_POLICY_QUIETEST)
+        {
+            if ((voice->vel < victim->vel) || ((voice->vel == victim->vel) && (voice->startTime < victim->startTime)))
+            {
+                victim = voice;
+            }
+        }
+        else if (voice->startTime < victim->startTime)
+        {
+            victim = voice;
+        }
+    }
+
+    return victim;
+}
+
+/*
+ * returns a free entry, the oldest released voice will be dropped from tracking if required
+ */
+static struct voice_s *voiceAlloc_GetFree(void)
+{
+    struct voice_s *oldest = NULL;
+
+    for (int i = 0; i < VOICE_ALLOC_CNT; i++)
+    {
+        if (voices[i].state == VOICE_STATE_FREE)
+        {
+            return &voices[i];
+        }
+        if ((voices[i].state == VOICE_STATE_RELEASED) && ((oldest == NULL) || (voices[i].releaseTime < oldest->releaseTime)))
+        {
+            oldest = &voices[i];
+        }
+    }
+
+    if (oldest != NULL)
+    {
+        oldest->state = VOICE_STATE_FREE;
+        voiceActiveCnt--;
+    }
+    return oldest;
+}
+
+static void voiceAlloc_Release(struct voice_s *voice)
+{
+    voice->state = VOICE_STATE_RELEASED;
+    voice->releaseTime = voiceTime;
+    Sampler_NoteOff(voice->ch, voice->note);
+}
+
+/*
+ * estimated render time of the next block in cycles
+ */
+static uint32_t voiceAlloc_Predict(uint32_t voiceCnt)
+{
+    return (voiceCostOther + voiceCostBase + voiceCnt * voiceCostPerVoice) >> VOICE_ALLOC_EMA_SHIFT;
+}
+
+
+/*
+ * extern function definitions
+ */
+void VoiceAlloc_NoteOn(uint8_t ch, uint8_t note, uint8_t vel)
+{
+    /*
+     * the classes are not known per instrument, a key with different classes is not counted as cut
+     * the voices stay counted until their release has passed
+     */
+    uint8_t exClass = voiceExClass[note & 0x7F];
+    if (exClass == VOICE_ALLOC_EX_MIXED)
+    {
+        exClass = 0;
+    }
+
+    struct voice_s *retrigger = voiceAlloc_FindHeld(ch, note);
+    if (retrigger != NULL)
+    {
+        if (voicePolicy == VOICE_ALLOC_POLICY_SAME_NOTE)
+        {
+            voiceAlloc_Release(retrigger);
+        }
+        else
+        {
+            /* the sampler starts another voice, the previous one is not held anymore */
+            retrigger->state = VOICE_STATE_RELEASED;
+            retrigger->releaseTime = voiceTime;
+        }
+    }
+
+    if (exClass != 0)
+    {
+        /* the sampler cuts all voices of the same exclusive class */
+        for (int i = 0; i < VOICE_ALLOC_CNT; i++)
+        {
+            if ((voices[i].state != VOICE_STATE_FREE) && (voices[i].ch == ch) && (voices[i].exClass == exClass))
+            {
+                voices[i].state = VOICE_STATE_FREE;
+                voiceActiveCnt--;
+                voiceChokeCnt++;
+            }
+        }
+    }
+
+    if ((voiceBudget > 0) && (voiceAlloc_Predict(voiceActiveCnt + 1) > voiceBudget))
+    {
+        struct voice_s *victim = voiceAlloc_FindVictim();
+        if (victim != NULL)
+        {
+            /* still rendered during its release, counted until voiceAlloc_Process ends it */
+            voiceAlloc_Release(victim);
+            voiceStealCnt++;
+        }
+    }
+
+    struct voice_s *voice = voiceAlloc_GetFree();
+    if (voice != NULL)
+    {
+        voice->state = VOICE_STATE_HELD;
+        voice->ch = ch;
+        voice->note = note;
+        voice->vel = vel;
+        voice->exClass = exClass;
+        voice->startTime = voiceTime;
+        voiceActiveCnt++;
+    }
+
+    Sampler_NoteOn(ch, note, vel);
+}
+
+void VoiceAlloc_NoteOff(uint8_t ch, uint8_t note)
+{
+    struct voice_s *voice = voiceAlloc_FindHeld(ch, note);
+    if (voice != NULL)
+    {
+        voice->state = VOICE_STATE_RELEASED;
+        voice->releaseTime = voiceTime;
+    }
+
+    Sampler_NoteOff(ch, note);
+}
+
+void VoiceAlloc_AllNotesOff(void)
+{
+    for (int i = 0; i < VOICE_ALLOC_CNT; i++)
+    {
+        if (voices[i].state == VOICE_STATE_HELD)
+        {
+            voiceAlloc_Release(&voices[i]);
+        }
+    }
+}
+
+/*
+ * to be called once per block with the cycles measured for the sampler and the complete render and the block length
+ */
+void VoiceAlloc_Process(uint32_t sampler, uint32_t render, uint32_t budget, uint32_t len)
+{
+    voiceBudget = (((uint64_t)budget) * VOICE_ALLOC_LIMIT_PERCENT) / 100;
+
+    /* learn the cost of the voices rendered in this block */
+    uint32_t other = (render > sampler) ? (render - sampler) : 0;
+    voiceCostOther += other - (voiceCostOther >> VOICE_ALLOC_EMA_SHIFT);
+
+    if (voiceActiveCnt == 0)
+    {
+        voiceCostBase += sampler - (voiceCostBase >> VOICE_ALLOC_EMA_SHIFT);
+    }
+    else
+    {
+        uint32_t base = voiceCostBase >> VOICE_ALLOC_EMA_SHIFT;
+        uint32_t perVoice = (sampler > base) ? ((sampler - base) / voiceActiveCnt) : 0;
+        voiceCostPerVoice += perVoice - (voiceCostPerVoice >> VOICE_ALLOC_EMA_SHIFT);
+    }
+
+    voiceTime += len;
+
+    /* released voices end after their release tail */
+    for (int i = 0; i < VOICE_ALLOC_CNT; i++)
+    {
+        if ((voices[i].state == VOICE_STATE_RELEASED) && (voiceTime - voices[i].releaseTime > VOICE_ALLOC_RELEASE_SAMPLES))
+        {
+            voices[i].state = VOICE_STATE_FREE;
+            voiceActiveCnt--;
+        }
+    }
+}
+
+uint32_t VoiceAlloc_GetActiveCnt(void)
+{
+    return voiceActiveCnt;
+}
+
+/*
+ * samples rendered since startup, used as timestamp of the voices
+ */
+uint32_t VoiceAlloc_GetTime(void)
+{
+    return voiceTime;
+}
+
+/*
+ * number of voices started before time which are still held or in their release tail
+ */
+uint32_t VoiceAlloc_GetActiveCntBefore(uint32_t time)
+{
+    uint32_t cnt = 0;
+
+    for (int i = 0; i < VOICE_ALLOC_CNT; i++)
+    {
+        if ((voices[i].state != VOICE_STATE_FREE) && ((int32_t)(voices[i].startTime - time) < 0))
+        {
+            cnt++;
+        }
+    }
+    return cnt;
+}
+
+/*
+ * releases all held voices started before time
+ */
+void VoiceAlloc_ReleaseBefore(uint32_t time)
+{
+    for (int i = 0; i < VOICE_ALLOC_CNT; i++)
+    {
+        if ((voices[i].state == VOICE_STATE_HELD) && ((int32_t)(voices[i].startTime - time) < 0))
+        {
+            voiceAlloc_Release(&voices[i]);
+        }
+    }
+}
+
+void VoiceAlloc_SetPolicy(enum voice_alloc_policy_e policy)
+{
+    voicePolicy = policy;
+}
+
+/*
+ * should be called for each loaded sample, all voices of the same class will be cut by the sampler
+ * the sampler applies the classes per instrument, keys used with different classes will be ignored
+ */
+void VoiceAlloc_SetExclusiveClass(uint8_t keyLow, uint8_t keyHigh, uint8_t exClass)
+{
+    for (int key = keyLow; (key <= keyHigh) && (key < 128); key++)
+    {
+        if (!voiceExUsed[key])
+        {
+            voiceExClass[key] = exClass;
+            voiceExUsed[key] = true;
+        }
+        else if (voiceExClass[key] != exClass)
+        {
+            voiceExClass[key] = VOICE_ALLOC_EX_MIXED;
+        }
+    }
+}
+
+void VoiceAlloc_ClearExclusiveClasses(void)
+{
+    memset(voiceExClass, 0, sizeof(voiceExClass));
+    memset(voiceExUsed, 0, sizeof(voiceExUsed));
+}
+
+/*
+ * serial command: "voice" prints the state, "voice oldest|quietest|samenote" selects the policy
+ */
+void VoiceAlloc_Cmd(const char *args)
+{
+    static const char *policyNames[] = {"oldest", "quietest", "samenote"};
+
+    for (uint32_t i = 0; i < sizeof(policyNames) / sizeof(policyNames[0]); i++)
+    {
+        if (strcmp(args, policyNames[i]) == 0)
+        {
+            VoiceAlloc_SetPolicy((enum voice_alloc_policy_e)i);
+        }
+    }
+
+    uint32_t perVoice = voiceCostPerVoice >> VOICE_ALLOC_EMA_SHIFT;
+    uint32_t fixed = (voiceCostOther + voiceCostBase) >> VOICE_ALLOC_EMA_SHIFT;
+
+    Serial.printf("voice policy: %s, active voices: %" PRIu32 "\n", policyNames[voicePolicy], voiceActiveCnt);
+    Serial.printf("cost: %" PRIu32 " us fixed, %" PRIu32 " us per voice, limit %" PRIu32 " us\n",
+                  PerfMon_CyclesToUs(fixed), PerfMon_CyclesToUs(perVoice), PerfMon_CyclesToUs(voiceBudget));
+    if (perVoice > 0)
+    {
+        Serial.printf("voices within budget: %" PRIu32 "\n", (voiceBudget > fixed) ? ((voiceBudget - fixed) / perVoice) : 0);
+    }
+    Serial.printf("stolen: %" PRIu32 ", cut by exclusive class: %" PRIu32 "\n", voiceStealCnt, voiceChokeCnt);
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file voice_alloc.h
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Declarations of the CPU budget driven voice stealing
+ */
+
+
+#ifndef VOICE_ALLOC_H_
+#define VOICE_ALLOC_H_
+
+
+#include <stdint.h>
+
+
+/*
+ * data types
+ */
+enum voice_alloc_policy_e
+{
+    VOICE_ALLOC_POLICY_OLDEST, /*!< the oldest held voice will be stolen */
+    VOICE_ALLOC_POLICY_QUIETEST, /*!< the held voice with the lowest note-on velocity will be stolen */
+    VOICE_ALLOC_POLICY_SAME_NOTE, /*!< a retriggered note replaces its previous voice, otherwise like oldest */
+};
+
+
+/*
+ * declarations
+ */
+void VoiceAlloc_NoteOn(uint8_t ch, uint8_t note, uint8_t vel);
+void VoiceAlloc_NoteOff(uint8_t ch, uint8_t note);
+void VoiceAlloc_AllNotesOff(void);
+void VoiceAlloc_Process(uint32_t sampler, uint32_t render, uint32_t budget, uint32_t len);
+uint32_t VoiceAlloc_GetActiveCnt(void);
+uint32_t VoiceAlloc_GetTime(void);
+uint32_t VoiceAlloc_GetActiveCntBefore(uint32_t time);
+void VoiceAlloc_ReleaseBefore(uint32_t time);
+void VoiceAlloc_SetPolicy(enum voice_alloc_policy_e policy);
+void VoiceAlloc_SetExclusiveClass(uint8_t keyLow, uint8_t keyHigh, uint8_t exClass);
+void VoiceAlloc_ClearExclusiveClasses(void);
+void VoiceAlloc_Cmd(const char *args);
+
+
+#endif /* VOICE_ALLOC_H_ */
@@ -54,23 +54,16 @@
 #include "utils.h"
 #include "ml_wavfile.h"
 #include "wav_to_sampler.h"
-
-
-/*
- * data types
- */
-union wavSampleS16
-{
-    uint8_t data[256];
-    Q1_14 samples[128];
-};
+#include "sample_transfer.h"
+#include "smpl_bank.h"
+#include "load_step.h"
 
 
 /*
  * static function declarations
  */
 static void wavToSmpl_ReadWaveFile(const char *filename, uint8_t note);
-static bool wavToSmpl_WavData(union wavHeader *hdr, uint16_t bytesPerSample, uint32_t data_to_read, uint8_t note);
+static bool wavToSmpl_WavData(union wavHeader *hdr, uint16_t bytesPerSample, uint32_t data_to_read, uint8_t note, struct smpl_region_s *region);
 static void wavToSmpl_FolderToNotes_CB(const char *filename, int depth __attribute__((unused)), uint8_t note);
 static void wavToSmpl_FolderToSamples_CB(const char *filename, int depth __attribute__((unused)), uint8_t note);
 
@@ -82,6 +75,8 @@ static void wavToSmpl_FolderToNotes_CB(const char *filename, int depth __attribu
 {
     if (str_ends_with(filename, ".wav"))
     {
+        /* a folder is loaded at once, the audio keeps running between the files */
+        LoadStep_Yield();
         Serial.printf("Wavefile detected (note: %u)...\n", note);
         FS_UseTempFile();
         wavToSmpl_ReadWaveFile(filename, note);
@@ -93,6 +88,8 @@ static void wavToSmpl_FolderToSamples_CB(const char *filename, int depth __attri
 
     if (str_ends_with(filename, ".wav"))
     {
+        /* a folder is loaded at once, the audio keeps running between the files */
+        LoadStep_Yield();
         Serial.printf("Wavefile detected (note: %u)...\n", note);
         FS_UseTempFile();
         wavToSmpl_ReadWaveFile(filename, 255);
@@ -100,96 +97,62 @@ static void wavToSmpl_FolderToSamples_CB(const char *filename, int depth __attri
     //Sampler_InstrumentDone();
 }
 
-static bool wavToSmpl_WavData(union wavHeader *hdr, uint16_t bytesPerSample, uint32_t data_to_read, uint8_t note)
+/*
+ * transfers the sample data and fills the region used to add the sample
+ */
+static bool wavToSmpl_WavData(union wavHeader *hdr, uint16_t bytesPerSample, uint32_t data_to_read, uint8_t note, struct smpl_region_s *region)
 {
-    if (Sampler_NewSample())
-    {
-        Sampler_StartTransfer();
-        while (data_to_read >= (uint32_t)bytesPerSample)
-        {
-            wavSampleS16 sampleData;
-            uint32_t bytesRead = 0;
-            uint32_t nextBlock = data_to_read > sizeof(sampleData) ? sizeof(sampleData) : data_to_read;
-            uint32_t samplesInBlock = 0;
-
-#if 1
-            if (hdr->numberOfChannels == 2)
-            {
-                wavSampleS16 sampleDataTemp;
-
-                bytesRead = readBytes(sampleDataTemp.data, nextBlock);
-                if (bytesRead != nextBlock)
-                {
-                    /* error occurred */
-                    Serial.printf("readError %" PRIu32 "", bytesRead);
-                    return false;
-                }
-
-                samplesInBlock = bytesRead / 4;
-
-                for (uint32_t i = 0; i < samplesInBlock; i++)
-                {
-                    sampleData.samples[i] = sampleDataTemp.samples[2 * i];
-                }
-
-
-            }
-#endif
-            if (hdr->numberOfChannels == 1)
-            {
-                bytesRead = readBytes(sampleData.data, nextBlock);
-                if (bytesRead != nextBlock)
-                {
-                    /* error occurred */
-                    Serial.printf("readError %" PRIu32 "", bytesRead);
-                    return false;
-                }
-                samplesInBlock = bytesRead / (uint32_t)bytesPerSample;
-            }
-            // Serial.printf("%u, %u x %u\n", nextBlock, data_to_read, samplesInBlock);
-
-
-            if (bytesPerSample == 1)
-            {
-                if (Sampler_AddSamplesU8(sampleData.data, samplesInBlock) == false)
-                {
-                    Serial.printf("Failed to add %" PRIu32 " samples, %" PRIu32 " left\n", bytesRead, data_to_read);
-                    break;
-                }
-            }
-            else
-            {
-                if (Sampler_AddSamples(sampleData.samples, samplesInBlock) == false)
-                {
-                    Serial.printf("Failed to add %" PRIu32 " samples, %" PRIu32 " left\n", bytesRead, data_to_read);
-                    break;
-                }
-            }
-            data_to_read -= bytesRead;
-        }
-        Sampler_EndTransfer();
-
-        Sampler_NewSampleSetRange(0, hdr->nextTag.tag_data_size / (uint32_t)hdr->bytesPerSample - 1); /* expecting 16 bit */
+    enum sample_transfer_fmt_e fmt;
 
+    /* bytesPerSample is the block align of the header, the size of one frame of all channels */
+    if ((hdr->numberOfChannels == 2) && (bytesPerSample == 4))
+    {
+        fmt = SAMPLE_TRANSFER_S16_STEREO;
+    }
+    else if ((hdr->numberOfChannels == 1) && (bytesPerSample == 1))
+    {
+        fmt = SAMPLE_TRANSFER_U8;
+    }
+    else if ((hdr->numberOfChannels == 1) && (bytesPerSample == 2))
+    {
+        /* the data can be passed without conversion */
+        fmt = SAMPLE_TRANSFER_S16;
+    }
+    else
+    {
+        Serial.printf("format not supported: %" PRIu16 " channels, %" PRIu16 " bytes per sample\n", hdr->numberOfChannels, bytesPerSample);
+        return false;
+    }
 
-        if (note != 0xFF)
-        {
-            Sampler_SetKeyRange(note, note);
-            Sampler_SetPitch(note, hdr->sampleRate, 0);
-        }
-        else
-        {
-            Sampler_SetPitch(60, hdr->sampleRate, -82);
-        }
+    SampleTransfer_Start();
+    bool ret = SampleTransfer_ReadFmt(data_to_read, fmt);
+    SampleTransfer_End();
+    if (!ret)
+    {
+        return false;
+    }
 
-        return true;
+    memset(region, 0, sizeof(*region));
+    region->end = hdr->nextTag.tag_data_size / (uint32_t)hdr->bytesPerSample - 1; /* expecting 16 bit */
+    region->loopEnd = region->end;
+    region->sampleRate = hdr->sampleRate;
+    region->velHigh = 127;
 
+    if (note != 0xFF)
+    {
+        region->keyLow = note;
+        region->keyHigh = note;
+        region->rootKey = note;
+        region->flags = SMPL_REGION_FLAG_KEY_RANGE;
     }
     else
     {
-        Serial.printf("unable to add samples\n");
-        return false;
+        region->keyHigh = 127;
+        region->rootKey = 60;
+        region->tune = -82;
     }
+
+    return true;
 }
 
 static void wavToSmpl_ReadWaveFile(const char *filename, uint8_t note)
@@ -238,6 +201,7 @@ static void wavToSmpl_ReadWaveFile(const char *filename, uint8_t note)
     }
 
     bool wavAdded = false;
+    struct smpl_region_s region;
 
     if (memcmp(wavHdr.nextTag.tag_name, "data", 4) == 0)
     {
@@ -245,7 +209,7 @@ static void wavToSmpl_ReadWaveFile(const char *filename, uint8_t note)
 
         uint32_t data_to_read = wavHdr.nextTag.tag_data_size;
         bytesToRead -= wavHdr.nextTag.tag_data_size;
-        wavAdded = wavToSmpl_WavData(&wavHdr, wavHdr.bytesPerSample, data_to_read, note);
+        wavAdded = wavToSmpl_WavData(&wavHdr, wavHdr.bytesPerSample, data_to_read, note, &region);
     }
 
     if (bytesToRead > 0)
@@ -286,9 +250,11 @@ static void wavToSmpl_ReadWaveFile(const char *filename, uint8_t note)
             Serial.printf("    fraction: %" PRIu32 "\n", smpl_tag.fraction);
             Serial.printf("    number_of_times_to_play_the_loop: %" PRIu32 "\n", smpl_tag.number_of_times_to_play_the_loop);
 
-            Sampler_SetPitch(smpl_tag.MIDI_unity_note, wavHdr.sampleRate, 0);
-            Sampler_NewSampleSetLoop(smpl_tag.start, smpl_tag.end);
-            Sampler_SetLoopMode(1);
+            region.rootKey = smpl_tag.MIDI_unity_note;
+            region.tune = 0;
+            region.loopStart = smpl_tag.start;
+            region.loopEnd = smpl_tag.end;
+            region.loopMode = 1;
         }
     }
     else
@@ -298,10 +264,10 @@ static void wavToSmpl_ReadWaveFile(const char *filename, uint8_t note)
 
     if (wavAdded)
     {
-        Sampler_FinishSample();
+        SmplBank_ApplyRegion(&region);
         if (note == W2S_ALL_NOTES)
         {
-            Sampler_InstrumentDone();
+            SmplBank_InstrumentDone();
         }
     }
 
@@ -318,7 +284,7 @@ static void wavToSmpl_ReadWaveFile(const char *filename, uint8_t note)
 void WavToSmpl_FolderToNotes(fs_id_t id, const char *dirname, uint8_t start_note)
 {
     WavToKeyboard(id, dirname, wavToSmpl_FolderToNotes_CB, 0, 10, start_note);
-    Sampler_InstrumentDone();
+    SmplBank_InstrumentDone();
     Status_ValueChangedStr("Wav Files from Dir", "Loaded to notes", dirname);
 }
 
@@ -332,7 +298,9 @@ void WavToSmpl_FileToSingleNote(fs_id_t id, const char *filename, uint8_t note)
 {
     if (FS_OpenFile(id, filename))
     {
+        LoadStep_FileBegin(id, filename);
         wavToSmpl_ReadWaveFile(filename, note);
+        LoadStep_FileEnd();
         FS_CloseFile();
     }
 }
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2026 Marcel Licence
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+ * der GNU General Public License, wie von der Free Software Foundation,
+ * Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+ * veröffentlichten Version, weiter verteilen und/oder modifizieren.
+ *
+ * Dieses Programm wird in der Hoffnung bereitgestellt, dass es nützlich sein wird, jedoch
+ * OHNE JEDE GEWÄHR,; sogar ohne die implizite
+ * Gewähr der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+ * Siehe die GNU General Public License für weitere Einzelheiten.
+ *
+ * Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+ * Programm erhalten haben. Wenn nicht, siehe <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file xrun_mon.cpp
+ * @author Marcel Licence
+ * @date 17.10.2026
+ *
+ * @brief   Detection of late blocks and audio underruns
+ * @n       Audio_Output gives no feedback about the DMA, so the fill level is tracked using the timing of the loop:
+ * @n       A block which waited in Audio_Output found the DMA full, every block period above the budget takes time from it
+ * @n       When more time was taken than the buffered blocks can cover an underrun is counted
+ */
+
+
+#ifdef __CDT_PARSER__
+#include <cdt.h>
+#endif
+
+
+/*
+ * includes
+ */
+#include <Arduino.h>
+
+#include "config.h"
+#include "app.h"
+#include "perf_mon.h"
+#include "xrun_mon.h"
+
+
+/*
+ * defines
+ */
+#ifndef XRUN_DMA_BLOCKS
+#define XRUN_DMA_BLOCKS 2 /*!< blocks buffered by the audio output, depends on the audio driver */
+#endif
+#define XRUN_DMA_SAMPLES    (XRUN_DMA_BLOCKS * SAMPLE_BUFFER_SIZE) /*!< the output buffers do not follow the runtime block size */
+#define XRUN_LOG_SIZE   16
+
+
+/*
+ * data types
+ */
+enum xrun_type_e
+{
+    XRUN_TYPE_LATE, /*!< rendering took longer than the block duration */
+    XRUN_TYPE_UNDERRUN, /*!< the output ran dry */
+};
+
+struct xrun_log_entry_s
+{
+    uint32_t timestamp; /*!< ms since startup */
+    enum xrun_type_e type;
+    uint32_t render_us;
+    uint32_t period_us;
+    uint32_t voices;
+    uint32_t chainConfig;
+};
+
+
+/*
+ * static variables
+ */
+static struct xrun_log_entry_s xrunLog[XRUN_LOG_SIZE];
+static volatile uint32_t xrunLogIdx = 0; /*!< total number of entries written */
+static volatile uint32_t xrunLateCnt = 0;
+static volatile uint32_t xrunCnt = 0;
+static volatile bool xrunResetRequest = false;
+static uint32_t xrunDebt = 0; /*!< cycles the output is behind since it was full */
+static uint32_t xrunDmaCycles = 0; /*!< duration of XRUN_DMA_SAMPLES, set by the first call */
+
+
+/*
+ * static function declarations
+ */
+static void xrunMon_Log(enum xrun_type_e type, uint32_t render, uint32_t period, uint32_t voices, uint32_t chainConfig);
+
+
+/*
+ * static function definitions
+ */
+static void xrunMon_Log(enum xrun_type_e type, uint32_t render, uint32_t period, uint32_t voices, uint32_t chainConfig)
+{
+    struct xrun_log_entry_s *entry = &xrunLog[xrunLogIdx % XRUN_LOG_SIZE];
+
+    entry->timestamp = millis();
+    entry->type = type;
+    entry->render_us = PerfMon_CyclesToUs(render);
+    entry->period_us = PerfMon_CyclesToUs(period);
+    entry->voices = voices;
+    entry->chainConfig = chainConfig;
+
+    xrunLogIdx++;
+}
+
+
+/*
+ * extern function definitions
+ */
+
+/*
+ * to be called after Audio_Output, uses the timing recorded by perf_mon
+ */
+void XrunMon_Process(uint32_t voices, uint32_t chainConfig)
+{
+    if (xrunResetRequest)
+    {
+        xrunLateCnt = 0;
+        xrunCnt = 0;
+        xrunLogIdx = 0;
+        xrunDebt = 0;
+        xrunResetRequest = false;
+    }
+
+    if (xrunDmaCycles == 0)
+    {
+        xrunDmaCycles = (((uint64_t)PERF_CYCLES_PER_SECOND()) * XRUN_DMA_SAMPLES) / SAMPLE_RATE;
+    }
+
+    uint32_t budget = PerfMon_GetBudget();
+    uint32_t render = PerfMon_GetLastRender();
+    uint32_t period = PerfMon_GetLastPeriod();
+    uint32_t wait = PerfMon_GetLastStage(PERF_STAGE_OUTPUT);
+
+    if (render > budget)
+    {
+        xrunLateCnt++;
+        xrunMon_Log(XRUN_TYPE_LATE, render, period, voices, chainConfig);
+    }
+
+    /* blocks finished early catch up, blocks of different length are averaged this way */
+    int32_t delta = (int32_t)(period - budget);
+    xrunDebt = ((int32_t)xrunDebt + delta > 0) ? (xrunDebt + delta) : 0;
+
+    /* the budget follows the block size, the buffered samples do not */
+    if (xrunDebt > xrunDmaCycles)
+    {
+        xrunCnt++;
+        xrunMon_Log(XRUN_TYPE_UNDERRUN, render, period, voices, chainConfig);
+        /* the output restarts after running dry */
+        xrunDebt = 0;
+    }
+
+    if (wait > xrunDmaCycles / (8 * XRUN_DMA_BLOCKS))
+    {
+        /* the output was full (waited more than 1/8 of a buffer), all time has been caught up */
+        xrunDebt = 0;
+    }
+}
+
+uint32_t XrunMon_GetLateCount(void)
+{
+    return xrunLateCnt;
+}
+
+uint32_t XrunMon_GetXrunCount(void)
+{
+    return xrunCnt;
+}
+
+void XrunMon_Print(void)
+{
+    uint32_t logIdx = xrunLogIdx;
+    uint32_t first = (logIdx > XRUN_LOG_SIZE) ? (logIdx - XRUN_LOG_SIZE) : 0;
+
+    Serial.printf("late blocks: %" PRIu32 ", underruns: %" PRIu32 "\n", xrunLateCnt, xrunCnt);
+    Serial.printf("  %10s %-8s %9s %9s %5s %s\n", "time ms", "type", "render us", "period us", "voice", "chain");
+
+    for (uint32_t i = first; i < logIdx; i++)
+    {
+        const struct xrun_log_entry_s *entry = &xrunLog[i % XRUN_LOG_SIZE];
+        char chainStr[32];
+
+        App_ChainConfigToStr(entry->chainConfig, chainStr, sizeof(chainStr));
+        Serial.printf("  %10" PRIu32 " %-8s %9" PRIu32 " %9" PRIu32 " %5" PRIu32 " %s\n",
+                      entry->timestamp,
+                      (entry->type == XRUN_TYPE_LATE) ? "late" : "underrun",
+                      entry->render_us,
+                      entry->period_us,
+                      entry->voices,
+                      chainStr);
+    }
+}
+
+/*
+ * serial command: "xrun" prints the counters and the log, "xrun reset" clears them
+ */
+void XrunMon_Cmd(const char *args)
+{
+    if (strcmp(args, "reset") == 0)
+    {
+        xrunResetRequest = true;
+        Serial.printf("xrun: reset\n");
+    }
+    else
+    {
+        XrunMon_Print();
+    }
+}
@@ -49,6 +49,19 @@
 
 #include "config.h"
 #include "app.h"
+#include "perf_mon.h"
+#include "serial_cmd.h"
+#include "xrun_mon.h"
+#include "quality_gov.h"
+#include "voice_alloc.h"
+#include "dual_render.h"
+#include "midi_queue.h"
+#include "preset_cache.h"
+#include "sf2_index.h"
+#include "load_job.h"
+#include "hot_swap.h"
+#include "smpl_arena.h"
+#include "stream_voice.h"
 
 
 #include <ml_sampler.h>
@@ -92,87 +105,17 @@
  */
 struct midiControllerMapping edirolMapping[] =
 {
-    /* general MIDI */
-    { 0x0, 0x40, "sustain", NULL, NULL, 0},
-
-    /* transport buttons */
-#ifdef MIDI_STREAM_PLAYER_ENABLED
-    { 0x8, 0x52, "back", NULL, MidiStreamPlayerCtrl, MIDI_STREAM_PLAYER_CTRL_PAUSE},
-    { 0xD, 0x52, "stop", NULL, NULL, 0},
-    { 0xe, 0x52, "start", NULL, MidiStreamPlayerCtrl, MIDI_STREAM_PLAYER_CTRL_START},
-    { 0xa, 0x52, "rec", NULL, NULL, 0},
-#else
-    { 0x8, 0x52, "back", NULL, NULL, 0},
-    { 0xD, 0x52, "stop", NULL, NULL, 0},
-    { 0xe, 0x52, "start", NULL, Sampler_LoopEntireSample, 0},
-    { 0xa, 0x52, "rec", NULL, NULL, 0},
-#endif
-
-    /* upper row of buttons */
-    { 0x0, 0x50, "A1", NULL, AppBtn, 0},
-    { 0x1, 0x50, "A2", NULL, AppBtn, 1},
-    { 0x2, 0x50, "A3", NULL, AppBtn, 2},
-    { 0x3, 0x50, "A4", NULL, AppBtn, 3},
-
-    { 0x4, 0x50, "A5", NULL, AppBtn, 4},
-    { 0x5, 0x50, "A6", NULL, AppBtn, 5},
-    { 0x6, 0x50, "A7", NULL, AppBtn, 6},
-    { 0x7, 0x50, "A8", NULL, AppBtn, 7},
-
-    { 0x0, 0x53, "A9", NULL, AppBtn, 8},
-
-    /* lower row of buttons */
-    { 0x0, 0x51, "B1", NULL, AppBtnB, 0},
-    { 0x1, 0x51, "B2", NULL, AppBtnB, 1},
-    { 0x2, 0x51, "B3", NULL, AppBtnB, 2},
-    { 0x3, 0x51, "B4", NULL, AppBtnB, 3},
-
-    { 0x4, 0x51, "B5", NULL, AppBtnB, 4},
-    { 0x5, 0x51, "B6", NULL, AppBtnB, 5},
-    { 0x6, 0x51, "B7", NULL, AppBtnB, 6},
-    { 0x7, 0x51, "B8", NULL, AppBtnB, 7},
-
-    { 0x1, 0x53, "B9", NULL, AppBtnB, 8},
-
-    /* rotary */
-    { 0x0, 0x10, "R1", NULL, Sampler_TuneCoarse, 0},
-    //{ 0x1, 0x10, "R2", NULL, Sampler_TuneFine, 0},
-    { 0x1, 0x10, "R2", NULL, Sampler_ChangeParameterSample, SAMPLER_PARAM_RELEASE},
-    { 0x2, 0x10, "R3", NULL, AppSetInputGain, 0},
-
-#ifdef MAX_DELAY_Q
-    { 0x3, 0x10, "R4", NULL, DelayQ_SetOutputLevel, 3},
-    { 0x4, 0x10, "R5", NULL, DelayQ_SetFeedback, 4},
-    { 0x5, 0x10, "R6", NULL, App_DelayQ_SetLength, 5},
-#endif
-    { 0x6, 0x10, "R7", NULL, Sampler_ChangeParameter, SAMPLER_PARAM_HOLD},
-    { 0x7, 0x10, "R8", NULL, Sampler_ChangeParameter, SAMPLER_PARAM_RELEASE},
-#ifdef REVERB_ENABLED
-    { 0x0, 0x12, "R9", NULL, AppReverb_SetLevel, 0},
-#endif
-
-    /* slider */
-    { 0x0, 0x11, "S1", NULL, Phaser_SetDepth, 0},
-    { 0x1, 0x11, "S2", NULL, AppTremolo_SetDepth, 0},
-    { 0x2, 0x11, "S3", NULL, Phaser_SetG, 0},
-    { 0x3, 0x11, "S4", NULL, Lfo1_SetSpeed, 0},
-
-    { 0x4, 0x11, "S5", NULL, PitchShifter_SetSpeed, 0},
-    { 0x5, 0x11, "S6", NULL, PitchShifter_SetMix, 0},
-    { 0x6, 0x11, "S7", NULL, PitchShifter_SetFeedback, 0},
-    { 0x7, 0x11, "S8", NULL, AppVibrato_SetDepth, 0},
-
-    { 0x1, 0x12, "S9", NULL, AppVibrato_SetIntensity, 0},
+#include "midi_ctrl_table.h"
 };
 
 struct midiMapping_s midiMapping =
 {
     NULL,
-    Sampler_NoteOn,
-    Sampler_NoteOff,
-    Sampler_PitchBend, /* pitch bend */
+    App_NoteOn,
+    App_NoteOff,
+    App_PitchBend, /* pitch bend */
     NULL, /* modulation wheel */
-    Sampler_ProgramChange, /* program change */
+    App_ProgramChange, /* program change */
     NULL, /* real time message */
     NULL, /* song position */
     edirolMapping,
@@ -199,3 +142,18 @@ struct usbMidiMapping_s usbMidiMapping =
     sizeof(usbMidiMappingEntries) / sizeof(usbMidiMappingEntries[0]),
 };
 #endif /* MIDI_VIA_USB_ENABLED */
+
+/*
+ * commands of the serial console
+ * type the name of a command followed by enter, unknown commands will print this list
+ */
+struct serialCmd_s serialCmds[] =
+{
+#include "serial_cmd_table.h"
+};
+
+struct serialCmdMapping_s serialCmdMapping =
+{
+    serialCmds,
+    sizeof(serialCmds) / sizeof(serialCmds[0]),
+};